@@ -0,0 +1,875 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Headless drop-in for x11_app.c: implements the same chengGuiX11* surface
+   ABI (linux_host_abi.h; linux_host_native.c adds the chengGuiNative* entry
+   points) against an in-memory BGRA buffer so the full app can be driven and
+   timed without an X server.
+
+   Environment:
+     GUI_HEADLESS_SIZE        window size in pixels, "WxH" (default 1280x800)
+     GUI_HEADLESS_SCALE       backing scale factor (default 1)
+     GUI_HEADLESS_EVENTS      scripted input file, one event per line (below)
+     GUI_HEADLESS_FRAMES      emit Close after this many frames (default 0: off)
+     GUI_HEADLESS_IDLE_TICK   emit a no-op pointer move when no event is due so
+                              the app keeps rendering (default 1)
+     GUI_HEADLESS_TIMINGS     write per-frame timings as CSV to this path
+     GUI_HEADLESS_DUMP_DIR    dump presented frames as frame_NNNNNN.rgba.out
+     GUI_HEADLESS_DUMP_EVERY  dump every Nth frame (default 1 when DUMP_DIR set)
+     GUI_HEADLESS_DUMP_FORMAT rgba (default), png or ppm
+     GUI_HEADLESS_DUMP_REPEATS 1 also writes frames identical to the last dump
+                              (default 0: repeats are skipped)
+     GUI_HEADLESS_DUMP_BLOCK  1 waits for the writer instead of dropping frames
+                              while its pool is full (default 0)
+
+   Script lines are "<frame> <command> [args]"; the event is delivered by the
+   first poll after <frame> frames have ended. Blank lines and '#' comments are
+   ignored. Coordinates are logical.
+     <frame> move <x> <y> [mods]
+     <frame> down <x> <y> <button> [mods]
+     <frame> up <x> <y> <button> [mods]
+     <frame> scroll <dx> <dy> [mods]
+     <frame> key <keysym> [mods]        key-down followed by key-up
+     <frame> keydown <keysym> [mods]
+     <frame> keyup <keysym> [mods]
+     <frame> text <utf8 text to end of line>
+     <frame> resize <width> <height>     pixel size
+     <frame> close
+
+   The frame loop never blocks: poll timeouts are ignored so runs measure work,
+   not sleeps. The summary line is printed to stderr on shutdown. */
+
+#if defined(__GNUC__)
+#define HEADLESS_EXPORT __attribute__((visibility("default")))
+#else
+#define HEADLESS_EXPORT
+#endif
+
+#include "linux_host_abi.h"
+#include "../render/snapshot_writer.h"
+
+/* Aggregate frame timings over a headless run, in milliseconds. frameMs spans
+   BeginFrame..EndFrame; intervalMs spans EndFrame..EndFrame and so includes
+   event handling and layout done before BeginFrame. */
+typedef struct {
+  int64_t frames;
+  int64_t scriptedEvents;
+  double frameMeanMs;
+  double frameP50Ms;
+  double frameP95Ms;
+  double frameP99Ms;
+  double frameMaxMs;
+  double intervalMeanMs;
+  double intervalP95Ms;
+  double totalMs;
+} ChengGuiHeadlessStats;
+
+typedef struct {
+  int64_t frame;
+  int order;
+  ChengGuiX11Event event;
+} ChengGuiHeadlessScripted;
+
+typedef struct {
+  double frameMs;
+  double intervalMs;
+  double presentMs;
+  int64_t uploadBytes;
+  int32_t regionCount;
+} ChengGuiHeadlessFrame;
+
+typedef struct ChengGuiHeadlessSurface ChengGuiHeadlessSurface;
+
+typedef struct {
+  double logicalWidth;
+  double logicalHeight;
+  double pixelWidth;
+  double pixelHeight;
+  double scale;
+  double pointerX;
+  double pointerY;
+  bool needsResizeEvent;
+  bool closed;
+  ChengGuiHeadlessSurface *surface;
+} ChengGuiHeadlessWindow;
+
+struct ChengGuiHeadlessSurface {
+  ChengGuiHeadlessWindow *window;
+  uint32_t *pixels;
+  int width;
+  int height;
+  double frameStartMs;
+  bool inFrame;
+  bool presented;
+  ChengGuiX11PresentStats stats;
+};
+
+/* GUI_HEADLESS_* settings consulted per frame, read once by
+   chengGuiX11Initialize so polls and dumps never call getenv. */
+typedef struct {
+  char dumpDir[512];
+  long dumpEvery;
+  int dumpKind;
+  const char *dumpSuffix;
+  int dumpFlags;
+  long frameLimit;
+  bool idleTick;
+  char timingsPath[512];
+} ChengGuiHeadlessConfig;
+
+static const char *kChengGuiHeadlessColorSpace = "sRGB";
+
+static bool gChengGuiHeadlessInitialized = false;
+static ChengGuiHeadlessWindow *gChengGuiHeadlessWindow = NULL;
+static ChengGuiHeadlessScripted *gChengGuiHeadlessScript = NULL;
+static int gChengGuiHeadlessScriptCount = 0;
+static int gChengGuiHeadlessScriptCursor = 0;
+static ChengGuiHeadlessFrame *gChengGuiHeadlessFrames = NULL;
+static int64_t gChengGuiHeadlessFrameCount = 0;
+static int64_t gChengGuiHeadlessFrameCap = 0;
+static double gChengGuiHeadlessStartMs = 0.0;
+static double gChengGuiHeadlessLastEndMs = 0.0;
+static bool gChengGuiHeadlessDumped = false;
+static ChengGuiHeadlessConfig gChengGuiHeadlessConfig;
+static ChengGuiX11EventStats gChengGuiHeadlessEventStats;
+
+static double chengGuiHeadlessNowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static const char *chengGuiHeadlessEnv(const char *name) {
+  const char *value = getenv(name);
+  return (value != NULL && value[0] != '\0') ? value : NULL;
+}
+
+static long chengGuiHeadlessEnvLong(const char *name, long fallback) {
+  const char *value = chengGuiHeadlessEnv(name);
+  if (value == NULL) {
+    return fallback;
+  }
+  char *end = NULL;
+  long parsed = strtol(value, &end, 10);
+  return (end != value) ? parsed : fallback;
+}
+
+static ChengGuiX11Event chengGuiHeadlessMakeEvent(int kind) {
+  ChengGuiX11Event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.kind = kind;
+  ev.window = (void *)gChengGuiHeadlessWindow;
+  ev.button = -1;
+  return ev;
+}
+
+static void chengGuiHeadlessSetPixelSize(ChengGuiHeadlessWindow *window, double pixelWidth, double pixelHeight) {
+  if (pixelWidth < 1.0) pixelWidth = 1.0;
+  if (pixelHeight < 1.0) pixelHeight = 1.0;
+  window->pixelWidth = pixelWidth;
+  window->pixelHeight = pixelHeight;
+  window->logicalWidth = pixelWidth / window->scale;
+  window->logicalHeight = pixelHeight / window->scale;
+}
+
+static void chengGuiHeadlessPopulateResize(ChengGuiX11Event *event) {
+  ChengGuiHeadlessWindow *window = gChengGuiHeadlessWindow;
+  event->width = window->logicalWidth;
+  event->height = window->logicalHeight;
+  event->pixelWidth = window->pixelWidth;
+  event->pixelHeight = window->pixelHeight;
+  event->scale = window->scale;
+}
+
+static void chengGuiHeadlessAppendScripted(int64_t frame, const ChengGuiX11Event *event) {
+  ChengGuiHeadlessScripted *grown = (ChengGuiHeadlessScripted *)realloc(
+    gChengGuiHeadlessScript, sizeof(ChengGuiHeadlessScripted) * (size_t)(gChengGuiHeadlessScriptCount + 1));
+  if (grown == NULL) {
+    return;
+  }
+  gChengGuiHeadlessScript = grown;
+  gChengGuiHeadlessScript[gChengGuiHeadlessScriptCount].frame = frame;
+  gChengGuiHeadlessScript[gChengGuiHeadlessScriptCount].order = gChengGuiHeadlessScriptCount;
+  gChengGuiHeadlessScript[gChengGuiHeadlessScriptCount].event = *event;
+  gChengGuiHeadlessScriptCount++;
+}
+
+static bool chengGuiHeadlessParseLine(char *line, int lineNo) {
+  while (*line == ' ' || *line == '\t') line++;
+  size_t len = strlen(line);
+  while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+    line[--len] = '\0';
+  }
+  if (len == 0 || line[0] == '#') {
+    return true;
+  }
+  long long frame = 0;
+  char command[16];
+  int consumed = 0;
+  if (sscanf(line, "%lld %15s %n", &frame, command, &consumed) < 2 || frame < 0) {
+    fprintf(stderr, "[gui-headless] script line %d: expected '<frame> <command>'\n", lineNo);
+    return false;
+  }
+  const char *args = line + consumed;
+  double a = 0.0;
+  double b = 0.0;
+  int button = 0;
+  unsigned int mods = 0;
+  unsigned int keysym = 0;
+  ChengGuiX11Event event = chengGuiHeadlessMakeEvent(ChengGuiX11EventNone);
+  if (strcmp(command, "move") == 0 && sscanf(args, "%lf %lf %u", &a, &b, &mods) >= 2) {
+    event.kind = ChengGuiX11EventPointerMove;
+    event.x = a;
+    event.y = b;
+    event.modifiers = mods;
+  } else if ((strcmp(command, "down") == 0 || strcmp(command, "up") == 0) &&
+             sscanf(args, "%lf %lf %d %u", &a, &b, &button, &mods) >= 3) {
+    event.kind = command[0] == 'd' ? ChengGuiX11EventPointerDown : ChengGuiX11EventPointerUp;
+    event.x = a;
+    event.y = b;
+    event.button = button;
+    event.modifiers = mods;
+  } else if (strcmp(command, "scroll") == 0 && sscanf(args, "%lf %lf %u", &a, &b, &mods) >= 2) {
+    event.kind = ChengGuiX11EventPointerScroll;
+    event.deltaX = a;
+    event.deltaY = b;
+    event.modifiers = mods;
+  } else if ((strcmp(command, "key") == 0 || strcmp(command, "keydown") == 0 || strcmp(command, "keyup") == 0) &&
+             sscanf(args, "%i %u", (int *)&keysym, &mods) >= 1) {
+    event.kind = strcmp(command, "keyup") == 0 ? ChengGuiX11EventKeyUp : ChengGuiX11EventKeyDown;
+    event.keyCode = keysym;
+    event.modifiers = mods;
+    if (strcmp(command, "key") == 0) {
+      chengGuiHeadlessAppendScripted((int64_t)frame, &event);
+      event.kind = ChengGuiX11EventKeyUp;
+    }
+  } else if (strcmp(command, "text") == 0) {
+    event.kind = ChengGuiX11EventTextInput;
+    strncpy(event.text, args, sizeof(event.text) - 1);
+  } else if (strcmp(command, "resize") == 0 && sscanf(args, "%lf %lf", &a, &b) == 2 && a >= 1.0 && b >= 1.0) {
+    event.kind = ChengGuiX11EventResized;
+    event.pixelWidth = a;
+    event.pixelHeight = b;
+  } else if (strcmp(command, "close") == 0) {
+    event.kind = ChengGuiX11EventClose;
+  } else {
+    fprintf(stderr, "[gui-headless] script line %d: bad command '%s'\n", lineNo, command);
+    return false;
+  }
+  chengGuiHeadlessAppendScripted((int64_t)frame, &event);
+  return true;
+}
+
+static int chengGuiHeadlessCompareScripted(const void *lhs, const void *rhs) {
+  const ChengGuiHeadlessScripted *a = (const ChengGuiHeadlessScripted *)lhs;
+  const ChengGuiHeadlessScripted *b = (const ChengGuiHeadlessScripted *)rhs;
+  if (a->frame != b->frame) {
+    return a->frame < b->frame ? -1 : 1;
+  }
+  return a->order - b->order;
+}
+
+static void chengGuiHeadlessLoadConfig(void) {
+  ChengGuiHeadlessConfig *config = &gChengGuiHeadlessConfig;
+  memset(config, 0, sizeof(*config));
+  const char *dir = chengGuiHeadlessEnv("GUI_HEADLESS_DUMP_DIR");
+  snprintf(config->dumpDir, sizeof(config->dumpDir), "%s", dir != NULL ? dir : "");
+  config->dumpEvery = chengGuiHeadlessEnvLong("GUI_HEADLESS_DUMP_EVERY", 1);
+  const char *format = chengGuiHeadlessEnv("GUI_HEADLESS_DUMP_FORMAT");
+  config->dumpKind = ChengGuiSnapshotRgba;
+  config->dumpSuffix = "rgba.out";
+  if (format != NULL && strcmp(format, "png") == 0) {
+    config->dumpKind = ChengGuiSnapshotPng;
+    config->dumpSuffix = "png";
+  } else if (format != NULL && strcmp(format, "ppm") == 0) {
+    config->dumpKind = ChengGuiSnapshotPpm;
+    config->dumpSuffix = "ppm";
+  }
+  if (chengGuiHeadlessEnvLong("GUI_HEADLESS_DUMP_BLOCK", 0) != 0) {
+    config->dumpFlags |= ChengGuiSnapshotFlagBlock;
+  }
+  if (chengGuiHeadlessEnvLong("GUI_HEADLESS_DUMP_REPEATS", 0) != 0) {
+    config->dumpFlags |= ChengGuiSnapshotFlagForce;
+  }
+  config->frameLimit = chengGuiHeadlessEnvLong("GUI_HEADLESS_FRAMES", 0);
+  config->idleTick = chengGuiHeadlessEnvLong("GUI_HEADLESS_IDLE_TICK", 1) != 0;
+  const char *timings = chengGuiHeadlessEnv("GUI_HEADLESS_TIMINGS");
+  snprintf(config->timingsPath, sizeof(config->timingsPath), "%s", timings != NULL ? timings : "");
+}
+
+static void chengGuiHeadlessLoadScript(void) {
+  const char *path = chengGuiHeadlessEnv("GUI_HEADLESS_EVENTS");
+  if (path == NULL) {
+    return;
+  }
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "[gui-headless] cannot open script %s: %s\n", path, strerror(errno));
+    return;
+  }
+  char line[256];
+  int lineNo = 0;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    lineNo++;
+    chengGuiHeadlessParseLine(line, lineNo);
+  }
+  fclose(file);
+  /* Order by frame, keeping file order within a frame. */
+  if (gChengGuiHeadlessScriptCount > 1) {
+    qsort(gChengGuiHeadlessScript, (size_t)gChengGuiHeadlessScriptCount, sizeof(ChengGuiHeadlessScripted), chengGuiHeadlessCompareScripted);
+  }
+}
+
+static void chengGuiHeadlessRecordFrame(const ChengGuiHeadlessFrame *frame) {
+  if (gChengGuiHeadlessFrameCount >= gChengGuiHeadlessFrameCap) {
+    int64_t cap = gChengGuiHeadlessFrameCap > 0 ? gChengGuiHeadlessFrameCap * 2 : 1024;
+    ChengGuiHeadlessFrame *grown = (ChengGuiHeadlessFrame *)realloc(gChengGuiHeadlessFrames, sizeof(ChengGuiHeadlessFrame) * (size_t)cap);
+    if (grown == NULL) {
+      return;
+    }
+    gChengGuiHeadlessFrames = grown;
+    gChengGuiHeadlessFrameCap = cap;
+  }
+  gChengGuiHeadlessFrames[gChengGuiHeadlessFrameCount++] = *frame;
+}
+
+static int chengGuiHeadlessCompareDouble(const void *lhs, const void *rhs) {
+  double a = *(const double *)lhs;
+  double b = *(const double *)rhs;
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static double chengGuiHeadlessPercentile(const double *sorted, int64_t count, double pct) {
+  if (count <= 0) {
+    return 0.0;
+  }
+  int64_t index = (int64_t)(pct * (double)(count - 1) + 0.5);
+  if (index >= count) index = count - 1;
+  return sorted[index];
+}
+
+/* Dumps go through the snapshot writer (render/snapshot_writer.c): the frame
+   is copied into its pool here and converted and written on its thread, so
+   dumping every frame costs the loop one memcpy. While the pool is full the
+   frame is dropped and counted, so a slow disk never stalls the loop;
+   GUI_HEADLESS_DUMP_BLOCK=1 waits instead when every frame is needed. */
+static void chengGuiHeadlessDumpFrame(const ChengGuiHeadlessSurface *surface, int64_t frameIndex) {
+  const ChengGuiHeadlessConfig *config = &gChengGuiHeadlessConfig;
+  if (config->dumpDir[0] == '\0' || surface->pixels == NULL) {
+    return;
+  }
+  if (config->dumpEvery <= 0 || frameIndex % config->dumpEvery != 0) {
+    return;
+  }
+  char path[1024];
+  int pathLen = snprintf(path, sizeof(path), "%s/frame_%06lld.%s", config->dumpDir, (long long)frameIndex,
+                         config->dumpSuffix);
+  if (pathLen < 0 || (size_t)pathLen >= sizeof(path)) {
+    return;
+  }
+  /* Raw dumps are RGBA so scripts/convert_rgba_out_to_png.py reads them as-is. */
+  chengGuiSnapshotWriterSubmit(chengGuiSnapshotDefaultWriter(), surface->pixels, surface->width, surface->height,
+                               surface->width * 4, path, config->dumpKind, config->dumpFlags);
+  gChengGuiHeadlessDumped = true;
+}
+
+static bool chengGuiHeadlessEnsureBuffer(ChengGuiHeadlessSurface *surface) {
+  int width = (int)surface->window->pixelWidth;
+  int height = (int)surface->window->pixelHeight;
+  if (surface->pixels != NULL && surface->width == width && surface->height == height) {
+    return true;
+  }
+  uint32_t *pixels = (uint32_t *)calloc((size_t)width * (size_t)height, sizeof(uint32_t));
+  if (pixels == NULL) {
+    return false;
+  }
+  free(surface->pixels);
+  surface->pixels = pixels;
+  surface->width = width;
+  surface->height = height;
+  surface->stats.shmReallocs++;
+  return true;
+}
+
+HEADLESS_EXPORT int chengGuiHeadlessGetStats(ChengGuiHeadlessStats *stats) {
+  if (stats == NULL) {
+    return -1;
+  }
+  memset(stats, 0, sizeof(*stats));
+  int64_t count = gChengGuiHeadlessFrameCount;
+  stats->frames = count;
+  stats->scriptedEvents = gChengGuiHeadlessScriptCursor;
+  if (count <= 0) {
+    return 0;
+  }
+  double *frameMs = (double *)malloc(sizeof(double) * (size_t)count);
+  double *intervalMs = (double *)malloc(sizeof(double) * (size_t)count);
+  if (frameMs == NULL || intervalMs == NULL) {
+    free(frameMs);
+    free(intervalMs);
+    return -1;
+  }
+  double frameSum = 0.0;
+  double intervalSum = 0.0;
+  for (int64_t i = 0; i < count; i++) {
+    frameMs[i] = gChengGuiHeadlessFrames[i].frameMs;
+    intervalMs[i] = gChengGuiHeadlessFrames[i].intervalMs;
+    frameSum += frameMs[i];
+    intervalSum += intervalMs[i];
+  }
+  qsort(frameMs, (size_t)count, sizeof(double), chengGuiHeadlessCompareDouble);
+  qsort(intervalMs, (size_t)count, sizeof(double), chengGuiHeadlessCompareDouble);
+  stats->frameMeanMs = frameSum / (double)count;
+  stats->frameP50Ms = chengGuiHeadlessPercentile(frameMs, count, 0.50);
+  stats->frameP95Ms = chengGuiHeadlessPercentile(frameMs, count, 0.95);
+  stats->frameP99Ms = chengGuiHeadlessPercentile(frameMs, count, 0.99);
+  stats->frameMaxMs = frameMs[count - 1];
+  stats->intervalMeanMs = intervalSum / (double)count;
+  stats->intervalP95Ms = chengGuiHeadlessPercentile(intervalMs, count, 0.95);
+  stats->totalMs = gChengGuiHeadlessLastEndMs - gChengGuiHeadlessStartMs;
+  free(frameMs);
+  free(intervalMs);
+  return 0;
+}
+
+HEADLESS_EXPORT size_t chengGuiHeadlessStatsStructSize(void) {
+  return sizeof(ChengGuiHeadlessStats);
+}
+
+/* Last presented frame, BGRA, tightly packed; valid until the next present. */
+HEADLESS_EXPORT const uint32_t *chengGuiHeadlessFramePixels(int *width, int *height) {
+  ChengGuiHeadlessWindow *window = gChengGuiHeadlessWindow;
+  ChengGuiHeadlessSurface *surface = window != NULL ? window->surface : NULL;
+  if (width != NULL) *width = surface != NULL ? surface->width : 0;
+  if (height != NULL) *height = surface != NULL ? surface->height : 0;
+  return surface != NULL ? surface->pixels : NULL;
+}
+
+static void chengGuiHeadlessWriteTimings(void) {
+  const char *path = gChengGuiHeadlessConfig.timingsPath;
+  if (path[0] == '\0') {
+    return;
+  }
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "[gui-headless] cannot write timings %s: %s\n", path, strerror(errno));
+    return;
+  }
+  fprintf(file, "frame,frameMs,intervalMs,presentMs,uploadBytes,regions\n");
+  for (int64_t i = 0; i < gChengGuiHeadlessFrameCount; i++) {
+    const ChengGuiHeadlessFrame *frame = &gChengGuiHeadlessFrames[i];
+    fprintf(file, "%lld,%.4f,%.4f,%.4f,%lld,%d\n",
+            (long long)i,
+            frame->frameMs,
+            frame->intervalMs,
+            frame->presentMs,
+            (long long)frame->uploadBytes,
+            (int)frame->regionCount);
+  }
+  fclose(file);
+}
+
+HEADLESS_EXPORT int chengGuiX11GetEventStats(ChengGuiX11EventStats *stats) {
+  if (stats == NULL) {
+    return -1;
+  }
+  *stats = gChengGuiHeadlessEventStats;
+  return 0;
+}
+
+HEADLESS_EXPORT void chengGuiX11Initialize(void) {
+  if (gChengGuiHeadlessInitialized) {
+    return;
+  }
+  gChengGuiHeadlessInitialized = true;
+  gChengGuiHeadlessScriptCount = 0;
+  gChengGuiHeadlessScriptCursor = 0;
+  gChengGuiHeadlessFrameCount = 0;
+  memset(&gChengGuiHeadlessEventStats, 0, sizeof(gChengGuiHeadlessEventStats));
+  chengGuiHeadlessLoadConfig();
+  chengGuiHeadlessLoadScript();
+  gChengGuiHeadlessStartMs = chengGuiHeadlessNowMs();
+  gChengGuiHeadlessLastEndMs = gChengGuiHeadlessStartMs;
+}
+
+HEADLESS_EXPORT int chengGuiX11IsInitialized(void) {
+  return gChengGuiHeadlessInitialized ? 1 : 0;
+}
+
+HEADLESS_EXPORT void chengGuiX11Shutdown(void) {
+  if (!gChengGuiHeadlessInitialized) {
+    return;
+  }
+  ChengGuiHeadlessStats stats;
+  if (chengGuiHeadlessGetStats(&stats) == 0) {
+    fprintf(stderr,
+            "[gui-headless] frames=%lld events=%lld totalMs=%.3f frameMeanMs=%.4f p50=%.4f p95=%.4f p99=%.4f max=%.4f intervalMeanMs=%.4f intervalP95=%.4f\n",
+            (long long)stats.frames,
+            (long long)stats.scriptedEvents,
+            stats.totalMs,
+            stats.frameMeanMs,
+            stats.frameP50Ms,
+            stats.frameP95Ms,
+            stats.frameP99Ms,
+            stats.frameMaxMs,
+            stats.intervalMeanMs,
+            stats.intervalP95Ms);
+  }
+  chengGuiHeadlessWriteTimings();
+  if (gChengGuiHeadlessDumped) {
+    void *writer = chengGuiSnapshotDefaultWriter();
+    chengGuiSnapshotWriterFlush(writer);
+    ChengGuiSnapshotStats dump;
+    if (chengGuiSnapshotWriterStats(writer, &dump) == 0) {
+      fprintf(stderr,
+              "[gui-headless] dumps submitted=%lld written=%lld repeats=%lld dropped=%lld failed=%lld copyMs=%.3f waitMs=%.3f encodeMs=%.3f writeMs=%.3f bytes=%llu\n",
+              (long long)dump.submitted,
+              (long long)dump.written,
+              (long long)dump.skipped,
+              (long long)dump.dropped,
+              (long long)dump.failed,
+              (double)dump.copyNs / 1e6,
+              (double)dump.waitNs / 1e6,
+              (double)dump.encodeNs / 1e6,
+              (double)dump.writeNs / 1e6,
+              (unsigned long long)dump.bytesOut);
+    }
+    gChengGuiHeadlessDumped = false;
+  }
+  if (getenv("GUI_DEBUG") != NULL) {
+    chengGuiTextAtlasLogSummary("gui-headless");
+  }
+  if (gChengGuiHeadlessWindow != NULL) {
+    if (gChengGuiHeadlessWindow->surface != NULL) {
+      free(gChengGuiHeadlessWindow->surface->pixels);
+      free(gChengGuiHeadlessWindow->surface);
+    }
+    free(gChengGuiHeadlessWindow);
+    gChengGuiHeadlessWindow = NULL;
+  }
+  free(gChengGuiHeadlessScript);
+  gChengGuiHeadlessScript = NULL;
+  gChengGuiHeadlessScriptCount = 0;
+  free(gChengGuiHeadlessFrames);
+  gChengGuiHeadlessFrames = NULL;
+  gChengGuiHeadlessFrameCap = 0;
+  gChengGuiHeadlessInitialized = false;
+}
+
+HEADLESS_EXPORT void chengGuiX11WakeEventLoop(void) {
+  /* Polling never blocks, so there is nothing to interrupt. */
+}
+
+HEADLESS_EXPORT void *chengGuiX11CreateWindow(
+    const char *title,
+    double x,
+    double y,
+    double width,
+    double height,
+    bool resizable,
+    bool highDpi) {
+  (void)title;
+  (void)x;
+  (void)y;
+  (void)resizable;
+  (void)highDpi;
+  if (!gChengGuiHeadlessInitialized || gChengGuiHeadlessWindow != NULL) {
+    /* One window per run keeps scripted coordinates unambiguous. */
+    return NULL;
+  }
+  ChengGuiHeadlessWindow *window = (ChengGuiHeadlessWindow *)calloc(1, sizeof(ChengGuiHeadlessWindow));
+  if (window == NULL) {
+    return NULL;
+  }
+  double scale = 1.0;
+  const char *scaleEnv = chengGuiHeadlessEnv("GUI_HEADLESS_SCALE");
+  if (scaleEnv != NULL) {
+    scale = strtod(scaleEnv, NULL);
+  }
+  if (scale < 1.0) scale = 1.0;
+  if (scale > 4.0) scale = 4.0;
+  window->scale = scale;
+  double pixelWidth = width > 0.0 ? width : 800.0;
+  double pixelHeight = height > 0.0 ? height : 600.0;
+  const char *sizeEnv = chengGuiHeadlessEnv("GUI_HEADLESS_SIZE");
+  int envWidth = 0;
+  int envHeight = 0;
+  if (sizeEnv != NULL && sscanf(sizeEnv, "%dx%d", &envWidth, &envHeight) == 2 && envWidth > 0 && envHeight > 0) {
+    pixelWidth = (double)envWidth;
+    pixelHeight = (double)envHeight;
+  }
+  chengGuiHeadlessSetPixelSize(window, pixelWidth, pixelHeight);
+  window->pointerX = -1.0;
+  window->pointerY = -1.0;
+  window->needsResizeEvent = true;
+  gChengGuiHeadlessWindow = window;
+  return (void *)window;
+}
+
+HEADLESS_EXPORT void *chengGuiX11CreateDefaultWindow(const char *title) {
+  return chengGuiX11CreateWindow(title, 100.0, 100.0, 1280.0, 800.0, true, true);
+}
+
+HEADLESS_EXPORT void chengGuiX11DestroyWindow(void *handle) {
+  ChengGuiHeadlessWindow *window = (ChengGuiHeadlessWindow *)handle;
+  if (window == NULL || window != gChengGuiHeadlessWindow) {
+    return;
+  }
+  window->closed = true;
+}
+
+static bool chengGuiHeadlessPush(ChengGuiX11Event *events, int maxEvents, int *count, const ChengGuiX11Event *event) {
+  if (*count >= maxEvents) {
+    return false;
+  }
+  events[(*count)++] = *event;
+  return true;
+}
+
+HEADLESS_EXPORT int chengGuiX11PollEvents(ChengGuiX11Event *events, int maxEvents, int timeoutMs) {
+  (void)timeoutMs;
+  ChengGuiHeadlessWindow *window = gChengGuiHeadlessWindow;
+  if (events == NULL || maxEvents <= 0 || window == NULL || window->closed) {
+    return 0;
+  }
+  int produced = 0;
+  int raw = 0;
+  if (window->needsResizeEvent) {
+    ChengGuiX11Event event = chengGuiHeadlessMakeEvent(ChengGuiX11EventResized);
+    chengGuiHeadlessPopulateResize(&event);
+    chengGuiHeadlessPush(events, maxEvents, &produced, &event);
+    window->needsResizeEvent = false;
+    raw++;
+  }
+  while (gChengGuiHeadlessScriptCursor < gChengGuiHeadlessScriptCount && produced < maxEvents) {
+    ChengGuiHeadlessScripted *next = &gChengGuiHeadlessScript[gChengGuiHeadlessScriptCursor];
+    if (next->frame > gChengGuiHeadlessFrameCount) {
+      break;
+    }
+    ChengGuiX11Event event = next->event;
+    event.window = (void *)window;
+    switch (event.kind) {
+      case ChengGuiX11EventResized:
+        chengGuiHeadlessSetPixelSize(window, event.pixelWidth, event.pixelHeight);
+        chengGuiHeadlessPopulateResize(&event);
+        break;
+      case ChengGuiX11EventPointerMove:
+      case ChengGuiX11EventPointerDown:
+      case ChengGuiX11EventPointerUp:
+        if (window->pointerX >= 0.0) {
+          event.deltaX = event.x - window->pointerX;
+          event.deltaY = event.y - window->pointerY;
+        }
+        window->pointerX = event.x;
+        window->pointerY = event.y;
+        break;
+      case ChengGuiX11EventPointerScroll:
+        event.x = window->pointerX >= 0.0 ? window->pointerX : 0.0;
+        event.y = window->pointerY >= 0.0 ? window->pointerY : 0.0;
+        break;
+      default:
+        break;
+    }
+    chengGuiHeadlessPush(events, maxEvents, &produced, &event);
+    gChengGuiHeadlessScriptCursor++;
+    raw++;
+  }
+  long frameLimit = gChengGuiHeadlessConfig.frameLimit;
+  if (frameLimit > 0 && gChengGuiHeadlessFrameCount >= frameLimit && produced < maxEvents) {
+    ChengGuiX11Event event = chengGuiHeadlessMakeEvent(ChengGuiX11EventClose);
+    chengGuiHeadlessPush(events, maxEvents, &produced, &event);
+    window->closed = true;
+    raw++;
+  }
+  if (produced == 0 && gChengGuiHeadlessConfig.idleTick) {
+    /* The app renders in response to events; a zero-delta move at the last
+       pointer position keeps one frame per poll without changing UI state. */
+    ChengGuiX11Event event = chengGuiHeadlessMakeEvent(ChengGuiX11EventPointerMove);
+    event.x = window->pointerX >= 0.0 ? window->pointerX : 0.0;
+    event.y = window->pointerY >= 0.0 ? window->pointerY : 0.0;
+    chengGuiHeadlessPush(events, maxEvents, &produced, &event);
+  }
+  gChengGuiHeadlessEventStats.rawEvents = raw;
+  gChengGuiHeadlessEventStats.deliveredEvents = produced;
+  gChengGuiHeadlessEventStats.totalRawEvents += raw;
+  gChengGuiHeadlessEventStats.totalDeliveredEvents += produced;
+  return produced;
+}
+
+HEADLESS_EXPORT void *chengGuiX11CreateSurface(void *handle) {
+  ChengGuiHeadlessWindow *window = (ChengGuiHeadlessWindow *)handle;
+  if (window == NULL || window->surface != NULL) {
+    return NULL;
+  }
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)calloc(1, sizeof(ChengGuiHeadlessSurface));
+  if (surface == NULL) {
+    return NULL;
+  }
+  surface->window = window;
+  surface->stats.mode = ChengGuiX11PresentHeadless;
+  window->surface = surface;
+  return (void *)surface;
+}
+
+HEADLESS_EXPORT void chengGuiX11DestroySurface(void *handle) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL) {
+    return;
+  }
+  if (surface->window != NULL && surface->window->surface == surface) {
+    surface->window->surface = NULL;
+  }
+  free(surface->pixels);
+  free(surface);
+}
+
+HEADLESS_EXPORT int chengGuiX11GetSurfaceInfo(void *handle, ChengGuiX11SurfaceInfo *info) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL || surface->window == NULL || info == NULL) {
+    return -1;
+  }
+  ChengGuiHeadlessWindow *window = surface->window;
+  info->logicalWidth = window->logicalWidth;
+  info->logicalHeight = window->logicalHeight;
+  info->pixelWidth = window->pixelWidth;
+  info->pixelHeight = window->pixelHeight;
+  info->scale = window->scale;
+  info->colorSpace = kChengGuiHeadlessColorSpace;
+  return 0;
+}
+
+HEADLESS_EXPORT int chengGuiX11BeginFrame(void *handle) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL || surface->window == NULL) {
+    return -1;
+  }
+  surface->frameStartMs = chengGuiHeadlessNowMs();
+  surface->inFrame = true;
+  surface->presented = false;
+  return 0;
+}
+
+HEADLESS_EXPORT int chengGuiX11EndFrame(void *handle) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL || surface->window == NULL) {
+    return -1;
+  }
+  double now = chengGuiHeadlessNowMs();
+  ChengGuiHeadlessFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.frameMs = surface->inFrame ? now - surface->frameStartMs : 0.0;
+  frame.intervalMs = now - gChengGuiHeadlessLastEndMs;
+  if (surface->presented) {
+    frame.presentMs = surface->stats.presentMs;
+    frame.uploadBytes = surface->stats.uploadBytes;
+    frame.regionCount = surface->stats.regionCount;
+  }
+  int64_t frameIndex = gChengGuiHeadlessFrameCount;
+  chengGuiHeadlessRecordFrame(&frame);
+  if (surface->presented) {
+    chengGuiHeadlessDumpFrame(surface, frameIndex);
+  }
+  surface->inFrame = false;
+  gChengGuiHeadlessLastEndMs = chengGuiHeadlessNowMs();
+  return 0;
+}
+
+HEADLESS_EXPORT int chengGuiX11PresentPixelsRegions(void *handle,
+                                                    const uint32_t *pixels,
+                                                    int width,
+                                                    int height,
+                                                    int strideBytes,
+                                                    const ChengGuiX11Rect *rects,
+                                                    int rectCount) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL || pixels == NULL) {
+    return -1;
+  }
+  if (width <= 0 || height <= 0) {
+    return -2;
+  }
+  if (surface->window == NULL) {
+    return -3;
+  }
+  if (strideBytes <= 0) {
+    strideBytes = width * 4;
+  }
+  double start = chengGuiHeadlessNowMs();
+  bool realloced = surface->pixels == NULL ||
+                   surface->width != (int)surface->window->pixelWidth ||
+                   surface->height != (int)surface->window->pixelHeight;
+  if (!chengGuiHeadlessEnsureBuffer(surface)) {
+    return -5;
+  }
+  int copyW = width < surface->width ? width : surface->width;
+  int copyH = height < surface->height ? height : surface->height;
+  ChengGuiX11Rect full = { 0, 0, copyW, copyH };
+  bool fullFrame = rects == NULL || rectCount <= 0 || realloced;
+  if (fullFrame) {
+    rects = &full;
+    rectCount = 1;
+  }
+  int64_t uploadBytes = 0;
+  int regions = 0;
+  for (int i = 0; i < rectCount; i++) {
+    int x0 = rects[i].x < 0 ? 0 : rects[i].x;
+    int y0 = rects[i].y < 0 ? 0 : rects[i].y;
+    int x1 = rects[i].x + rects[i].width;
+    int y1 = rects[i].y + rects[i].height;
+    if (x1 > copyW) x1 = copyW;
+    if (y1 > copyH) y1 = copyH;
+    if (x1 <= x0 || y1 <= y0) {
+      continue;
+    }
+    size_t rowBytes = (size_t)(x1 - x0) * 4;
+    for (int y = y0; y < y1; y++) {
+      const uint8_t *src = (const uint8_t *)pixels + (size_t)y * (size_t)strideBytes + (size_t)x0 * 4;
+      memcpy(surface->pixels + (size_t)y * (size_t)surface->width + (size_t)x0, src, rowBytes);
+    }
+    uploadBytes += (int64_t)rowBytes * (int64_t)(y1 - y0);
+    regions++;
+  }
+  double end = chengGuiHeadlessNowMs();
+  surface->presented = true;
+  surface->stats.presentMs = end - start;
+  surface->stats.copyMs = end - start;
+  surface->stats.uploadBytes = uploadBytes;
+  surface->stats.regionCount = regions;
+  surface->stats.fullFrame = fullFrame ? 1 : 0;
+  surface->stats.frames++;
+  return 0;
+}
+
+HEADLESS_EXPORT int chengGuiX11PresentPixels(void *handle,
+                                             const uint32_t *pixels,
+                                             int width,
+                                             int height,
+                                             int strideBytes) {
+  return chengGuiX11PresentPixelsRegions(handle, pixels, width, height, strideBytes, NULL, 0);
+}
+
+/* There is no shared-memory image to render into; callers fall back to
+   presenting their own buffer. */
+HEADLESS_EXPORT void *chengGuiX11AcquirePresentBuffer(void *handle, int width, int height, int *strideBytes) {
+  (void)handle;
+  (void)width;
+  (void)height;
+  if (strideBytes != NULL) {
+    *strideBytes = 0;
+  }
+  return NULL;
+}
+
+HEADLESS_EXPORT int chengGuiX11GetPresentStats(void *handle, ChengGuiX11PresentStats *stats) {
+  ChengGuiHeadlessSurface *surface = (ChengGuiHeadlessSurface *)handle;
+  if (surface == NULL || stats == NULL) {
+    return -1;
+  }
+  *stats = surface->stats;
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* ABI shared by the Linux hosts, x11_app.c and headless_app.c. Exactly one of
+ * them is linked, together with linux_host_native.c, which maps the
+ * chengGuiNative* entry points onto the chengGuiX11* ones both hosts define.
+ * native_linux_impl_cheng.cheng mirrors these layouts and checks the struct
+ * sizes at startup. */
+#ifndef CHENG_GUI_LINUX_HOST_ABI_H
+#define CHENG_GUI_LINUX_HOST_ABI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define CHENG_GUI_HOST_EXPORT __attribute__((visibility("default")))
+#else
+#define CHENG_GUI_HOST_EXPORT
+#endif
+
+enum {
+  ChengGuiX11EventNone = 0,
+  ChengGuiX11EventClose = 1,
+  ChengGuiX11EventResized = 2,
+  ChengGuiX11EventMoved = 3,
+  ChengGuiX11EventKeyDown = 4,
+  ChengGuiX11EventKeyUp = 5,
+  ChengGuiX11EventTextInput = 6,
+  ChengGuiX11EventPointerDown = 7,
+  ChengGuiX11EventPointerUp = 8,
+  ChengGuiX11EventPointerMove = 9,
+  ChengGuiX11EventPointerScroll = 10
+};
+
+enum {
+  ChengGuiX11PresentNone = 0,
+  ChengGuiX11PresentPutImage = 1,
+  ChengGuiX11PresentShm = 2,
+  ChengGuiX11PresentHeadless = 3
+};
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+} ChengGuiX11Rect;
+
+typedef struct {
+  int mode;
+  int shmAvailable;
+  double presentMs;
+  double copyMs;
+  int64_t uploadBytes;
+  int64_t frames;
+  int64_t shmReallocs;
+  int32_t regionCount;
+  int32_t fullFrame;
+  int32_t frameRoundTrips;
+  int32_t skippedClears;
+  int64_t totalRoundTrips;
+} ChengGuiX11PresentStats;
+
+typedef struct {
+  int kind;
+  void *window;
+  double x;
+  double y;
+  double width;
+  double height;
+  double deltaX;
+  double deltaY;
+  double pixelWidth;
+  double pixelHeight;
+  double scale;
+  unsigned int modifiers;
+  int button;
+  unsigned int keyCode;
+  char text[64];
+} ChengGuiX11Event;
+
+/* Per-poll event pump counters: raw events read versus events delivered
+   after motion/resize coalescing and expose merging. */
+typedef struct {
+  int32_t rawEvents;
+  int32_t deliveredEvents;
+  int32_t coalescedMotion;
+  int32_t coalescedResize;
+  int32_t mergedExpose;
+  int32_t reserved;
+  int64_t totalRawEvents;
+  int64_t totalDeliveredEvents;
+} ChengGuiX11EventStats;
+
+typedef struct {
+  double logicalWidth;
+  double logicalHeight;
+  double pixelWidth;
+  double pixelHeight;
+  double scale;
+  const char *colorSpace;
+} ChengGuiX11SurfaceInfo;
+
+/* Host entry points, defined by x11_app.c or headless_app.c. */
+void chengGuiX11Initialize(void);
+int chengGuiX11IsInitialized(void);
+void chengGuiX11Shutdown(void);
+void chengGuiX11WakeEventLoop(void);
+void *chengGuiX11CreateWindow(const char *title, double x, double y, double width, double height, bool resizable, bool highDpi);
+void *chengGuiX11CreateDefaultWindow(const char *title);
+void chengGuiX11DestroyWindow(void *handle);
+int chengGuiX11PollEvents(ChengGuiX11Event *events, int maxEvents, int timeoutMs);
+int chengGuiX11GetEventStats(ChengGuiX11EventStats *stats);
+void *chengGuiX11CreateSurface(void *handle);
+void chengGuiX11DestroySurface(void *handle);
+int chengGuiX11GetSurfaceInfo(void *handle, ChengGuiX11SurfaceInfo *info);
+int chengGuiX11BeginFrame(void *handle);
+int chengGuiX11EndFrame(void *handle);
+int chengGuiX11PresentPixelsRegions(void *handle, const uint32_t *pixels, int width, int height, int strideBytes,
+                                    const ChengGuiX11Rect *rects, int rectCount);
+int chengGuiX11PresentPixels(void *handle, const uint32_t *pixels, int width, int height, int strideBytes);
+void *chengGuiX11AcquirePresentBuffer(void *handle, int width, int height, int *strideBytes);
+int chengGuiX11GetPresentStats(void *handle, ChengGuiX11PresentStats *stats);
+
+/* Text rendering lives in render/text_linux.c. */
+int chengGuiDrawTextBgra(void *pixels, int width, int height, int strideBytes, double x, double y, double w, double h, uint32_t color, double fontSize, const char *text);
+int chengGuiDrawTextBgraLen(void *pixels, int width, int height, int strideBytes, double x, double y, double w, double h, uint32_t color, double fontSize, const char *text, int textLen);
+int chengGuiLinuxDrawTextBgraCode(void *pixels, int width, int height, int strideBytes, double x, double y, double w, double h, uint32_t color, double fontSize, const char *text);
+int chengGuiLinuxDrawTextBgraIcon(void *pixels, int width, int height, int strideBytes, double x, double y, double w, double h, uint32_t color, double fontSize, const char *text);
+void chengGuiTextAtlasLogSummary(const char *tag);
+
+#endif
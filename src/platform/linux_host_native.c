@@ -0,0 +1,221 @@
+#include "linux_host_abi.h"
+
+/* chengGuiNative* entry points and struct size checks for the Linux hosts.
+   Both x11_app.c and headless_app.c implement the chengGuiX11* surface, so
+   this file is linked next to whichever of them the build picked. */
+
+CHENG_GUI_HOST_EXPORT size_t chengGuiX11EventStructSize(void) {
+  return sizeof(ChengGuiX11Event);
+}
+
+CHENG_GUI_HOST_EXPORT size_t chengGuiX11SurfaceInfoStructSize(void) {
+  return sizeof(ChengGuiX11SurfaceInfo);
+}
+
+CHENG_GUI_HOST_EXPORT size_t chengGuiX11PresentStatsStructSize(void) {
+  return sizeof(ChengGuiX11PresentStats);
+}
+
+CHENG_GUI_HOST_EXPORT size_t chengGuiX11EventStatsStructSize(void) {
+  return sizeof(ChengGuiX11EventStats);
+}
+
+CHENG_GUI_HOST_EXPORT void chengGuiNativeInitialize(void) {
+  chengGuiX11Initialize();
+}
+
+CHENG_GUI_HOST_EXPORT void chengGuiNativeShutdown(void) {
+  chengGuiX11Shutdown();
+}
+
+CHENG_GUI_HOST_EXPORT void *chengGuiNativeCreateDefaultWindow(const char *title) {
+  return chengGuiX11CreateDefaultWindow(title);
+}
+
+CHENG_GUI_HOST_EXPORT void chengGuiNativeDestroyWindow(void *handle) {
+  chengGuiX11DestroyWindow(handle);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativePollEvents(void *events, int maxEvents, int timeoutMs) {
+  return chengGuiX11PollEvents((ChengGuiX11Event *)events, maxEvents, timeoutMs);
+}
+
+CHENG_GUI_HOST_EXPORT void chengGuiNativeWakeEventLoop(void) {
+  chengGuiX11WakeEventLoop();
+}
+
+CHENG_GUI_HOST_EXPORT void *chengGuiNativeCreateSurface(void *windowHandle) {
+  return chengGuiX11CreateSurface(windowHandle);
+}
+
+CHENG_GUI_HOST_EXPORT void chengGuiNativeDestroySurface(void *surfaceHandle) {
+  chengGuiX11DestroySurface(surfaceHandle);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeBeginFrame(void *surfaceHandle) {
+  return chengGuiX11BeginFrame(surfaceHandle);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeEndFrame(void *surfaceHandle) {
+  return chengGuiX11EndFrame(surfaceHandle);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeGetSurfaceInfo(void *surfaceHandle, void *outInfo) {
+  return chengGuiX11GetSurfaceInfo(surfaceHandle, (ChengGuiX11SurfaceInfo *)outInfo);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativePresentPixels(
+  void *surfaceHandle,
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes
+) {
+  return chengGuiX11PresentPixels(surfaceHandle, pixels, width, height, strideBytes);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativePresentPixelsRegions(
+  void *surfaceHandle,
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  const void *rects,
+  int rectCount
+) {
+  return chengGuiX11PresentPixelsRegions(surfaceHandle, pixels, width, height, strideBytes, (const ChengGuiX11Rect *)rects, rectCount);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeGetPresentStats(void *surfaceHandle, void *outStats) {
+  return chengGuiX11GetPresentStats(surfaceHandle, (ChengGuiX11PresentStats *)outStats);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgra(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  double x,
+  double y,
+  double w,
+  double h,
+  uint32_t color,
+  double fontSize,
+  const char *text
+) {
+  return chengGuiDrawTextBgra(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgraLen(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  double x,
+  double y,
+  double w,
+  double h,
+  uint32_t color,
+  double fontSize,
+  const char *text,
+  int textLen
+) {
+  return chengGuiDrawTextBgraLen(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text, textLen);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgraLenI(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  int x,
+  int y,
+  int w,
+  int h,
+  uint32_t color,
+  int fontSizeX100,
+  const char *text,
+  int textLen
+) {
+  double fontSize = (double)fontSizeX100 / 100.0;
+  if (fontSize <= 1.0) {
+    fontSize = 14.0;
+  }
+  return chengGuiDrawTextBgraLen(
+    pixels,
+    width,
+    height,
+    strideBytes,
+    (double)x,
+    (double)y,
+    (double)w,
+    (double)h,
+    color,
+    fontSize,
+    text,
+    textLen
+  );
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgraCode(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  double x,
+  double y,
+  double w,
+  double h,
+  uint32_t color,
+  double fontSize,
+  const char *text
+) {
+  return chengGuiLinuxDrawTextBgraCode(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgraIcon(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  double x,
+  double y,
+  double w,
+  double h,
+  uint32_t color,
+  double fontSize,
+  const char *text
+) {
+  return chengGuiLinuxDrawTextBgraIcon(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text);
+}
+
+CHENG_GUI_HOST_EXPORT int chengGuiNativeDrawTextBgraFileIcon(
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  double x,
+  double y,
+  double w,
+  double h,
+  uint32_t color,
+  double fontSize,
+  const char *text
+) {
+  (void)pixels;
+  (void)width;
+  (void)height;
+  (void)strideBytes;
+  (void)x;
+  (void)y;
+  (void)w;
+  (void)h;
+  (void)color;
+  (void)fontSize;
+  (void)text;
+  return -1;
+}
+
+CHENG_GUI_HOST_EXPORT size_t chengGuiNativeEventStructSize(void) {
+  return chengGuiX11EventStructSize();
+}
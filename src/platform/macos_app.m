@@ -1828,6 +1828,22 @@ int chengGuiNativePresentPixels(
   return chengGuiMacPresentPixels(surfaceHandle, pixels, width, height, strideBytes);
 }
 
+/* This host always uploads whole frames; the damage list is accepted so the
+   editor can present through one entry point on every platform. */
+int chengGuiNativePresentPixelsRegions(
+  void *surfaceHandle,
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  const void *rects,
+  int rectCount
+) {
+  (void)rects;
+  (void)rectCount;
+  return chengGuiMacPresentPixels(surfaceHandle, pixels, width, height, strideBytes);
+}
+
 int chengGuiNativePresentPixelsPayload(void *surfaceHandle, const ChengGuiMacPresentPayload *payload) {
   return chengGuiMacPresentPixelsPayload(surfaceHandle, payload);
 }
@@ -1093,6 +1093,14 @@ __declspec(dllexport) int32_t chengGuiTextIndexAtX(const char *text, double font
   return 0;
 }
 
+__declspec(dllexport) int chengGuiTextByteAdvancesCode(const char *text, int textLen, double fontSize, double *outX) {
+  (void)text;
+  (void)textLen;
+  (void)fontSize;
+  (void)outX;
+  return -1;
+}
+
 __declspec(dllexport) int32_t chengGuiTextIndexAtXCode(const char *text, double fontSize, double x) {
   (void)text;
   (void)fontSize;
@@ -1150,6 +1158,22 @@ __declspec(dllexport) int chengGuiNativePresentPixels(
   return chengGuiWinPresentPixels(surfaceHandle, pixels, width, height, strideBytes);
 }
 
+/* This host always uploads whole frames; the damage list is accepted so the
+   editor can present through one entry point on every platform. */
+__declspec(dllexport) int chengGuiNativePresentPixelsRegions(
+  void *surfaceHandle,
+  void *pixels,
+  int width,
+  int height,
+  int strideBytes,
+  const void *rects,
+  int rectCount
+) {
+  (void)rects;
+  (void)rectCount;
+  return chengGuiWinPresentPixels(surfaceHandle, pixels, width, height, strideBytes);
+}
+
 __declspec(dllexport) int chengGuiNativeDrawTextBgra(
   void *pixels,
   int width,
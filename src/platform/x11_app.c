@@ -2,10 +2,18 @@
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
 #include <X11/keysym.h>
+#include <X11/extensions/XShm.h>
+#include <sys/eventfd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #if defined(__GNUC__)
@@ -14,19 +22,17 @@
 #define X11_EXPORT
 #endif
 
-enum {
-  ChengGuiX11EventNone = 0,
-  ChengGuiX11EventClose = 1,
-  ChengGuiX11EventResized = 2,
-  ChengGuiX11EventMoved = 3,
-  ChengGuiX11EventKeyDown = 4,
-  ChengGuiX11EventKeyUp = 5,
-  ChengGuiX11EventTextInput = 6,
-  ChengGuiX11EventPointerDown = 7,
-  ChengGuiX11EventPointerUp = 8,
-  ChengGuiX11EventPointerMove = 9,
-  ChengGuiX11EventPointerScroll = 10
-};
+#include "linux_host_abi.h"
+
+/* Horizontal wheel buttons are not named by Xlib. */
+#ifndef Button6
+#define Button6 6
+#endif
+#ifndef Button7
+#define Button7 7
+#endif
+
+#define CHENG_GUI_X11_MAX_DAMAGE_RECTS 32
 
 typedef struct ChengGuiX11Window ChengGuiX11Window;
 typedef struct ChengGuiX11Surface ChengGuiX11Surface;
@@ -46,45 +52,66 @@ struct ChengGuiX11Window {
   bool highDpi;
   bool resizable;
   bool destroyed;
+  bool needsFullPresent;
+  bool hasExpose;
+  ChengGuiX11Rect exposeRect;
+  ChengGuiX11Surface *surface;
   ChengGuiX11Window *next;
 };
 
 struct ChengGuiX11Surface {
   ChengGuiX11Window *window;
   GC gc;
+  Visual *visual;
+  int depth;
+  bool shmEnabled;
+  bool shmPending;
+  XShmSegmentInfo shmInfo;
+  XImage *shmImage;
+  int shmWidth;
+  int shmHeight;
+  /* The SHM image holds the whole last presented frame, so exposed areas can
+     be repainted from it without the app. */
+  bool shmRetained;
+  bool clearPending;
+  int64_t frameRoundTripBase;
+  ChengGuiX11PresentStats stats;
 };
 
-typedef struct {
-  int kind;
-  void *window;
-  double x;
-  double y;
-  double width;
-  double height;
-  double deltaX;
-  double deltaY;
-  double pixelWidth;
-  double pixelHeight;
-  double scale;
-  unsigned int modifiers;
-  int button;
-  unsigned int keyCode;
-  char text[64];
-} ChengGuiX11Event;
-
-typedef struct {
-  double logicalWidth;
-  double logicalHeight;
-  double pixelWidth;
-  double pixelHeight;
-  double scale;
-  const char *colorSpace;
-} ChengGuiX11SurfaceInfo;
-
 static Display *gChengGuiX11Display = NULL;
 static int gChengGuiX11Screen = 0;
 static ChengGuiX11Window *gChengGuiX11Windows = NULL;
 static const char *kChengGuiX11ColorSpace = "sRGB";
+static int gChengGuiX11ShmCompletionType = -1;
+static bool gChengGuiX11ShmAttachFailed = false;
+static int gChengGuiX11WakeFd = -1;
+static ChengGuiX11EventStats gChengGuiX11EventStats;
+/* DPI is derived from the screen geometry Xlib caches at connect time, so it
+   is computed once and refreshed from ConfigureNotify instead of per frame. */
+static double gChengGuiX11Dpi = 96.0;
+/* Requests that block on a server reply (XGetWindowAttributes, XSync, waiting
+   on a ShmCompletion). Steady-state frames are expected to add none. */
+static int64_t gChengGuiX11RoundTrips = 0;
+
+static double chengGuiX11NowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static bool chengGuiX11EnvFlag(const char *name, bool defaultValue) {
+  const char *raw = getenv(name);
+  if (raw == NULL || raw[0] == '\0') {
+    return defaultValue;
+  }
+  if (raw[0] == '1' || raw[0] == 't' || raw[0] == 'T' || raw[0] == 'y' || raw[0] == 'Y') {
+    return true;
+  }
+  if (raw[0] == '0' || raw[0] == 'f' || raw[0] == 'F' || raw[0] == 'n' || raw[0] == 'N') {
+    return false;
+  }
+  return defaultValue;
+}
 
 static double chengGuiX11ClampScale(double scale) {
   if (scale < 0.25) {
@@ -222,10 +249,52 @@ static ChengGuiX11Window *chengGuiX11FindWindow(Window window) {
   return NULL;
 }
 
+static bool chengGuiX11RectsTouch(const ChengGuiX11Rect *a, const ChengGuiX11Rect *b) {
+  return a->x <= b->x + b->width && b->x <= a->x + a->width &&
+         a->y <= b->y + b->height && b->y <= a->y + a->height;
+}
+
+static void chengGuiX11UnionRect(ChengGuiX11Rect *into, const ChengGuiX11Rect *other) {
+  int x0 = into->x < other->x ? into->x : other->x;
+  int y0 = into->y < other->y ? into->y : other->y;
+  int x1 = into->x + into->width > other->x + other->width ? into->x + into->width : other->x + other->width;
+  int y1 = into->y + into->height > other->y + other->height ? into->y + into->height : other->y + other->height;
+  into->x = x0;
+  into->y = y0;
+  into->width = x1 - x0;
+  into->height = y1 - y0;
+}
+
 static void chengGuiX11PushEvent(ChengGuiX11Event *events, int maxEvents, int *count, const ChengGuiX11Event *event) {
   if (events == NULL || event == NULL || count == NULL) {
     return;
   }
+  /* A motion directly following another motion of the same window only moves
+     the pointer further, so fold it into the queued one and keep the deltas. */
+  if (event->kind == ChengGuiX11EventPointerMove && *count > 0) {
+    ChengGuiX11Event *last = &events[*count - 1];
+    if (last->kind == ChengGuiX11EventPointerMove && last->window == event->window && last->modifiers == event->modifiers) {
+      last->x = event->x;
+      last->y = event->y;
+      last->deltaX += event->deltaX;
+      last->deltaY += event->deltaY;
+      gChengGuiX11EventStats.coalescedMotion++;
+      return;
+    }
+  }
+  /* Only the final geometry of a resize burst matters. The queued resize is
+     dropped and the new one appended, so it lands after every event that
+     arrived at the old geometry. */
+  if (event->kind == ChengGuiX11EventResized) {
+    for (int i = *count - 1; i >= 0; i--) {
+      if (events[i].kind == ChengGuiX11EventResized && events[i].window == event->window) {
+        memmove(&events[i], &events[i + 1], sizeof(ChengGuiX11Event) * (size_t)(*count - i - 1));
+        events[*count - 1] = *event;
+        gChengGuiX11EventStats.coalescedResize++;
+        return;
+      }
+    }
+  }
   if (*count >= maxEvents) {
     return;
   }
@@ -261,7 +330,11 @@ static void chengGuiX11HandleConfigureEvent(XConfigureEvent *configureEvent, Che
   if (window == NULL) {
     return;
   }
-  window->dpi = chengGuiX11ComputeDpi(gChengGuiX11Display, gChengGuiX11Screen);
+  if ((double)configureEvent->width != window->pixelWidth || (double)configureEvent->height != window->pixelHeight) {
+    window->needsFullPresent = true;
+  }
+  gChengGuiX11Dpi = chengGuiX11ComputeDpi(gChengGuiX11Display, gChengGuiX11Screen);
+  window->dpi = gChengGuiX11Dpi;
   chengGuiX11UpdateLogicalSize(window, (unsigned int)configureEvent->width, (unsigned int)configureEvent->height);
   ChengGuiX11Event event = chengGuiX11MakeEvent(window, ChengGuiX11EventResized);
   chengGuiX11PopulateResizeEvent(window, &event);
@@ -377,6 +450,24 @@ static void chengGuiX11HandleMotionEvent(XMotionEvent *motionEvent, ChengGuiX11E
   chengGuiX11EmitPointerEvent(window, ChengGuiX11EventPointerMove, logicalX, logicalY, deltaX, deltaY, motionEvent->state, -1, events, maxEvents, count);
 }
 
+static void chengGuiX11HandleExposeEvent(XExposeEvent *exposeEvent) {
+  if (exposeEvent == NULL) {
+    return;
+  }
+  ChengGuiX11Window *window = chengGuiX11FindWindow(exposeEvent->window);
+  if (window == NULL || exposeEvent->width <= 0 || exposeEvent->height <= 0) {
+    return;
+  }
+  ChengGuiX11Rect rect = { exposeEvent->x, exposeEvent->y, exposeEvent->width, exposeEvent->height };
+  if (window->hasExpose) {
+    chengGuiX11UnionRect(&window->exposeRect, &rect);
+    gChengGuiX11EventStats.mergedExpose++;
+  } else {
+    window->exposeRect = rect;
+    window->hasExpose = true;
+  }
+}
+
 static void chengGuiX11HandleLeaveEvent(XCrossingEvent *crossingEvent) {
   if (crossingEvent == NULL) {
     return;
@@ -388,25 +479,329 @@ static void chengGuiX11HandleLeaveEvent(XCrossingEvent *crossingEvent) {
   chengGuiX11ResetPointer(window);
 }
 
+static int chengGuiX11ShmErrorHandler(Display *display, XErrorEvent *error) {
+  (void)display;
+  (void)error;
+  gChengGuiX11ShmAttachFailed = true;
+  return 0;
+}
+
+static Bool chengGuiX11IsShmCompletion(Display *display, XEvent *event, XPointer arg) {
+  (void)display;
+  ChengGuiX11Surface *surface = (ChengGuiX11Surface *)arg;
+  if (event == NULL || surface == NULL || surface->window == NULL) {
+    return False;
+  }
+  if (event->type != gChengGuiX11ShmCompletionType) {
+    return False;
+  }
+  XShmCompletionEvent *completion = (XShmCompletionEvent *)event;
+  return completion->drawable == surface->window->window ? True : False;
+}
+
+static void chengGuiX11WaitShmCompletion(ChengGuiX11Surface *surface) {
+  if (surface == NULL || !surface->shmPending) {
+    return;
+  }
+  ChengGuiX11Window *window = surface->window;
+  if (window == NULL || window->display == NULL || window->destroyed) {
+    surface->shmPending = false;
+    return;
+  }
+  XEvent event;
+  if (!XCheckIfEvent(window->display, &event, chengGuiX11IsShmCompletion, (XPointer)surface)) {
+    gChengGuiX11RoundTrips++;
+    XIfEvent(window->display, &event, chengGuiX11IsShmCompletion, (XPointer)surface);
+  }
+  surface->shmPending = false;
+}
+
+static void chengGuiX11HandleShmCompletion(XEvent *event) {
+  if (event == NULL) {
+    return;
+  }
+  XShmCompletionEvent *completion = (XShmCompletionEvent *)event;
+  ChengGuiX11Window *window = chengGuiX11FindWindow(completion->drawable);
+  if (window == NULL || window->surface == NULL) {
+    return;
+  }
+  window->surface->shmPending = false;
+}
+
+static void chengGuiX11ReleaseShmImage(ChengGuiX11Surface *surface) {
+  if (surface == NULL || surface->shmImage == NULL) {
+    return;
+  }
+  chengGuiX11WaitShmCompletion(surface);
+  if (surface->window != NULL && surface->window->display != NULL) {
+    XShmDetach(surface->window->display, &surface->shmInfo);
+  }
+  surface->shmImage->data = NULL;
+  XDestroyImage(surface->shmImage);
+  if (surface->shmInfo.shmaddr != NULL && surface->shmInfo.shmaddr != (char *)-1) {
+    shmdt(surface->shmInfo.shmaddr);
+  }
+  memset(&surface->shmInfo, 0, sizeof(surface->shmInfo));
+  surface->shmImage = NULL;
+  surface->shmWidth = 0;
+  surface->shmHeight = 0;
+  surface->shmRetained = false;
+}
+
+static void chengGuiX11DisableShm(ChengGuiX11Surface *surface) {
+  if (surface == NULL) {
+    return;
+  }
+  surface->shmEnabled = false;
+  surface->shmPending = false;
+  memset(&surface->shmInfo, 0, sizeof(surface->shmInfo));
+}
+
+/* Shared-memory images are kept across frames and only rebuilt when the
+   presented size changes; any failure permanently falls back to XPutImage. */
+static bool chengGuiX11EnsureShmImage(ChengGuiX11Surface *surface, int width, int height) {
+  if (surface == NULL || !surface->shmEnabled) {
+    return false;
+  }
+  if (surface->shmImage != NULL && surface->shmWidth == width && surface->shmHeight == height) {
+    return true;
+  }
+  chengGuiX11ReleaseShmImage(surface);
+  Display *display = surface->window->display;
+  XImage *image = XShmCreateImage(display,
+                                  surface->visual,
+                                  (unsigned int)surface->depth,
+                                  ZPixmap,
+                                  NULL,
+                                  &surface->shmInfo,
+                                  (unsigned int)width,
+                                  (unsigned int)height);
+  if (image == NULL) {
+    chengGuiX11DisableShm(surface);
+    return false;
+  }
+  if (image->bits_per_pixel != 32) {
+    XDestroyImage(image);
+    chengGuiX11DisableShm(surface);
+    return false;
+  }
+  size_t totalBytes = (size_t)image->bytes_per_line * (size_t)image->height;
+  int shmId = shmget(IPC_PRIVATE, totalBytes, IPC_CREAT | 0600);
+  if (shmId < 0) {
+    XDestroyImage(image);
+    chengGuiX11DisableShm(surface);
+    return false;
+  }
+  char *addr = (char *)shmat(shmId, NULL, 0);
+  if (addr == (char *)-1) {
+    shmctl(shmId, IPC_RMID, NULL);
+    XDestroyImage(image);
+    chengGuiX11DisableShm(surface);
+    return false;
+  }
+  surface->shmInfo.shmid = shmId;
+  surface->shmInfo.shmaddr = addr;
+  surface->shmInfo.readOnly = False;
+  image->data = addr;
+  gChengGuiX11ShmAttachFailed = false;
+  XErrorHandler previous = XSetErrorHandler(chengGuiX11ShmErrorHandler);
+  Status attached = XShmAttach(display, &surface->shmInfo);
+  XSync(display, False);
+  gChengGuiX11RoundTrips++;
+  XSetErrorHandler(previous);
+  shmctl(shmId, IPC_RMID, NULL);
+  if (!attached || gChengGuiX11ShmAttachFailed) {
+    shmdt(addr);
+    image->data = NULL;
+    XDestroyImage(image);
+    chengGuiX11DisableShm(surface);
+    return false;
+  }
+  surface->shmImage = image;
+  surface->shmWidth = width;
+  surface->shmHeight = height;
+  surface->stats.shmReallocs++;
+  return true;
+}
+
+static void chengGuiX11CopyRect(char *dst, int dstStride, const char *src, int srcStride, const ChengGuiX11Rect *rect) {
+  if (dst == src || rect == NULL) {
+    return;
+  }
+  size_t rowBytes = (size_t)rect->width * 4u;
+  size_t offsetX = (size_t)rect->x * 4u;
+  if (rect->x == 0 && dstStride == srcStride && (size_t)dstStride == rowBytes) {
+    memcpy(dst + (size_t)rect->y * (size_t)dstStride, src + (size_t)rect->y * (size_t)srcStride, rowBytes * (size_t)rect->height);
+    return;
+  }
+  for (int y = rect->y; y < rect->y + rect->height; y++) {
+    memcpy(dst + (size_t)y * (size_t)dstStride + offsetX, src + (size_t)y * (size_t)srcStride + offsetX, rowBytes);
+  }
+}
+
+/* Clamps the damage list to the frame, merges touching rectangles and
+   degrades to one full-frame rectangle once the dirty area is large enough
+   that per-rect requests stop paying off. Returns the rectangle count. */
+static int chengGuiX11NormalizeDamage(const ChengGuiX11Rect *input, int inputCount, int width, int height, ChengGuiX11Rect *out) {
+  int count = 0;
+  bool collapsed = false;
+  for (int i = 0; input != NULL && i < inputCount; i++) {
+    int x0 = input[i].x < 0 ? 0 : input[i].x;
+    int y0 = input[i].y < 0 ? 0 : input[i].y;
+    int x1 = input[i].x + input[i].width;
+    int y1 = input[i].y + input[i].height;
+    if (x1 > width) x1 = width;
+    if (y1 > height) y1 = height;
+    if (x1 <= x0 || y1 <= y0) {
+      continue;
+    }
+    ChengGuiX11Rect rect = { x0, y0, x1 - x0, y1 - y0 };
+    if (count >= CHENG_GUI_X11_MAX_DAMAGE_RECTS) {
+      chengGuiX11UnionRect(&out[0], &rect);
+      collapsed = true;
+      continue;
+    }
+    out[count++] = rect;
+  }
+  if (collapsed) {
+    for (int i = 1; i < count; i++) {
+      chengGuiX11UnionRect(&out[0], &out[i]);
+    }
+    count = 1;
+  }
+  bool merged = true;
+  while (merged && count > 1) {
+    merged = false;
+    for (int i = 0; i < count && !merged; i++) {
+      for (int j = i + 1; j < count; j++) {
+        if (chengGuiX11RectsTouch(&out[i], &out[j])) {
+          chengGuiX11UnionRect(&out[i], &out[j]);
+          out[j] = out[count - 1];
+          count--;
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+  int64_t dirtyArea = 0;
+  for (int i = 0; i < count; i++) {
+    dirtyArea += (int64_t)out[i].width * (int64_t)out[i].height;
+  }
+  if (count > 0 && dirtyArea * 2 >= (int64_t)width * (int64_t)height) {
+    ChengGuiX11Rect full = { 0, 0, width, height };
+    out[0] = full;
+    count = 1;
+  }
+  return count;
+}
+
+static void chengGuiX11DrainWakeFd(void) {
+  if (gChengGuiX11WakeFd < 0) {
+    return;
+  }
+  uint64_t value = 0;
+  while (read(gChengGuiX11WakeFd, &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+  }
+}
+
+/* Blocks until the X connection becomes readable, another thread signals the
+   wake fd, or the timeout expires. */
+static void chengGuiX11WaitForInput(bool watchDisplay, int timeoutMs) {
+  struct pollfd fds[2];
+  int count = 0;
+  int wakeIndex = -1;
+  if (watchDisplay && gChengGuiX11Display != NULL) {
+    fds[count].fd = ConnectionNumber(gChengGuiX11Display);
+    fds[count].events = POLLIN;
+    fds[count].revents = 0;
+    count++;
+  }
+  if (gChengGuiX11WakeFd >= 0) {
+    wakeIndex = count;
+    fds[count].fd = gChengGuiX11WakeFd;
+    fds[count].events = POLLIN;
+    fds[count].revents = 0;
+    count++;
+  }
+  if (count == 0) {
+    usleep((useconds_t)timeoutMs * 1000U);
+    return;
+  }
+  int rc = poll(fds, (nfds_t)count, timeoutMs);
+  if (rc < 0 && errno != EINTR) {
+    usleep((useconds_t)timeoutMs * 1000U);
+    return;
+  }
+  if (rc > 0 && wakeIndex >= 0 && (fds[wakeIndex].revents & POLLIN) != 0) {
+    chengGuiX11DrainWakeFd();
+  }
+}
+
+/* An Expose means the server dropped window contents that the app may have
+   no new damage for, so it must be presented even on an idle frame. The
+   exposed area is put straight from the retained SHM frame; without one the
+   next present is made full and a resize at the current geometry wakes the
+   app to send it. */
+static void chengGuiX11PresentExposed(ChengGuiX11Window *window, ChengGuiX11Event *events, int maxEvents, int *count) {
+  ChengGuiX11Surface *surface = window->surface;
+  if (surface != NULL && surface->shmRetained && surface->shmImage != NULL && !window->needsFullPresent) {
+    ChengGuiX11Rect rect = window->exposeRect;
+    int x1 = rect.x + rect.width < surface->shmWidth ? rect.x + rect.width : surface->shmWidth;
+    int y1 = rect.y + rect.height < surface->shmHeight ? rect.y + rect.height : surface->shmHeight;
+    if (rect.x < 0) rect.x = 0;
+    if (rect.y < 0) rect.y = 0;
+    if (x1 > rect.x && y1 > rect.y) {
+      XShmPutImage(window->display,
+                   window->window,
+                   surface->gc,
+                   surface->shmImage,
+                   rect.x,
+                   rect.y,
+                   rect.x,
+                   rect.y,
+                   (unsigned int)(x1 - rect.x),
+                   (unsigned int)(y1 - rect.y),
+                   False);
+      XFlush(window->display);
+    }
+    window->hasExpose = false;
+    return;
+  }
+  window->needsFullPresent = true;
+  window->hasExpose = false;
+  ChengGuiX11Event event = chengGuiX11MakeEvent(window, ChengGuiX11EventResized);
+  chengGuiX11PopulateResizeEvent(window, &event);
+  chengGuiX11PushEvent(events, maxEvents, count, &event);
+}
+
 static int chengGuiX11PollEventLoop(ChengGuiX11Event *events, int maxEvents, int timeoutMs) {
   if (gChengGuiX11Display == NULL || events == NULL || maxEvents <= 0) {
     if (timeoutMs > 0) {
-      usleep((useconds_t)timeoutMs * 1000U);
+      chengGuiX11WaitForInput(false, timeoutMs);
     }
     return 0;
   }
   int produced = 0;
+  int raw = 0;
+  gChengGuiX11EventStats.coalescedMotion = 0;
+  gChengGuiX11EventStats.coalescedResize = 0;
+  gChengGuiX11EventStats.mergedExpose = 0;
   int pending = XPending(gChengGuiX11Display);
+  if (pending == 0 && timeoutMs > 0) {
+    chengGuiX11WaitForInput(true, timeoutMs);
+    pending = XPending(gChengGuiX11Display);
+  }
   if (pending == 0) {
-    if (timeoutMs > 0) {
-      usleep((useconds_t)timeoutMs * 1000U);
-    }
+    gChengGuiX11EventStats.rawEvents = 0;
+    gChengGuiX11EventStats.deliveredEvents = 0;
     return 0;
   }
   while (pending-- > 0 && produced < maxEvents) {
     XEvent event;
     memset(&event, 0, sizeof(event));
     XNextEvent(gChengGuiX11Display, &event);
+    raw++;
     switch (event.type) {
       case ClientMessage:
         chengGuiX11HandleClientMessage(&event.xclient, events, maxEvents, &produced);
@@ -432,16 +827,39 @@ static int chengGuiX11PollEventLoop(ChengGuiX11Event *events, int maxEvents, int
       case LeaveNotify:
         chengGuiX11HandleLeaveEvent(&event.xcrossing);
         break;
+      case Expose:
+        chengGuiX11HandleExposeEvent(&event.xexpose);
+        break;
       default:
+        if (event.type == gChengGuiX11ShmCompletionType) {
+          chengGuiX11HandleShmCompletion(&event);
+        }
         break;
     }
     if (produced >= maxEvents) {
       break;
     }
   }
+  for (ChengGuiX11Window *window = gChengGuiX11Windows; window != NULL; window = window->next) {
+    if (window->hasExpose && !window->destroyed) {
+      chengGuiX11PresentExposed(window, events, maxEvents, &produced);
+    }
+  }
+  gChengGuiX11EventStats.rawEvents = raw;
+  gChengGuiX11EventStats.deliveredEvents = produced;
+  gChengGuiX11EventStats.totalRawEvents += raw;
+  gChengGuiX11EventStats.totalDeliveredEvents += produced;
   return produced;
 }
 
+X11_EXPORT int chengGuiX11GetEventStats(ChengGuiX11EventStats *stats) {
+  if (stats == NULL) {
+    return -1;
+  }
+  *stats = gChengGuiX11EventStats;
+  return 0;
+}
+
 static void chengGuiX11FreeAllWindows(void) {
   ChengGuiX11Window *cursor = gChengGuiX11Windows;
   while (cursor != NULL) {
@@ -465,6 +883,15 @@ X11_EXPORT void chengGuiX11Initialize(void) {
     return;
   }
   gChengGuiX11Screen = DefaultScreen(gChengGuiX11Display);
+  gChengGuiX11Dpi = chengGuiX11ComputeDpi(gChengGuiX11Display, gChengGuiX11Screen);
+  gChengGuiX11RoundTrips = 0;
+  if (gChengGuiX11WakeFd < 0) {
+    gChengGuiX11WakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  }
+  gChengGuiX11ShmCompletionType = -1;
+  if (XShmQueryExtension(gChengGuiX11Display)) {
+    gChengGuiX11ShmCompletionType = XShmGetEventBase(gChengGuiX11Display) + ShmCompletion;
+  }
 }
 
 X11_EXPORT int chengGuiX11IsInitialized(void) {
@@ -472,6 +899,9 @@ X11_EXPORT int chengGuiX11IsInitialized(void) {
 }
 
 X11_EXPORT void chengGuiX11Shutdown(void) {
+  if (chengGuiX11EnvFlag("GUI_DEBUG", false)) {
+    chengGuiTextAtlasLogSummary("gui-x11");
+  }
   if (gChengGuiX11Display != NULL) {
     chengGuiX11FreeAllWindows();
     XCloseDisplay(gChengGuiX11Display);
@@ -479,6 +909,22 @@ X11_EXPORT void chengGuiX11Shutdown(void) {
   } else {
     chengGuiX11FreeAllWindows();
   }
+  if (gChengGuiX11WakeFd >= 0) {
+    close(gChengGuiX11WakeFd);
+    gChengGuiX11WakeFd = -1;
+  }
+}
+
+/* Safe to call from any thread: interrupts a blocking chengGuiX11PollEvents so
+   work queued off the UI thread is picked up without waiting for the timeout. */
+X11_EXPORT void chengGuiX11WakeEventLoop(void) {
+  int fd = gChengGuiX11WakeFd;
+  if (fd < 0) {
+    return;
+  }
+  uint64_t one = 1;
+  ssize_t written = write(fd, &one, sizeof(one));
+  (void)written;
 }
 
 X11_EXPORT void *chengGuiX11CreateWindow(
@@ -503,8 +949,9 @@ X11_EXPORT void *chengGuiX11CreateWindow(
   }
   window->display = gChengGuiX11Display;
   window->resizable = resizable;
+  window->needsFullPresent = true;
   window->highDpi = highDpi;
-  window->dpi = chengGuiX11ComputeDpi(gChengGuiX11Display, gChengGuiX11Screen);
+  window->dpi = gChengGuiX11Dpi;
   unsigned long black = BlackPixel(gChengGuiX11Display, gChengGuiX11Screen);
   unsigned long white = WhitePixel(gChengGuiX11Display, gChengGuiX11Screen);
   unsigned long borderColor = black;
@@ -596,6 +1043,18 @@ X11_EXPORT void *chengGuiX11CreateSurface(void *handle) {
     free(surface);
     return NULL;
   }
+  XWindowAttributes attributes;
+  gChengGuiX11RoundTrips++;
+  if (XGetWindowAttributes(window->display, window->window, &attributes) == 0) {
+    XFreeGC(window->display, surface->gc);
+    free(surface);
+    return NULL;
+  }
+  surface->visual = attributes.visual;
+  surface->depth = attributes.depth;
+  surface->shmEnabled = gChengGuiX11ShmCompletionType >= 0 && chengGuiX11EnvFlag("GUI_X11_SHM", true);
+  surface->stats.shmAvailable = surface->shmEnabled ? 1 : 0;
+  window->surface = surface;
   return (void *)surface;
 }
 
@@ -604,6 +1063,23 @@ X11_EXPORT void chengGuiX11DestroySurface(void *handle) {
   if (surface == NULL) {
     return;
   }
+  if (chengGuiX11EnvFlag("GUI_DEBUG", false)) {
+    fprintf(stderr,
+            "[gui-x11] present mode=%s frames=%lld shmReallocs=%lld lastMs=%.3f copyMs=%.3f bytes=%lld roundTrips=%d totalRoundTrips=%lld skippedClears=%d\n",
+            surface->stats.mode == ChengGuiX11PresentShm ? "mit-shm" : (surface->stats.mode == ChengGuiX11PresentPutImage ? "xputimage" : "none"),
+            (long long)surface->stats.frames,
+            (long long)surface->stats.shmReallocs,
+            surface->stats.presentMs,
+            surface->stats.copyMs,
+            (long long)surface->stats.uploadBytes,
+            (int)surface->stats.frameRoundTrips,
+            (long long)surface->stats.totalRoundTrips,
+            (int)surface->stats.skippedClears);
+  }
+  chengGuiX11ReleaseShmImage(surface);
+  if (surface->window != NULL && surface->window->surface == surface) {
+    surface->window->surface = NULL;
+  }
   if (surface->window != NULL && surface->window->display != NULL && surface->gc != NULL) {
     XFreeGC(surface->window->display, surface->gc);
   }
@@ -619,12 +1095,7 @@ X11_EXPORT int chengGuiX11GetSurfaceInfo(void *handle, ChengGuiX11SurfaceInfo *i
   if (window->display == NULL) {
     return -1;
   }
-  XWindowAttributes attributes;
-  if (XGetWindowAttributes(window->display, window->window, &attributes) == 0) {
-    return -1;
-  }
-  window->dpi = chengGuiX11ComputeDpi(window->display, gChengGuiX11Screen);
-  chengGuiX11UpdateLogicalSize(window, (unsigned int)attributes.width, (unsigned int)attributes.height);
+  /* Geometry is kept current by ConfigureNotify; no server query here. */
   info->logicalWidth = window->logicalWidth;
   info->logicalHeight = window->logicalHeight;
   info->pixelWidth = window->pixelWidth;
@@ -639,23 +1110,20 @@ X11_EXPORT int chengGuiX11BeginFrame(void *handle) {
   if (surface == NULL || surface->window == NULL || surface->window->display == NULL || surface->gc == NULL) {
     return -1;
   }
-  ChengGuiX11Window *window = surface->window;
-  XWindowAttributes attributes;
-  if (XGetWindowAttributes(window->display, window->window, &attributes) != 0) {
-    window->dpi = chengGuiX11ComputeDpi(window->display, gChengGuiX11Screen);
-    chengGuiX11UpdateLogicalSize(window, (unsigned int)attributes.width, (unsigned int)attributes.height);
+  /* The background clear is deferred: a present that covers the window makes
+     it redundant, and one that does not only fills the uncovered margins. */
+  surface->clearPending = true;
+  surface->frameRoundTripBase = gChengGuiX11RoundTrips;
+  return 0;
+}
+
+static void chengGuiX11ClearRect(ChengGuiX11Surface *surface, int x, int y, int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return;
   }
+  ChengGuiX11Window *window = surface->window;
   XSetForeground(window->display, surface->gc, 0x1E1E22);
-  XFillRectangle(
-    window->display,
-    window->window,
-    surface->gc,
-    0,
-    0,
-    (unsigned int)window->pixelWidth,
-    (unsigned int)window->pixelHeight
-  );
-  return 0;
+  XFillRectangle(window->display, window->window, surface->gc, x, y, (unsigned int)width, (unsigned int)height);
 }
 
 X11_EXPORT int chengGuiX11EndFrame(void *handle) {
@@ -663,15 +1131,99 @@ X11_EXPORT int chengGuiX11EndFrame(void *handle) {
   if (surface == NULL || surface->window == NULL || surface->window->display == NULL) {
     return -1;
   }
+  if (surface->clearPending && surface->gc != NULL) {
+    chengGuiX11ClearRect(surface, 0, 0, (int)surface->window->pixelWidth, (int)surface->window->pixelHeight);
+  }
+  surface->clearPending = false;
   XFlush(surface->window->display);
+  surface->stats.frameRoundTrips = (int32_t)(gChengGuiX11RoundTrips - surface->frameRoundTripBase);
+  surface->stats.totalRoundTrips = gChengGuiX11RoundTrips;
+  surface->frameRoundTripBase = gChengGuiX11RoundTrips;
   return 0;
 }
 
-X11_EXPORT int chengGuiX11PresentPixels(void *handle,
-                                              const uint32_t *pixels,
-                                              int width,
-                                              int height,
-                                              int strideBytes) {
+static int chengGuiX11PresentPutImage(ChengGuiX11Surface *surface,
+                                      const uint32_t *pixels,
+                                      int width,
+                                      int height,
+                                      int strideBytes,
+                                      const ChengGuiX11Rect *rects,
+                                      int rectCount) {
+  ChengGuiX11Window *window = surface->window;
+  /* XPutImage serializes the pixels before returning, so the caller's buffer
+     can back the image directly; data is detached before XDestroyImage. */
+  XImage *image = XCreateImage(window->display,
+                               surface->visual,
+                               (unsigned int)surface->depth,
+                               ZPixmap,
+                               0,
+                               (char *)pixels,
+                               (unsigned int)width,
+                               (unsigned int)height,
+                               32,
+                               strideBytes);
+  if (image == NULL) {
+    return -7;
+  }
+  for (int i = 0; i < rectCount; i++) {
+    XPutImage(window->display,
+              window->window,
+              surface->gc,
+              image,
+              rects[i].x,
+              rects[i].y,
+              rects[i].x,
+              rects[i].y,
+              (unsigned int)rects[i].width,
+              (unsigned int)rects[i].height);
+  }
+  XFlush(window->display);
+  image->data = NULL;
+  XDestroyImage(image);
+  surface->stats.copyMs = 0.0;
+  surface->stats.mode = ChengGuiX11PresentPutImage;
+  return 0;
+}
+
+static int chengGuiX11PresentShm(ChengGuiX11Surface *surface,
+                                 const uint32_t *pixels,
+                                 int strideBytes,
+                                 const ChengGuiX11Rect *rects,
+                                 int rectCount) {
+  ChengGuiX11Window *window = surface->window;
+  chengGuiX11WaitShmCompletion(surface);
+  XImage *image = surface->shmImage;
+  double copyStart = chengGuiX11NowMs();
+  for (int i = 0; i < rectCount; i++) {
+    chengGuiX11CopyRect(image->data, image->bytes_per_line, (const char *)pixels, strideBytes, &rects[i]);
+  }
+  surface->stats.copyMs = chengGuiX11NowMs() - copyStart;
+  for (int i = 0; i < rectCount; i++) {
+    XShmPutImage(window->display,
+                 window->window,
+                 surface->gc,
+                 image,
+                 rects[i].x,
+                 rects[i].y,
+                 rects[i].x,
+                 rects[i].y,
+                 (unsigned int)rects[i].width,
+                 (unsigned int)rects[i].height,
+                 i == rectCount - 1 ? True : False);
+  }
+  XFlush(window->display);
+  surface->shmPending = true;
+  surface->stats.mode = ChengGuiX11PresentShm;
+  return 0;
+}
+
+X11_EXPORT int chengGuiX11PresentPixelsRegions(void *handle,
+                                               const uint32_t *pixels,
+                                               int width,
+                                               int height,
+                                               int strideBytes,
+                                               const ChengGuiX11Rect *rects,
+                                               int rectCount) {
   ChengGuiX11Surface *surface = (ChengGuiX11Surface *)handle;
   if (surface == NULL || pixels == NULL) {
     return -1;
@@ -686,361 +1238,107 @@ X11_EXPORT int chengGuiX11PresentPixels(void *handle,
   if (strideBytes <= 0) {
     strideBytes = width * 4;
   }
-  size_t totalBytes = (size_t)strideBytes * (size_t)height;
-  if (totalBytes == 0) {
+  if ((size_t)strideBytes * (size_t)height == 0) {
     return -4;
   }
-  char *copy = (char *)malloc(totalBytes);
-  if (copy == NULL) {
-    return -5;
-  }
-  memcpy(copy, pixels, totalBytes);
-
-  XWindowAttributes attributes;
-  if (XGetWindowAttributes(window->display, window->window, &attributes) == 0) {
-    free(copy);
-    return -6;
-  }
-
-  XImage *image = XCreateImage(window->display,
-                               attributes.visual,
-                               (unsigned int)attributes.depth,
-                               ZPixmap,
-                               0,
-                               copy,
-                               (unsigned int)width,
-                               (unsigned int)height,
-                               32,
-                               strideBytes);
-  if (image == NULL) {
-    free(copy);
-    return -7;
-  }
-
   int copyW = width;
   int copyH = height;
-  if (attributes.width < copyW) copyW = attributes.width;
-  if (attributes.height < copyH) copyH = attributes.height;
+  if ((int)window->pixelWidth < copyW) copyW = (int)window->pixelWidth;
+  if ((int)window->pixelHeight < copyH) copyH = (int)window->pixelHeight;
   if (copyW <= 0 || copyH <= 0) {
-    XDestroyImage(image);
     return -8;
   }
-
-  XPutImage(window->display,
-            window->window,
-            surface->gc,
-            image,
-            0,
-            0,
-            0,
-            0,
-            (unsigned int)copyW,
-            (unsigned int)copyH);
-  XFlush(window->display);
-  XDestroyImage(image);
-  return 0;
-}
-
-X11_EXPORT size_t chengGuiX11EventStructSize(void) {
-  return sizeof(ChengGuiX11Event);
-}
-
-X11_EXPORT size_t chengGuiX11SurfaceInfoStructSize(void) {
-  return sizeof(ChengGuiX11SurfaceInfo);
-}
-
-X11_EXPORT int chengGuiNativeTextAvailable(void) {
-  return 0;
-}
-
-X11_EXPORT const char *chengGuiNativeTextBackend(void) {
-  return "unavailable";
-}
-
-X11_EXPORT int chengGuiIconFontAvailable(void) {
-  return 0;
-}
-
-X11_EXPORT int chengGuiFileIconFontAvailable(void) {
-  return 0;
-}
-
-X11_EXPORT int chengGuiDrawTextBgra(void *pixels,
-                                         int width,
-                                         int height,
-                                         int strideBytes,
-                                         double x,
-                                         double y,
-                                         double w,
-                                         double h,
-                                         uint32_t color,
-                                         double fontSize,
-                                         const char *text) {
-  (void)pixels;
-  (void)width;
-  (void)height;
-  (void)strideBytes;
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)fontSize;
-  (void)text;
-  return -1;
-}
-
-X11_EXPORT double chengGuiTextWidth(const char *text, double fontSize) {
-  (void)text;
-  (void)fontSize;
-  return 0.0;
-}
-
-X11_EXPORT double chengGuiTextWidthCode(const char *text, double fontSize) {
-  (void)text;
-  (void)fontSize;
-  return 0.0;
-}
-
-X11_EXPORT double chengGuiTextWidthIcon(const char *text, double fontSize) {
-  (void)text;
-  (void)fontSize;
-  return 0.0;
-}
-
-X11_EXPORT double chengGuiTextWidthFileIcon(const char *text, double fontSize) {
-  (void)text;
-  (void)fontSize;
-  return 0.0;
-}
-
-X11_EXPORT double chengGuiTextXAtIndex(const char *text, double fontSize, int32_t byteIndex) {
-  (void)text;
-  (void)fontSize;
-  (void)byteIndex;
-  return 0.0;
+  double start = chengGuiX11NowMs();
+  bool shmReady = chengGuiX11EnsureShmImage(surface, width, height);
+  ChengGuiX11Rect damage[CHENG_GUI_X11_MAX_DAMAGE_RECTS];
+  int damageCount = 0;
+  bool fullFrame = rects == NULL || rectCount <= 0 || window->needsFullPresent;
+  if (!fullFrame) {
+    damageCount = chengGuiX11NormalizeDamage(rects, rectCount, copyW, copyH, damage);
+    if (window->hasExpose) {
+      ChengGuiX11Rect merged[CHENG_GUI_X11_MAX_DAMAGE_RECTS + 1];
+      memcpy(merged, damage, sizeof(ChengGuiX11Rect) * (size_t)damageCount);
+      merged[damageCount] = window->exposeRect;
+      damageCount = chengGuiX11NormalizeDamage(merged, damageCount + 1, copyW, copyH, damage);
+    }
+  }
+  if (fullFrame) {
+    ChengGuiX11Rect full = { 0, 0, copyW, copyH };
+    damage[0] = full;
+    damageCount = 1;
+  }
+  int64_t uploadBytes = 0;
+  for (int i = 0; i < damageCount; i++) {
+    uploadBytes += (int64_t)damage[i].width * (int64_t)damage[i].height * 4;
+  }
+  int rc = 0;
+  if (damageCount > 0) {
+    if (shmReady) {
+      rc = chengGuiX11PresentShm(surface, pixels, strideBytes, damage, damageCount);
+    } else {
+      rc = chengGuiX11PresentPutImage(surface, pixels, width, height, strideBytes, damage, damageCount);
+    }
+  }
+  surface->stats.shmAvailable = surface->shmEnabled ? 1 : 0;
+  if (rc == 0) {
+    if (surface->clearPending) {
+      int windowW = (int)window->pixelWidth;
+      int windowH = (int)window->pixelHeight;
+      if (copyW >= windowW && copyH >= windowH) {
+        surface->stats.skippedClears++;
+      } else {
+        chengGuiX11ClearRect(surface, copyW, 0, windowW - copyW, windowH);
+        chengGuiX11ClearRect(surface, 0, copyH, copyW, windowH - copyH);
+      }
+      surface->clearPending = false;
+    }
+    if (fullFrame) {
+      window->needsFullPresent = false;
+      surface->shmRetained = shmReady;
+    }
+    window->hasExpose = false;
+    surface->stats.presentMs = chengGuiX11NowMs() - start;
+    surface->stats.uploadBytes = uploadBytes;
+    surface->stats.regionCount = damageCount;
+    surface->stats.fullFrame = fullFrame || (damageCount == 1 && damage[0].width == copyW && damage[0].height == copyH) ? 1 : 0;
+    surface->stats.frames++;
+  }
+  return rc;
 }
 
-X11_EXPORT double chengGuiTextXAtIndexCode(const char *text, double fontSize, int32_t byteIndex) {
-  (void)text;
-  (void)fontSize;
-  (void)byteIndex;
-  return 0.0;
+X11_EXPORT int chengGuiX11PresentPixels(void *handle,
+                                              const uint32_t *pixels,
+                                              int width,
+                                              int height,
+                                              int strideBytes) {
+  return chengGuiX11PresentPixelsRegions(handle, pixels, width, height, strideBytes, NULL, 0);
 }
 
-X11_EXPORT int32_t chengGuiTextIndexAtX(const char *text, double fontSize, double x) {
-  (void)text;
-  (void)fontSize;
-  (void)x;
-  return 0;
+/* Returns the shared-memory backing store of the next present so callers can
+   render in place; presenting this pointer skips the staging copy entirely. */
+X11_EXPORT void *chengGuiX11AcquirePresentBuffer(void *handle, int width, int height, int *strideBytes) {
+  ChengGuiX11Surface *surface = (ChengGuiX11Surface *)handle;
+  if (strideBytes != NULL) {
+    *strideBytes = 0;
+  }
+  if (surface == NULL || surface->window == NULL || surface->window->display == NULL) {
+    return NULL;
+  }
+  if (width <= 0 || height <= 0 || !chengGuiX11EnsureShmImage(surface, width, height)) {
+    return NULL;
+  }
+  chengGuiX11WaitShmCompletion(surface);
+  if (strideBytes != NULL) {
+    *strideBytes = surface->shmImage->bytes_per_line;
+  }
+  return (void *)surface->shmImage->data;
 }
 
-X11_EXPORT int32_t chengGuiTextIndexAtXCode(const char *text, double fontSize, double x) {
-  (void)text;
-  (void)fontSize;
-  (void)x;
+X11_EXPORT int chengGuiX11GetPresentStats(void *handle, ChengGuiX11PresentStats *stats) {
+  ChengGuiX11Surface *surface = (ChengGuiX11Surface *)handle;
+  if (surface == NULL || stats == NULL) {
+    return -1;
+  }
+  *stats = surface->stats;
   return 0;
 }
-
-X11_EXPORT void chengGuiNativeInitialize(void) {
-  chengGuiX11Initialize();
-}
-
-X11_EXPORT void chengGuiNativeShutdown(void) {
-  chengGuiX11Shutdown();
-}
-
-X11_EXPORT void *chengGuiNativeCreateDefaultWindow(const char *title) {
-  return chengGuiX11CreateDefaultWindow(title);
-}
-
-X11_EXPORT void chengGuiNativeDestroyWindow(void *handle) {
-  chengGuiX11DestroyWindow(handle);
-}
-
-X11_EXPORT int chengGuiNativePollEvents(void *events, int maxEvents, int timeoutMs) {
-  return chengGuiX11PollEvents((ChengGuiX11Event *)events, maxEvents, timeoutMs);
-}
-
-X11_EXPORT void *chengGuiNativeCreateSurface(void *windowHandle) {
-  return chengGuiX11CreateSurface(windowHandle);
-}
-
-X11_EXPORT void chengGuiNativeDestroySurface(void *surfaceHandle) {
-  chengGuiX11DestroySurface(surfaceHandle);
-}
-
-X11_EXPORT int chengGuiNativeBeginFrame(void *surfaceHandle) {
-  return chengGuiX11BeginFrame(surfaceHandle);
-}
-
-X11_EXPORT int chengGuiNativeEndFrame(void *surfaceHandle) {
-  return chengGuiX11EndFrame(surfaceHandle);
-}
-
-X11_EXPORT int chengGuiNativeGetSurfaceInfo(void *surfaceHandle, void *outInfo) {
-  return chengGuiX11GetSurfaceInfo(surfaceHandle, (ChengGuiX11SurfaceInfo *)outInfo);
-}
-
-X11_EXPORT int chengGuiNativePresentPixels(
-  void *surfaceHandle,
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes
-) {
-  return chengGuiX11PresentPixels(surfaceHandle, pixels, width, height, strideBytes);
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgra(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  double x,
-  double y,
-  double w,
-  double h,
-  uint32_t color,
-  double fontSize,
-  const char *text
-) {
-  return chengGuiDrawTextBgra(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text);
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgraLen(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  double x,
-  double y,
-  double w,
-  double h,
-  uint32_t color,
-  double fontSize,
-  const char *text,
-  int textLen
-) {
-  (void)textLen;
-  return chengGuiDrawTextBgra(pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text);
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgraLenI(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  int x,
-  int y,
-  int w,
-  int h,
-  uint32_t color,
-  int fontSizeX100,
-  const char *text,
-  int textLen
-) {
-  (void)textLen;
-  double fontSize = (double)fontSizeX100 / 100.0;
-  if (fontSize <= 1.0) {
-    fontSize = 14.0;
-  }
-  return chengGuiDrawTextBgra(
-    pixels,
-    width,
-    height,
-    strideBytes,
-    (double)x,
-    (double)y,
-    (double)w,
-    (double)h,
-    color,
-    fontSize,
-    text
-  );
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgraCode(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  double x,
-  double y,
-  double w,
-  double h,
-  uint32_t color,
-  double fontSize,
-  const char *text
-) {
-  (void)pixels;
-  (void)width;
-  (void)height;
-  (void)strideBytes;
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)fontSize;
-  (void)text;
-  return -1;
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgraIcon(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  double x,
-  double y,
-  double w,
-  double h,
-  uint32_t color,
-  double fontSize,
-  const char *text
-) {
-  (void)pixels;
-  (void)width;
-  (void)height;
-  (void)strideBytes;
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)fontSize;
-  (void)text;
-  return -1;
-}
-
-X11_EXPORT int chengGuiNativeDrawTextBgraFileIcon(
-  void *pixels,
-  int width,
-  int height,
-  int strideBytes,
-  double x,
-  double y,
-  double w,
-  double h,
-  uint32_t color,
-  double fontSize,
-  const char *text
-) {
-  (void)pixels;
-  (void)width;
-  (void)height;
-  (void)strideBytes;
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)fontSize;
-  (void)text;
-  return -1;
-}
-
-X11_EXPORT size_t chengGuiNativeEventStructSize(void) {
-  return chengGuiX11EventStructSize();
-}
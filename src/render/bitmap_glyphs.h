@@ -0,0 +1,142 @@
+/* Generated by scripts/gen_bitmap_glyphs.py from render/glyphs/; do not edit.
+ * Same layout as render/bitmap_glyphs.cheng: row r of a glyph is bits
+ * [r * 8, r * 8 + 8) of its mask, column c is bit c. */
+#ifndef CHENG_GUI_BITMAP_GLYPHS_H
+#define CHENG_GUI_BITMAP_GLYPHS_H
+
+#include <stdint.h>
+
+enum { ChengGlyph5x7Cols = 5, ChengGlyph5x7Rows = 7, ChengGlyph5x7BitsPerRow = 8 };
+
+static const uint64_t chengGlyph5x7[128] = {
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x000200020408101FULL,
+  0x0000000000000000ULL, /* ' ' */
+  0x0004000404040404ULL, /* '!' */
+  0x000200020408101FULL, /* '"' */
+  0x000A0A1F0A0A1F0AULL, /* '#' */
+  0x000200020408101FULL, /* '$' */
+  0x000200020408101FULL, /* '%' */
+  0x000200020408101FULL, /* '&' */
+  0x000200020408101FULL, /* "'" */
+  0x0008040202020408ULL, /* '(' */
+  0x0002040808080402ULL, /* ')' */
+  0x000200020408101FULL, /* '*' */
+  0x000004041F040400ULL, /* '+' */
+  0x00060C0C00000000ULL, /* ',' */
+  0x000000001F000000ULL, /* '-' */
+  0x000C0C0000000000ULL, /* '.' */
+  0x0001020204080810ULL, /* '/' */
+  0x000E11131519110EULL, /* '0' */
+  0x000E040404040604ULL, /* '1' */
+  0x001F02040810110EULL, /* '2' */
+  0x000E11100C10110EULL, /* '3' */
+  0x0008081F090A0C08ULL, /* '4' */
+  0x000E11100F01011FULL, /* '5' */
+  0x000E11110F01110EULL, /* '6' */
+  0x000202020408101FULL, /* '7' */
+  0x000E11110E11110EULL, /* '8' */
+  0x000E11101E11110EULL, /* '9' */
+  0x00000C0C000C0C00ULL, /* ':' */
+  0x000200020408101FULL, /* ';' */
+  0x000200020408101FULL, /* '<' */
+  0x000000001F001F00ULL, /* '=' */
+  0x000200020408101FULL, /* '>' */
+  0x000400040810110EULL, /* '?' */
+  0x000200020408101FULL, /* '@' */
+  0x001111111F11110EULL, /* 'A' */
+  0x000F11110F11110FULL, /* 'B' */
+  0x000E11010101110EULL, /* 'C' */
+  0x000F11111111110FULL, /* 'D' */
+  0x001F01010F01011FULL, /* 'E' */
+  0x000101010F01011FULL, /* 'F' */
+  0x000E11111D01110EULL, /* 'G' */
+  0x001111111F111111ULL, /* 'H' */
+  0x001F04040404041FULL, /* 'I' */
+  0x000609090808081CULL, /* 'J' */
+  0x0011090503050911ULL, /* 'K' */
+  0x001F010101010101ULL, /* 'L' */
+  0x0011111111151B11ULL, /* 'M' */
+  0x0011111119151311ULL, /* 'N' */
+  0x000E11111111110EULL, /* 'O' */
+  0x000101010F11110FULL, /* 'P' */
+  0x001609151111110EULL, /* 'Q' */
+  0x001109050F11110FULL, /* 'R' */
+  0x000F10100E01011EULL, /* 'S' */
+  0x000404040404041FULL, /* 'T' */
+  0x000E111111111111ULL, /* 'U' */
+  0x00040A1111111111ULL, /* 'V' */
+  0x00111B1515111111ULL, /* 'W' */
+  0x0011110A040A1111ULL, /* 'X' */
+  0x00040404040A1111ULL, /* 'Y' */
+  0x001F01020408101FULL, /* 'Z' */
+  0x000200020408101FULL, /* '[' */
+  0x000200020408101FULL, /* '\\' */
+  0x000200020408101FULL, /* ']' */
+  0x000200020408101FULL, /* '^' */
+  0x001F000000000000ULL, /* '_' */
+  0x000200020408101FULL, /* '`' */
+  0x001111111F11110EULL, /* 'a' */
+  0x000F11110F11110FULL, /* 'b' */
+  0x000E11010101110EULL, /* 'c' */
+  0x000F11111111110FULL, /* 'd' */
+  0x001F01010F01011FULL, /* 'e' */
+  0x000101010F01011FULL, /* 'f' */
+  0x000E11111D01110EULL, /* 'g' */
+  0x001111111F111111ULL, /* 'h' */
+  0x001F04040404041FULL, /* 'i' */
+  0x000609090808081CULL, /* 'j' */
+  0x0011090503050911ULL, /* 'k' */
+  0x001F010101010101ULL, /* 'l' */
+  0x0011111111151B11ULL, /* 'm' */
+  0x0011111119151311ULL, /* 'n' */
+  0x000E11111111110EULL, /* 'o' */
+  0x000101010F11110FULL, /* 'p' */
+  0x001609151111110EULL, /* 'q' */
+  0x001109050F11110FULL, /* 'r' */
+  0x000F10100E01011EULL, /* 's' */
+  0x000404040404041FULL, /* 't' */
+  0x000E111111111111ULL, /* 'u' */
+  0x00040A1111111111ULL, /* 'v' */
+  0x00111B1515111111ULL, /* 'w' */
+  0x0011110A040A1111ULL, /* 'x' */
+  0x00040404040A1111ULL, /* 'y' */
+  0x001F01020408101FULL, /* 'z' */
+  0x000200020408101FULL, /* '{' */
+  0x000200020408101FULL, /* '|' */
+  0x000200020408101FULL, /* '}' */
+  0x000200020408101FULL, /* '~' */
+  0x000200020408101FULL,
+};
+
+#endif
@@ -0,0 +1,1118 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(_WIN32)
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+/*
+ * CPU canvas pixel kernels. Pixels are 32-bit 0xAARRGGBB words (BGRA bytes in
+ * memory), straight alpha, matching the Cheng canvas and the native presents.
+ * Blending is source-over with an exactly rounded divide by 255, computed the
+ * same way in every implementation so scalar, SSE2 and AVX2 produce identical
+ * bytes:
+ *
+ *   out.c = div255(src.c * a + dst.c * (255 - a))
+ *   out.a = div255(255 * a + dst.a * (255 - a))
+ *   div255(x) = (x + 128 + ((x + 128) >> 8)) >> 8
+ *
+ * The row kernels are selected once at first use from the CPU features; the
+ * GUI_KERNELS environment variable (scalar|sse2|avx2) can force a lower level.
+ */
+
+#if defined(_WIN32)
+#  define KERNELS_EXPORT __declspec(dllexport)
+#else
+#  define KERNELS_EXPORT __attribute__((visibility("default")))
+#endif
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#  define CHENG_KERNELS_X86 1
+#  include <immintrin.h>
+#else
+#  define CHENG_KERNELS_X86 0
+#endif
+
+enum {
+  ChengGuiKernelIsaScalar = 0,
+  ChengGuiKernelIsaSse2 = 1,
+  ChengGuiKernelIsaAvx2 = 2
+};
+
+typedef struct {
+  int isa;
+  void (*fillRow)(uint32_t *dst, int count, uint32_t color);
+  void (*blendSolidRow)(uint32_t *dst, int count, uint32_t color);
+  void (*blendRow)(uint32_t *dst, const uint32_t *src, int count);
+  void (*blendMaskRow)(uint32_t *dst, const uint8_t *mask, int count, uint32_t color);
+} ChengGuiKernelTable;
+
+static inline uint32_t chengKernelDiv255(uint32_t x) {
+  x += 128u;
+  return (x + (x >> 8)) >> 8;
+}
+
+static inline uint32_t chengKernelBlendPixel(uint32_t dst, uint32_t src, uint32_t a) {
+  uint32_t inv = 255u - a;
+  uint32_t oa = chengKernelDiv255(255u * a + ((dst >> 24) & 0xFFu) * inv);
+  uint32_t orr = chengKernelDiv255(((src >> 16) & 0xFFu) * a + ((dst >> 16) & 0xFFu) * inv);
+  uint32_t og = chengKernelDiv255(((src >> 8) & 0xFFu) * a + ((dst >> 8) & 0xFFu) * inv);
+  uint32_t ob = chengKernelDiv255((src & 0xFFu) * a + (dst & 0xFFu) * inv);
+  return (oa << 24) | (orr << 16) | (og << 8) | ob;
+}
+
+/* ---- scalar ---------------------------------------------------------------- */
+
+static void chengKernelFillRowScalar(uint32_t *dst, int count, uint32_t color) {
+  for (int i = 0; i < count; i++) dst[i] = color;
+}
+
+static void chengKernelBlendSolidRowScalar(uint32_t *dst, int count, uint32_t color) {
+  uint32_t a = color >> 24;
+  for (int i = 0; i < count; i++) dst[i] = chengKernelBlendPixel(dst[i], color, a);
+}
+
+static void chengKernelBlendRowScalar(uint32_t *dst, const uint32_t *src, int count) {
+  for (int i = 0; i < count; i++) {
+    uint32_t s = src[i];
+    uint32_t a = s >> 24;
+    if (a == 0u) continue;
+    dst[i] = a == 255u ? s : chengKernelBlendPixel(dst[i], s, a);
+  }
+}
+
+static void chengKernelBlendMaskRowScalar(uint32_t *dst, const uint8_t *mask, int count, uint32_t color) {
+  uint32_t alpha = color >> 24;
+  for (int i = 0; i < count; i++) {
+    uint32_t c = mask[i];
+    if (c == 0u) continue;
+    uint32_t a = chengKernelDiv255(c * alpha);
+    dst[i] = a == 255u ? (color | 0xFF000000u) : chengKernelBlendPixel(dst[i], color, a);
+  }
+}
+
+#if CHENG_KERNELS_X86
+
+/* ---- SSE2 (x86_64 baseline) ------------------------------------------------- */
+
+/* Blends two pixels held as 16-bit lanes; `a16` carries each pixel's alpha in
+ * all four of its lanes and `s16` has the source alpha lane forced to 255. */
+static inline __m128i chengKernelLerp16Sse2(__m128i s16, __m128i d16, __m128i a16) {
+  const __m128i k255 = _mm_set1_epi16(255);
+  const __m128i k128 = _mm_set1_epi16(128);
+  __m128i t = _mm_add_epi16(_mm_mullo_epi16(s16, a16), _mm_mullo_epi16(d16, _mm_sub_epi16(k255, a16)));
+  t = _mm_add_epi16(t, k128);
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+static inline __m128i chengKernelBroadcastAlphaSse2(__m128i px16) {
+  px16 = _mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_shufflehi_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Source-over of four straight-alpha source pixels onto four destination pixels. */
+static inline __m128i chengKernelBlend4Sse2(__m128i src, __m128i dst) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000u);
+  __m128i srcOpaque = _mm_or_si128(src, alphaMask);
+  __m128i lo = chengKernelLerp16Sse2(_mm_unpacklo_epi8(srcOpaque, zero),
+                                     _mm_unpacklo_epi8(dst, zero),
+                                     chengKernelBroadcastAlphaSse2(_mm_unpacklo_epi8(src, zero)));
+  __m128i hi = chengKernelLerp16Sse2(_mm_unpackhi_epi8(srcOpaque, zero),
+                                     _mm_unpackhi_epi8(dst, zero),
+                                     chengKernelBroadcastAlphaSse2(_mm_unpackhi_epi8(src, zero)));
+  return _mm_packus_epi16(lo, hi);
+}
+
+static void chengKernelFillRowSse2(uint32_t *dst, int count, uint32_t color) {
+  __m128i v = _mm_set1_epi32((int)color);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    _mm_storeu_si128((__m128i *)(dst + i), v);
+    _mm_storeu_si128((__m128i *)(dst + i + 4), v);
+    _mm_storeu_si128((__m128i *)(dst + i + 8), v);
+    _mm_storeu_si128((__m128i *)(dst + i + 12), v);
+  }
+  for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(dst + i), v);
+  for (; i < count; i++) dst[i] = color;
+}
+
+static void chengKernelBlendSolidRowSse2(uint32_t *dst, int count, uint32_t color) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i k128 = _mm_set1_epi16(128);
+  uint32_t a = color >> 24;
+  __m128i inv16 = _mm_set1_epi16((short)(255u - a));
+  /* src * a + 128 is constant across the run; only the destination term varies. */
+  __m128i s16 = _mm_unpacklo_epi8(_mm_set1_epi32((int)(color | 0xFF000000u)), zero);
+  __m128i base = _mm_add_epi16(_mm_mullo_epi16(s16, _mm_set1_epi16((short)a)), k128);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv16), base);
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv16), base);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+  }
+  for (; i < count; i++) dst[i] = chengKernelBlendPixel(dst[i], color, a);
+}
+
+static void chengKernelBlendRowSse2(uint32_t *dst, const uint32_t *src, int count) {
+  const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000u);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i alpha = _mm_and_si128(s, alphaMask);
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128()));
+    if (mask == 0xFFFF) continue;
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF) {
+      _mm_storeu_si128((__m128i *)(dst + i), s);
+      continue;
+    }
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    _mm_storeu_si128((__m128i *)(dst + i), chengKernelBlend4Sse2(s, d));
+  }
+  chengKernelBlendRowScalar(dst + i, src + i, count - i);
+}
+
+/* Expands four coverage bytes into four source pixels carrying div255(cov * a). */
+static inline __m128i chengKernelMaskSource4Sse2(uint32_t cov4, __m128i alpha32, __m128i rgb) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i k128 = _mm_set1_epi32(128);
+  __m128i cov = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)cov4), zero), zero);
+  __m128i t = _mm_add_epi32(_mm_mullo_epi16(cov, alpha32), k128);
+  t = _mm_srli_epi32(_mm_add_epi32(t, _mm_srli_epi32(t, 8)), 8);
+  return _mm_or_si128(_mm_slli_epi32(t, 24), rgb);
+}
+
+static void chengKernelBlendMaskRowSse2(uint32_t *dst, const uint8_t *mask, int count, uint32_t color) {
+  __m128i alpha32 = _mm_set1_epi32((int)(color >> 24));
+  __m128i rgb = _mm_set1_epi32((int)(color & 0x00FFFFFFu));
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32_t cov4;
+    memcpy(&cov4, mask + i, sizeof(cov4));
+    if (cov4 == 0u) continue;
+    __m128i s = chengKernelMaskSource4Sse2(cov4, alpha32, rgb);
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    _mm_storeu_si128((__m128i *)(dst + i), chengKernelBlend4Sse2(s, d));
+  }
+  chengKernelBlendMaskRowScalar(dst + i, mask + i, count - i, color);
+}
+
+/* ---- AVX2 ------------------------------------------------------------------- */
+
+#define CHENG_KERNELS_AVX2 __attribute__((target("avx2")))
+
+CHENG_KERNELS_AVX2 static inline __m256i chengKernelLerp16Avx2(__m256i s16, __m256i d16, __m256i a16) {
+  const __m256i k255 = _mm256_set1_epi16(255);
+  const __m256i k128 = _mm256_set1_epi16(128);
+  __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s16, a16), _mm256_mullo_epi16(d16, _mm256_sub_epi16(k255, a16)));
+  t = _mm256_add_epi16(t, k128);
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+CHENG_KERNELS_AVX2 static inline __m256i chengKernelBroadcastAlphaAvx2(__m256i px16) {
+  px16 = _mm256_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm256_shufflehi_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+CHENG_KERNELS_AVX2 static inline __m256i chengKernelBlend8Avx2(__m256i src, __m256i dst) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000u);
+  __m256i srcOpaque = _mm256_or_si256(src, alphaMask);
+  /* unpack/pack work per 128-bit lane, so the round trip keeps pixel order. */
+  __m256i lo = chengKernelLerp16Avx2(_mm256_unpacklo_epi8(srcOpaque, zero),
+                                     _mm256_unpacklo_epi8(dst, zero),
+                                     chengKernelBroadcastAlphaAvx2(_mm256_unpacklo_epi8(src, zero)));
+  __m256i hi = chengKernelLerp16Avx2(_mm256_unpackhi_epi8(srcOpaque, zero),
+                                     _mm256_unpackhi_epi8(dst, zero),
+                                     chengKernelBroadcastAlphaAvx2(_mm256_unpackhi_epi8(src, zero)));
+  return _mm256_packus_epi16(lo, hi);
+}
+
+CHENG_KERNELS_AVX2 static void chengKernelFillRowAvx2(uint32_t *dst, int count, uint32_t color) {
+  __m256i v = _mm256_set1_epi32((int)color);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    _mm256_storeu_si256((__m256i *)(dst + i), v);
+    _mm256_storeu_si256((__m256i *)(dst + i + 8), v);
+    _mm256_storeu_si256((__m256i *)(dst + i + 16), v);
+    _mm256_storeu_si256((__m256i *)(dst + i + 24), v);
+  }
+  for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i *)(dst + i), v);
+  for (; i < count; i++) dst[i] = color;
+}
+
+CHENG_KERNELS_AVX2 static void chengKernelBlendSolidRowAvx2(uint32_t *dst, int count, uint32_t color) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i k128 = _mm256_set1_epi16(128);
+  uint32_t a = color >> 24;
+  __m256i inv16 = _mm256_set1_epi16((short)(255u - a));
+  __m256i s16 = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)(color | 0xFF000000u)), zero);
+  __m256i base = _mm256_add_epi16(_mm256_mullo_epi16(s16, _mm256_set1_epi16((short)a)), k128);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv16), base);
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv16), base);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(lo, hi));
+  }
+  chengKernelBlendSolidRowSse2(dst + i, count - i, color);
+}
+
+CHENG_KERNELS_AVX2 static void chengKernelBlendRowAvx2(uint32_t *dst, const uint32_t *src, int count) {
+  const __m256i alphaMask = _mm256_set1_epi32((int)0xFF000000u);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i alpha = _mm256_and_si256(s, alphaMask);
+    if (_mm256_testz_si256(alpha, alpha)) continue;
+    if ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, alphaMask)) == 0xFFFFFFFFu) {
+      _mm256_storeu_si256((__m256i *)(dst + i), s);
+      continue;
+    }
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), chengKernelBlend8Avx2(s, d));
+  }
+  chengKernelBlendRowSse2(dst + i, src + i, count - i);
+}
+
+CHENG_KERNELS_AVX2 static void chengKernelBlendMaskRowAvx2(uint32_t *dst, const uint8_t *mask, int count, uint32_t color) {
+  const __m256i k128 = _mm256_set1_epi32(128);
+  __m256i alpha32 = _mm256_set1_epi32((int)(color >> 24));
+  __m256i rgb = _mm256_set1_epi32((int)(color & 0x00FFFFFFu));
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint64_t cov8;
+    memcpy(&cov8, mask + i, sizeof(cov8));
+    if (cov8 == 0u) continue;
+    __m256i cov = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((long long)cov8));
+    __m256i t = _mm256_add_epi32(_mm256_mullo_epi16(cov, alpha32), k128);
+    t = _mm256_srli_epi32(_mm256_add_epi32(t, _mm256_srli_epi32(t, 8)), 8);
+    __m256i s = _mm256_or_si256(_mm256_slli_epi32(t, 24), rgb);
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), chengKernelBlend8Avx2(s, d));
+  }
+  chengKernelBlendMaskRowSse2(dst + i, mask + i, count - i, color);
+}
+
+#endif
+
+/* ---- dispatch --------------------------------------------------------------- */
+
+static ChengGuiKernelTable gChengGuiKernels;
+static int gChengGuiKernelsReady = 0;
+
+static void chengGuiKernelsSelect(int isa) {
+  ChengGuiKernelTable table;
+  table.isa = ChengGuiKernelIsaScalar;
+  table.fillRow = chengKernelFillRowScalar;
+  table.blendSolidRow = chengKernelBlendSolidRowScalar;
+  table.blendRow = chengKernelBlendRowScalar;
+  table.blendMaskRow = chengKernelBlendMaskRowScalar;
+#if CHENG_KERNELS_X86
+  if (isa >= ChengGuiKernelIsaSse2) {
+    table.isa = ChengGuiKernelIsaSse2;
+    table.fillRow = chengKernelFillRowSse2;
+    table.blendSolidRow = chengKernelBlendSolidRowSse2;
+    table.blendRow = chengKernelBlendRowSse2;
+    table.blendMaskRow = chengKernelBlendMaskRowSse2;
+  }
+  if (isa >= ChengGuiKernelIsaAvx2) {
+    table.isa = ChengGuiKernelIsaAvx2;
+    table.fillRow = chengKernelFillRowAvx2;
+    table.blendSolidRow = chengKernelBlendSolidRowAvx2;
+    table.blendRow = chengKernelBlendRowAvx2;
+    table.blendMaskRow = chengKernelBlendMaskRowAvx2;
+  }
+#else
+  (void)isa;
+#endif
+  gChengGuiKernels = table;
+  gChengGuiKernelsReady = 1;
+}
+
+static int chengGuiKernelsDetect(void) {
+  int isa = ChengGuiKernelIsaScalar;
+#if CHENG_KERNELS_X86
+  isa = ChengGuiKernelIsaSse2;
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) isa = ChengGuiKernelIsaAvx2;
+#endif
+  const char *forced = getenv("GUI_KERNELS");
+  if (forced != NULL) {
+    int want = isa;
+    if (strcmp(forced, "scalar") == 0) want = ChengGuiKernelIsaScalar;
+    else if (strcmp(forced, "sse2") == 0) want = ChengGuiKernelIsaSse2;
+    else if (strcmp(forced, "avx2") == 0) want = ChengGuiKernelIsaAvx2;
+    if (want < isa) isa = want;
+  }
+  return isa;
+}
+
+static const ChengGuiKernelTable *chengGuiKernels(void) {
+  if (!gChengGuiKernelsReady) chengGuiKernelsSelect(chengGuiKernelsDetect());
+  return &gChengGuiKernels;
+}
+
+/* Clips (x, y, w, h) to the canvas; returns 0 when nothing is left. */
+static int chengGuiKernelClip(int width, int height, int *x, int *y, int *w, int *h) {
+  int x0 = *x < 0 ? 0 : *x;
+  int y0 = *y < 0 ? 0 : *y;
+  int64_t x1 = (int64_t)*x + *w;
+  int64_t y1 = (int64_t)*y + *h;
+  if (x1 > width) x1 = width;
+  if (y1 > height) y1 = height;
+  if (x1 <= x0 || y1 <= y0) return 0;
+  *x = x0;
+  *y = y0;
+  *w = (int)(x1 - x0);
+  *h = (int)(y1 - y0);
+  return 1;
+}
+
+static inline uint32_t *chengGuiKernelRow(void *pixels, int strideBytes, int x, int y) {
+  return (uint32_t *)((uint8_t *)pixels + (size_t)y * (size_t)strideBytes) + x;
+}
+
+KERNELS_EXPORT int32_t chengGuiKernelIsa(void) {
+  return (int32_t)chengGuiKernels()->isa;
+}
+
+KERNELS_EXPORT const char *chengGuiKernelIsaName(void) {
+  switch (chengGuiKernels()->isa) {
+    case ChengGuiKernelIsaAvx2: return "avx2";
+    case ChengGuiKernelIsaSse2: return "sse2";
+    default: return "scalar";
+  }
+}
+
+/* Overwrites the clipped rect with `color`, alpha included. */
+KERNELS_EXPORT void chengGuiKernelFillRect(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                           int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  if (pixels == NULL || !chengGuiKernelClip(width, height, &x, &y, &w, &h)) return;
+  const ChengGuiKernelTable *k = chengGuiKernels();
+  if (strideBytes == width * 4 && x == 0 && w == width) {
+    k->fillRow(chengGuiKernelRow(pixels, strideBytes, 0, y), w * h, color);
+    return;
+  }
+  for (int row = 0; row < h; row++) k->fillRow(chengGuiKernelRow(pixels, strideBytes, x, y + row), w, color);
+}
+
+/* Source-over of a solid color; opaque colors take the fill path, clear ones are dropped. */
+KERNELS_EXPORT void chengGuiKernelBlendRect(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                            int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+  uint32_t a = color >> 24;
+  if (a == 255u) {
+    chengGuiKernelFillRect(pixels, width, height, strideBytes, x, y, w, h, color);
+    return;
+  }
+  if (a == 0u || pixels == NULL || !chengGuiKernelClip(width, height, &x, &y, &w, &h)) return;
+  const ChengGuiKernelTable *k = chengGuiKernels();
+  for (int row = 0; row < h; row++) k->blendSolidRow(chengGuiKernelRow(pixels, strideBytes, x, y + row), w, color);
+}
+
+/* Anti-aliased rounded rect: corner pixels get analytic coverage, the rest of
+ * each row goes through the solid span kernels. */
+KERNELS_EXPORT void chengGuiKernelFillRoundRect(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                                int32_t x, int32_t y, int32_t w, int32_t h, double radius,
+                                                uint32_t color) {
+  if (pixels == NULL || w <= 0 || h <= 0 || (color >> 24) == 0u) return;
+  float maxRadius = (float)(w < h ? w : h) * 0.5f;
+  float r = radius < 0.0 ? 0.0f : (radius > (double)maxRadius ? maxRadius : (float)radius);
+  int band = (int)ceilf(r);
+  if (band == 0) {
+    chengGuiKernelBlendRect(pixels, width, height, strideBytes, x, y, w, h, color);
+    return;
+  }
+  const ChengGuiKernelTable *k = chengGuiKernels();
+  uint32_t alpha = color >> 24;
+  int y0 = y < 0 ? 0 : y;
+  int y1 = y + h > height ? height : y + h;
+  int x0 = x < 0 ? 0 : x;
+  int x1 = x + w > width ? width : x + w;
+  if (x1 <= x0 || y1 <= y0) return;
+  if (y0 < y + band || y1 > y + h - band) {
+    for (int py = y0; py < y1; py++) {
+      int local = py - y;
+      if (local >= band && local < h - band) continue;
+      float cy = local < band ? r - ((float)local + 0.5f) : ((float)local + 0.5f) - ((float)h - r);
+      uint32_t *row = chengGuiKernelRow(pixels, strideBytes, 0, py);
+      int spanX0 = x + band;
+      int spanX1 = x + w - band;
+      for (int side = 0; side < 2; side++) {
+        int cx0 = side == 0 ? x : x + w - band;
+        int cx1 = side == 0 ? x + band : x + w;
+        if (cx0 < x0) cx0 = x0;
+        if (cx1 > x1) cx1 = x1;
+        for (int px = cx0; px < cx1; px++) {
+          int lx = px - x;
+          float cx = lx < band ? r - ((float)lx + 0.5f) : ((float)lx + 0.5f) - ((float)w - r);
+          float coverage = 1.0f;
+          if (cx > 0.0f && cy > 0.0f) {
+            coverage = r + 0.5f - sqrtf(cx * cx + cy * cy);
+            if (coverage <= 0.0f) continue;
+            if (coverage > 1.0f) coverage = 1.0f;
+          }
+          uint32_t a = (uint32_t)(coverage * (float)alpha + 0.5f);
+          if (a == 0u) continue;
+          row[px] = a == 255u ? color : chengKernelBlendPixel(row[px], color, a);
+        }
+      }
+      if (spanX0 < x0) spanX0 = x0;
+      if (spanX1 > x1) spanX1 = x1;
+      if (spanX1 > spanX0) {
+        if (alpha == 255u) k->fillRow(row + spanX0, spanX1 - spanX0, color);
+        else k->blendSolidRow(row + spanX0, spanX1 - spanX0, color);
+      }
+    }
+  }
+  int midY0 = y + band > y0 ? y + band : y0;
+  int midY1 = y + h - band < y1 ? y + h - band : y1;
+  if (midY1 > midY0) chengGuiKernelBlendRect(pixels, width, height, strideBytes, x, midY0, w, midY1 - midY0, color);
+}
+
+/* Blends `count` straight-alpha source pixels onto `dst`. */
+KERNELS_EXPORT void chengGuiKernelBlendRow(uint32_t *dst, const uint32_t *src, int32_t count) {
+  if (dst == NULL || src == NULL || count <= 0) return;
+  chengGuiKernels()->blendRow(dst, src, count);
+}
+
+/* Blends `color` onto `dst` through an 8-bit coverage row (glyph masks). */
+KERNELS_EXPORT void chengGuiKernelBlendMaskRow(uint32_t *dst, const uint8_t *mask, int32_t count, uint32_t color) {
+  if (dst == NULL || mask == NULL || count <= 0 || (color >> 24) == 0u) return;
+  chengGuiKernels()->blendMaskRow(dst, mask, count, color);
+}
+
+/* Places a srcWidth x srcHeight image at (dx, dy) on the canvas, clipped. With
+ * `blend` set the image is composited source-over, otherwise rows are copied. */
+KERNELS_EXPORT void chengGuiKernelDrawPixels(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                             const void *src, int32_t srcWidth, int32_t srcHeight,
+                                             int32_t srcStrideBytes, int32_t dx, int32_t dy, int32_t blend) {
+  if (pixels == NULL || src == NULL) return;
+  int x = dx;
+  int y = dy;
+  int w = srcWidth;
+  int h = srcHeight;
+  if (!chengGuiKernelClip(width, height, &x, &y, &w, &h)) return;
+  int sx = x - dx;
+  int sy = y - dy;
+  const ChengGuiKernelTable *k = chengGuiKernels();
+  for (int row = 0; row < h; row++) {
+    uint32_t *out = chengGuiKernelRow(pixels, strideBytes, x, y + row);
+    const uint32_t *in = (const uint32_t *)((const uint8_t *)src + (size_t)(sy + row) * (size_t)srcStrideBytes) + sx;
+    if (blend) k->blendRow(out, in, w);
+    else memmove(out, in, (size_t)w * sizeof(uint32_t));
+  }
+}
+
+/* ---- tiled raster ----------------------------------------------------------- */
+
+/*
+ * Replays a run of rect ops over a grid of screen tiles on a small worker pool.
+ * Ops are binned by bounding box in submission order and every pixel belongs
+ * to exactly one tile, so each pixel sees the same ops in the same order as a
+ * serial replay and the output is identical regardless of worker count.
+ * Not reentrant: one caller (the render thread) at a time.
+ */
+
+enum {
+  ChengGuiTileOpFill = 0,
+  ChengGuiTileOpBlend = 1,
+  ChengGuiTileOpRoundRect = 2
+};
+
+#define CHENG_GUI_TILE_MAX_WORKERS 32
+#define CHENG_GUI_TILE_SERIAL_PIXELS (1 << 16)
+
+typedef struct {
+  int32_t kind;
+  int32_t x;
+  int32_t y;
+  int32_t w;
+  int32_t h;
+  uint32_t color;
+  double radius;
+} ChengGuiTileOp;
+
+typedef struct {
+  int32_t tilesX;
+  int32_t tilesY;
+  int32_t tileSize;
+  int32_t workers;
+  int32_t ops;
+  int32_t binnedOps;
+  int32_t busyTiles;
+  int32_t reserved;
+  double binMs;
+  double rasterMs;
+  double maxTileMs;
+  double sumTileMs;
+} ChengGuiTileRasterStats;
+
+typedef struct {
+  uint8_t *pixels;
+  int width;
+  int height;
+  int strideBytes;
+  int tileSize;
+  int tilesX;
+  int tileCount;
+  const ChengGuiTileOp *ops;
+  const int32_t *binStart;
+  const int32_t *binOps;
+  double *tileMs;
+  int nextTile;
+  int doneTiles;
+} ChengGuiTileJob;
+
+static int32_t *gChengGuiTileBinStart = NULL;
+static int32_t *gChengGuiTileBinFill = NULL;
+static int32_t *gChengGuiTileBinOps = NULL;
+static double *gChengGuiTileCost = NULL;
+static size_t gChengGuiTileCap = 0;
+static size_t gChengGuiTileOpCap = 0;
+
+static double chengGuiTileNowMs(void) {
+#if defined(_WIN32)
+  return 0.0;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#endif
+}
+
+static void chengGuiTileRun(const ChengGuiTileJob *job, int tile) {
+  double start = chengGuiTileNowMs();
+  int tx0 = (tile % job->tilesX) * job->tileSize;
+  int ty0 = (tile / job->tilesX) * job->tileSize;
+  int tw = job->width - tx0 < job->tileSize ? job->width - tx0 : job->tileSize;
+  int th = job->height - ty0 < job->tileSize ? job->height - ty0 : job->tileSize;
+  /* The kernels clip to the canvas they are given, so a tile is just a view. */
+  uint8_t *view = job->pixels + (size_t)ty0 * (size_t)job->strideBytes + (size_t)tx0 * 4u;
+  for (int32_t i = job->binStart[tile]; i < job->binStart[tile + 1]; i++) {
+    const ChengGuiTileOp *op = &job->ops[job->binOps[i]];
+    int x = op->x - tx0;
+    int y = op->y - ty0;
+    switch (op->kind) {
+      case ChengGuiTileOpFill:
+        chengGuiKernelFillRect(view, tw, th, job->strideBytes, x, y, op->w, op->h, op->color);
+        break;
+      case ChengGuiTileOpRoundRect:
+        chengGuiKernelFillRoundRect(view, tw, th, job->strideBytes, x, y, op->w, op->h, op->radius, op->color);
+        break;
+      default:
+        chengGuiKernelBlendRect(view, tw, th, job->strideBytes, x, y, op->w, op->h, op->color);
+        break;
+    }
+  }
+  if (job->tileMs != NULL) job->tileMs[tile] = chengGuiTileNowMs() - start;
+}
+
+static void chengGuiTileDrain(ChengGuiTileJob *job) {
+  for (;;) {
+    int tile = __atomic_fetch_add(&job->nextTile, 1, __ATOMIC_RELAXED);
+    if (tile >= job->tileCount) return;
+    chengGuiTileRun(job, tile);
+    __atomic_fetch_add(&job->doneTiles, 1, __ATOMIC_RELEASE);
+  }
+}
+
+#if !defined(_WIN32)
+
+static pthread_mutex_t gChengGuiTilePoolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gChengGuiTilePoolWake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t gChengGuiTilePoolIdle = PTHREAD_COND_INITIALIZER;
+static pthread_t gChengGuiTileThreads[CHENG_GUI_TILE_MAX_WORKERS];
+static int gChengGuiTileThreadCount = 0;
+static ChengGuiTileJob *gChengGuiTileJob = NULL;
+static uint64_t gChengGuiTileGeneration = 0;
+static int gChengGuiTileActive = 0;
+static int gChengGuiTileWanted = 0;
+
+static void *chengGuiTileWorker(void *arg) {
+  int index = (int)(intptr_t)arg;
+  uint64_t seen = 0;
+  pthread_mutex_lock(&gChengGuiTilePoolLock);
+  for (;;) {
+    while (gChengGuiTileGeneration == seen) pthread_cond_wait(&gChengGuiTilePoolWake, &gChengGuiTilePoolLock);
+    seen = gChengGuiTileGeneration;
+    ChengGuiTileJob *job = gChengGuiTileJob;
+    if (job == NULL || index >= gChengGuiTileWanted) continue;
+    gChengGuiTileActive++;
+    pthread_mutex_unlock(&gChengGuiTilePoolLock);
+    chengGuiTileDrain(job);
+    pthread_mutex_lock(&gChengGuiTilePoolLock);
+    if (--gChengGuiTileActive == 0) pthread_cond_signal(&gChengGuiTilePoolIdle);
+  }
+  return NULL;
+}
+
+static int chengGuiTileCpuCount(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+
+/* Runs the job on the caller plus `helpers` pool threads and waits for all of them. */
+static void chengGuiTileDispatch(ChengGuiTileJob *job, int helpers) {
+  pthread_mutex_lock(&gChengGuiTilePoolLock);
+  while (gChengGuiTileThreadCount < helpers) {
+    if (pthread_create(&gChengGuiTileThreads[gChengGuiTileThreadCount], NULL, chengGuiTileWorker,
+                       (void *)(intptr_t)gChengGuiTileThreadCount) != 0) {
+      break;
+    }
+    pthread_detach(gChengGuiTileThreads[gChengGuiTileThreadCount]);
+    gChengGuiTileThreadCount++;
+  }
+  gChengGuiTileJob = job;
+  gChengGuiTileWanted = helpers;
+  gChengGuiTileGeneration++;
+  pthread_cond_broadcast(&gChengGuiTilePoolWake);
+  pthread_mutex_unlock(&gChengGuiTilePoolLock);
+  chengGuiTileDrain(job);
+  pthread_mutex_lock(&gChengGuiTilePoolLock);
+  /* Helpers that woke late find no tiles left; wait until none is still inside the job. */
+  while (gChengGuiTileActive > 0 || __atomic_load_n(&job->doneTiles, __ATOMIC_ACQUIRE) < job->tileCount) {
+    pthread_cond_wait(&gChengGuiTilePoolIdle, &gChengGuiTilePoolLock);
+  }
+  gChengGuiTileJob = NULL;
+  pthread_mutex_unlock(&gChengGuiTilePoolLock);
+}
+
+#else
+
+static int chengGuiTileCpuCount(void) {
+  return 1;
+}
+
+static void chengGuiTileDispatch(ChengGuiTileJob *job, int helpers) {
+  (void)helpers;
+  chengGuiTileDrain(job);
+}
+
+#endif
+
+static int chengGuiTileReserve(size_t tiles, size_t refs) {
+  if (tiles + 1 > gChengGuiTileCap) {
+    size_t cap = (tiles + 1) * 2;
+    int32_t *start = realloc(gChengGuiTileBinStart, cap * sizeof(int32_t));
+    if (start == NULL) return 0;
+    gChengGuiTileBinStart = start;
+    int32_t *fill = realloc(gChengGuiTileBinFill, cap * sizeof(int32_t));
+    if (fill == NULL) return 0;
+    gChengGuiTileBinFill = fill;
+    double *cost = realloc(gChengGuiTileCost, cap * sizeof(double));
+    if (cost == NULL) return 0;
+    gChengGuiTileCost = cost;
+    gChengGuiTileCap = cap;
+  }
+  if (refs > gChengGuiTileOpCap) {
+    size_t cap = refs * 2;
+    int32_t *ops = realloc(gChengGuiTileBinOps, cap * sizeof(int32_t));
+    if (ops == NULL) return 0;
+    gChengGuiTileBinOps = ops;
+    gChengGuiTileOpCap = cap;
+  }
+  return 1;
+}
+
+/* Tile range covered by an op, clipped to the canvas; 0 when it touches nothing. */
+static int chengGuiTileSpan(const ChengGuiTileOp *op, int width, int height, int tileSize,
+                            int *tx0, int *ty0, int *tx1, int *ty1) {
+  int x = op->x;
+  int y = op->y;
+  int w = op->w;
+  int h = op->h;
+  if ((op->color >> 24) == 0u && op->kind != ChengGuiTileOpFill) return 0;
+  if (!chengGuiKernelClip(width, height, &x, &y, &w, &h)) return 0;
+  *tx0 = x / tileSize;
+  *ty0 = y / tileSize;
+  *tx1 = (x + w - 1) / tileSize;
+  *ty1 = (y + h - 1) / tileSize;
+  return 1;
+}
+
+/*
+ * Rasterizes `ops` in order into the canvas. `workers` <= 0 means one per
+ * online CPU; small batches run on the calling thread. When `tileMs` is given
+ * it receives each tile's raster time (row-major, `tileMsCap` entries max).
+ * Returns the number of tiles, or -1 on bad arguments / allocation failure.
+ */
+KERNELS_EXPORT int32_t chengGuiTileRaster(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                          const ChengGuiTileOp *ops, int32_t opCount, int32_t tileSize,
+                                          int32_t workers, double *tileMs, int32_t tileMsCap,
+                                          ChengGuiTileRasterStats *stats) {
+  if (pixels == NULL || width <= 0 || height <= 0 || opCount < 0 || (opCount > 0 && ops == NULL)) return -1;
+  if (strideBytes <= 0) strideBytes = width * 4;
+  if (tileSize < 16) tileSize = 16;
+  double start = chengGuiTileNowMs();
+  int tilesX = (width + tileSize - 1) / tileSize;
+  int tilesY = (height + tileSize - 1) / tileSize;
+  int tileCount = tilesX * tilesY;
+  if (!chengGuiTileReserve((size_t)tileCount, 0)) return -1;
+  memset(gChengGuiTileBinFill, 0, (size_t)tileCount * sizeof(int32_t));
+  size_t refs = 0;
+  int64_t area = 0;
+  for (int32_t i = 0; i < opCount; i++) {
+    int tx0, ty0, tx1, ty1;
+    if (!chengGuiTileSpan(&ops[i], width, height, tileSize, &tx0, &ty0, &tx1, &ty1)) continue;
+    for (int ty = ty0; ty <= ty1; ty++) {
+      for (int tx = tx0; tx <= tx1; tx++) gChengGuiTileBinFill[ty * tilesX + tx]++;
+    }
+    refs += (size_t)(tx1 - tx0 + 1) * (size_t)(ty1 - ty0 + 1);
+    area += (int64_t)ops[i].w * ops[i].h;
+  }
+  if (!chengGuiTileReserve((size_t)tileCount, refs)) return -1;
+  int busy = 0;
+  gChengGuiTileBinStart[0] = 0;
+  for (int t = 0; t < tileCount; t++) {
+    if (gChengGuiTileBinFill[t] > 0) busy++;
+    gChengGuiTileBinStart[t + 1] = gChengGuiTileBinStart[t] + gChengGuiTileBinFill[t];
+    gChengGuiTileBinFill[t] = gChengGuiTileBinStart[t];
+  }
+  for (int32_t i = 0; i < opCount; i++) {
+    int tx0, ty0, tx1, ty1;
+    if (!chengGuiTileSpan(&ops[i], width, height, tileSize, &tx0, &ty0, &tx1, &ty1)) continue;
+    for (int ty = ty0; ty <= ty1; ty++) {
+      for (int tx = tx0; tx <= tx1; tx++) gChengGuiTileBinOps[gChengGuiTileBinFill[ty * tilesX + tx]++] = i;
+    }
+  }
+  double binned = chengGuiTileNowMs();
+
+  ChengGuiTileJob job;
+  job.pixels = (uint8_t *)pixels;
+  job.width = width;
+  job.height = height;
+  job.strideBytes = strideBytes;
+  job.tileSize = tileSize;
+  job.tilesX = tilesX;
+  job.tileCount = tileCount;
+  job.ops = ops;
+  job.binStart = gChengGuiTileBinStart;
+  job.binOps = gChengGuiTileBinOps;
+  job.tileMs = gChengGuiTileCost;
+  job.nextTile = 0;
+  job.doneTiles = 0;
+  memset(gChengGuiTileCost, 0, (size_t)tileCount * sizeof(double));
+  int threads = workers > 0 ? workers : chengGuiTileCpuCount();
+  if (threads > CHENG_GUI_TILE_MAX_WORKERS) threads = CHENG_GUI_TILE_MAX_WORKERS;
+  if (threads > busy) threads = busy;
+  if (area < CHENG_GUI_TILE_SERIAL_PIXELS || threads < 1) threads = 1;
+  if (threads > 1) chengGuiTileDispatch(&job, threads - 1);
+  else chengGuiTileDrain(&job);
+  double done = chengGuiTileNowMs();
+
+  if (tileMs != NULL && tileMsCap > 0) {
+    int n = tileCount < tileMsCap ? tileCount : tileMsCap;
+    memcpy(tileMs, gChengGuiTileCost, (size_t)n * sizeof(double));
+  }
+  if (stats != NULL) {
+    memset(stats, 0, sizeof(*stats));
+    stats->tilesX = tilesX;
+    stats->tilesY = tilesY;
+    stats->tileSize = tileSize;
+    stats->workers = threads;
+    stats->ops = opCount;
+    stats->binnedOps = (int32_t)refs;
+    stats->busyTiles = busy;
+    stats->binMs = binned - start;
+    stats->rasterMs = done - binned;
+    for (int t = 0; t < tileCount; t++) {
+      stats->sumTileMs += gChengGuiTileCost[t];
+      if (gChengGuiTileCost[t] > stats->maxTileMs) stats->maxTileMs = gChengGuiTileCost[t];
+    }
+  }
+  return tileCount;
+}
+
+KERNELS_EXPORT size_t chengGuiTileOpStructSize(void) {
+  return sizeof(ChengGuiTileOp);
+}
+
+KERNELS_EXPORT size_t chengGuiTileRasterStatsStructSize(void) {
+  return sizeof(ChengGuiTileRasterStats);
+}
+
+#ifdef CHENG_GUI_KERNELS_BENCH
+
+/*
+ * Microbenchmark and cross-check:
+ *   cc -O2 -DCHENG_GUI_KERNELS_BENCH render/pixel_kernels.c -lm -o pixel_kernels_bench
+ * Every available ISA is first compared byte-for-byte against scalar, then
+ * each kernel reports MPix/s on a 1920x1080 canvas, followed by an editor-like
+ * frame through the tiled raster, serial and with one worker per CPU.
+ * GUI_KERNELS_BENCH_MS sets the time spent per measurement (default 200).
+ */
+
+static double chengKernelBenchNowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static uint32_t gChengKernelBenchSeed = 0x9E3779B9u;
+
+static uint32_t chengKernelBenchRand(void) {
+  gChengKernelBenchSeed ^= gChengKernelBenchSeed << 13;
+  gChengKernelBenchSeed ^= gChengKernelBenchSeed >> 17;
+  gChengKernelBenchSeed ^= gChengKernelBenchSeed << 5;
+  return gChengKernelBenchSeed;
+}
+
+static void chengKernelBenchRandomize(uint32_t *pixels, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    uint32_t v = chengKernelBenchRand();
+    uint32_t pick = v & 7u;
+    if (pick == 0u) v &= 0x00FFFFFFu;
+    else if (pick == 1u) v |= 0xFF000000u;
+    pixels[i] = v;
+  }
+}
+
+static int chengKernelBenchCheck(int isa, int width, int height) {
+  size_t count = (size_t)width * (size_t)height;
+  uint32_t *base = malloc(count * 4);
+  uint32_t *src = malloc(count * 4);
+  uint8_t *mask = malloc(count);
+  uint32_t *expect = malloc(count * 4);
+  uint32_t *got = malloc(count * 4);
+  chengKernelBenchRandomize(base, count);
+  chengKernelBenchRandomize(src, count);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t v = chengKernelBenchRand();
+    mask[i] = (v & 3u) == 0u ? 0u : ((v & 3u) == 1u ? 255u : (uint8_t)(v >> 8));
+  }
+  const uint32_t colors[] = {0xFF336699u, 0x80FF0000u, 0x01ABCDEFu, 0xFE102030u, 0x00FFFFFFu};
+  int failures = 0;
+  for (int pass = 0; pass < 6; pass++) {
+    for (int c = 0; c < (int)(sizeof(colors) / sizeof(colors[0])); c++) {
+      uint32_t color = colors[c];
+      for (int which = 0; which < 2; which++) {
+        uint32_t *out = which == 0 ? expect : got;
+        chengGuiKernelsSelect(which == 0 ? ChengGuiKernelIsaScalar : isa);
+        memcpy(out, base, count * 4);
+        switch (pass) {
+          case 0: chengGuiKernelFillRect(out, width, height, width * 4, 3, 5, width - 7, height - 9, color); break;
+          case 1: chengGuiKernelBlendRect(out, width, height, width * 4, -4, 2, width - 1, height + 3, color); break;
+          case 2: chengGuiKernelFillRoundRect(out, width, height, width * 4, 1, 1, width - 3, height - 2, 9.5, color); break;
+          case 3: chengGuiKernelDrawPixels(out, width, height, width * 4, src, width, height, width * 4, 3, -2, 1); break;
+          case 4: chengGuiKernelDrawPixels(out, width, height, width * 4, src, width - 5, height, width * 4, 5, 1, 0); break;
+          default:
+            for (int row = 0; row < height; row++) {
+              chengGuiKernelBlendMaskRow(out + (size_t)row * (size_t)width + 1, mask + (size_t)row * (size_t)width,
+                                         width - 1, color);
+            }
+            break;
+        }
+      }
+      if (memcmp(expect, got, count * 4) != 0) {
+        size_t at = 0;
+        while (at < count && expect[at] == got[at]) at++;
+        fprintf(stderr, "[pixel-kernels] mismatch isa=%d pass=%d color=%08x at=%zu expect=%08x got=%08x\n",
+                isa, pass, color, at, expect[at], got[at]);
+        failures++;
+      }
+    }
+  }
+  free(base);
+  free(src);
+  free(mask);
+  free(expect);
+  free(got);
+  return failures;
+}
+
+typedef enum {
+  ChengKernelBenchFill,
+  ChengKernelBenchBlendSolid,
+  ChengKernelBenchRoundRect,
+  ChengKernelBenchBlendRow,
+  ChengKernelBenchBlendMask,
+  ChengKernelBenchCopyRows,
+  ChengKernelBenchCount
+} ChengKernelBenchKind;
+
+static const char *const gChengKernelBenchNames[ChengKernelBenchCount] = {
+  "fill", "blend_solid", "round_rect", "blend_row", "blend_mask", "copy_rows"
+};
+
+static double chengKernelBenchRun(ChengKernelBenchKind kind, uint32_t *canvas, const uint32_t *src,
+                                  const uint8_t *mask, int width, int height, double budgetMs) {
+  double start = chengKernelBenchNowMs();
+  double elapsed = 0.0;
+  int64_t pixels = 0;
+  int iter = 0;
+  while (elapsed < budgetMs || iter < 3) {
+    switch (kind) {
+      case ChengKernelBenchFill:
+        chengGuiKernelFillRect(canvas, width, height, width * 4, 0, 0, width, height, 0xFF202428u);
+        break;
+      case ChengKernelBenchBlendSolid:
+        chengGuiKernelBlendRect(canvas, width, height, width * 4, 0, 0, width, height, 0x80406080u);
+        break;
+      case ChengKernelBenchRoundRect:
+        chengGuiKernelFillRoundRect(canvas, width, height, width * 4, 0, 0, width, height, 24.0, 0xC0A0B0C0u);
+        break;
+      case ChengKernelBenchBlendRow:
+        chengGuiKernelDrawPixels(canvas, width, height, width * 4, src, width, height, width * 4, 0, 0, 1);
+        break;
+      case ChengKernelBenchBlendMask:
+        for (int row = 0; row < height; row++) {
+          chengGuiKernelBlendMaskRow(canvas + (size_t)row * (size_t)width, mask + (size_t)row * (size_t)width, width,
+                                     0xFFE0E0E0u);
+        }
+        break;
+      default:
+        chengGuiKernelDrawPixels(canvas, width, height, width * 4, src, width, height, width * 4, 0, 0, 0);
+        break;
+    }
+    pixels += (int64_t)width * height;
+    iter++;
+    elapsed = chengKernelBenchNowMs() - start;
+  }
+  return (double)pixels / (elapsed * 1000.0);
+}
+
+/* An editor-like frame: window fill, panels, line highlights, gutter marks,
+ * translucent selection and rounded widgets. */
+static int chengKernelBenchEditorOps(ChengGuiTileOp *ops, int cap, int width, int height) {
+  int n = 0;
+#define CHENG_BENCH_OP(k, X, Y, W, H, C, R) \
+  do { \
+    if (n < cap) { \
+      ops[n].kind = (k); ops[n].x = (X); ops[n].y = (Y); ops[n].w = (W); ops[n].h = (H); \
+      ops[n].color = (C); ops[n].radius = (R); n++; \
+    } \
+  } while (0)
+  CHENG_BENCH_OP(ChengGuiTileOpFill, 0, 0, width, height, 0xFF1E1E22u, 0.0);
+  CHENG_BENCH_OP(ChengGuiTileOpBlend, 0, 0, 280, height, 0xFF25262Bu, 0.0);
+  CHENG_BENCH_OP(ChengGuiTileOpBlend, 280, 0, width - 280, 36, 0xFF2D2E33u, 0.0);
+  for (int line = 0; line * 22 + 40 < height; line++) {
+    int y = 40 + line * 22;
+    if (line % 3 == 0) CHENG_BENCH_OP(ChengGuiTileOpBlend, 280, y, width - 280, 22, 0x14FFFFFFu, 0.0);
+    CHENG_BENCH_OP(ChengGuiTileOpBlend, 284, y + 6, 36, 10, 0xFF5A5D66u, 0.0);
+    CHENG_BENCH_OP(ChengGuiTileOpBlend, 340 + (line * 37) % 200, y + 4, 300 + (line * 53) % 700, 14, 0xFFB8BCC8u, 0.0);
+  }
+  CHENG_BENCH_OP(ChengGuiTileOpBlend, 600, 300, 520, 260, 0x553A7BD5u, 0.0);
+  for (int i = 0; i < 24; i++) {
+    CHENG_BENCH_OP(ChengGuiTileOpRoundRect, 12, 48 + i * 30, 256, 24, i % 5 == 0 ? 0xFF3A7BD5u : 0x30FFFFFFu, 6.0);
+  }
+  CHENG_BENCH_OP(ChengGuiTileOpRoundRect, width - 460, height - 220, 420, 180, 0xE0303238u, 12.0);
+#undef CHENG_BENCH_OP
+  return n;
+}
+
+static void chengKernelBenchSerialReplay(uint32_t *canvas, int width, int height, const ChengGuiTileOp *ops, int count) {
+  for (int i = 0; i < count; i++) {
+    const ChengGuiTileOp *op = &ops[i];
+    if (op->kind == ChengGuiTileOpFill) chengGuiKernelFillRect(canvas, width, height, width * 4, op->x, op->y, op->w, op->h, op->color);
+    else if (op->kind == ChengGuiTileOpRoundRect) chengGuiKernelFillRoundRect(canvas, width, height, width * 4, op->x, op->y, op->w, op->h, op->radius, op->color);
+    else chengGuiKernelBlendRect(canvas, width, height, width * 4, op->x, op->y, op->w, op->h, op->color);
+  }
+}
+
+/* Tiled output must equal the serial replay for any tile size and worker count. */
+static int chengKernelBenchTileCheck(const ChengGuiTileOp *ops, int count, int width, int height) {
+  size_t pixels = (size_t)width * (size_t)height;
+  uint32_t *expect = malloc(pixels * 4);
+  uint32_t *got = malloc(pixels * 4);
+  chengKernelBenchRandomize(expect, pixels);
+  memcpy(got, expect, pixels * 4);
+  chengKernelBenchSerialReplay(expect, width, height, ops, count);
+  static const int tileSizes[] = {16, 48, 128, 256};
+  static const int workerCounts[] = {1, 3, 8};
+  int failures = 0;
+  uint32_t *seed = malloc(pixels * 4);
+  memcpy(seed, got, pixels * 4);
+  for (size_t t = 0; t < sizeof(tileSizes) / sizeof(tileSizes[0]); t++) {
+    for (size_t w = 0; w < sizeof(workerCounts) / sizeof(workerCounts[0]); w++) {
+      memcpy(got, seed, pixels * 4);
+      chengGuiTileRaster(got, width, height, width * 4, ops, count, tileSizes[t], workerCounts[w], NULL, 0, NULL);
+      if (memcmp(expect, got, pixels * 4) != 0) {
+        fprintf(stderr, "[pixel-kernels] tiled raster mismatch tile=%d workers=%d\n", tileSizes[t], workerCounts[w]);
+        failures++;
+      }
+    }
+  }
+  free(seed);
+  free(expect);
+  free(got);
+  return failures;
+}
+
+static void chengKernelBenchTiles(uint32_t *canvas, int width, int height, double budgetMs) {
+  ChengGuiTileOp ops[512];
+  int count = chengKernelBenchEditorOps(ops, 512, width, height);
+  int cpus = chengGuiTileCpuCount();
+  double serialMs = 0.0;
+  for (int pass = 0; pass < 2; pass++) {
+    int workers = pass == 0 ? 1 : cpus;
+    double start = chengKernelBenchNowMs();
+    double elapsed = 0.0;
+    int frames = 0;
+    ChengGuiTileRasterStats stats;
+    while (elapsed < budgetMs || frames < 3) {
+      chengGuiTileRaster(canvas, width, height, width * 4, ops, count, 128, workers, NULL, 0, &stats);
+      frames++;
+      elapsed = chengKernelBenchNowMs() - start;
+    }
+    double frameMs = elapsed / (double)frames;
+    if (pass == 0) serialMs = frameMs;
+    printf("[pixel-kernels] tiled ops=%d tiles=%dx%d workers=%d frame_ms=%.3f speedup=%.2f max_tile_ms=%.3f bin_ms=%.3f\n",
+           count, stats.tilesX, stats.tilesY, stats.workers, frameMs, serialMs / frameMs, stats.maxTileMs, stats.binMs);
+  }
+}
+
+int main(void) {
+  const int width = 1920;
+  const int height = 1080;
+  double budgetMs = 200.0;
+  const char *budgetEnv = getenv("GUI_KERNELS_BENCH_MS");
+  if (budgetEnv != NULL && atof(budgetEnv) > 0.0) budgetMs = atof(budgetEnv);
+  int best = chengGuiKernelsDetect();
+  int failures = 0;
+  for (int isa = ChengGuiKernelIsaSse2; isa <= best; isa++) failures += chengKernelBenchCheck(isa, 67, 41);
+  {
+    ChengGuiTileOp ops[512];
+    int opCount = chengKernelBenchEditorOps(ops, 512, 701, 433);
+    failures += chengKernelBenchTileCheck(ops, opCount, 701, 433);
+  }
+  if (failures != 0) {
+    fprintf(stderr, "[pixel-kernels] %d cross-check failures\n", failures);
+    return 1;
+  }
+  size_t count = (size_t)width * (size_t)height;
+  uint32_t *canvas = malloc(count * 4);
+  uint32_t *src = malloc(count * 4);
+  uint8_t *mask = malloc(count);
+  chengKernelBenchRandomize(src, count);
+  for (size_t i = 0; i < count; i++) mask[i] = (uint8_t)(chengKernelBenchRand() >> 24);
+  static const char *const isaNames[] = {"scalar", "sse2", "avx2"};
+  printf("[pixel-kernels] canvas=%dx%d best=%s check=ok\n", width, height, isaNames[best]);
+  for (int isa = ChengGuiKernelIsaScalar; isa <= best; isa++) {
+    chengGuiKernelsSelect(isa);
+    for (int kind = 0; kind < ChengKernelBenchCount; kind++) {
+      chengKernelBenchRandomize(canvas, count);
+      double mpix = chengKernelBenchRun((ChengKernelBenchKind)kind, canvas, src, mask, width, height, budgetMs);
+      printf("[pixel-kernels] isa=%s kernel=%s mpix_per_s=%.1f\n", isaNames[isa], gChengKernelBenchNames[kind], mpix);
+    }
+  }
+  chengGuiKernelsSelect(best);
+  chengKernelBenchTiles(canvas, width, height, budgetMs);
+  free(canvas);
+  free(src);
+  free(mask);
+  return 0;
+}
+
+#endif
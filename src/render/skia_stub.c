@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
@@ -7,9 +8,58 @@
 #  define WIN32_LEAN_AND_MEAN
 #  include <windows.h>
 #else
-#  include <sys/time.h>
+#  include <time.h>
 #endif
 
+#include "bitmap_glyphs.h"
+
+/*
+ * Software stand-in for the Skia renderer. Draw calls between Begin and End
+ * are recorded into a picture (an op list plus a text arena); End replays the
+ * picture into an owned pixel buffer and, when the caller registered a target
+ * with chengSkiaRenderSetTarget, copies the result there. Pixels are 32-bit
+ * 0xAARRGGBB words like the Cheng canvas, and spans go through the shared
+ * kernels in pixel_kernels.c. Rects snap to pixels like the CPU raster in
+ * render/Backend.cheng, so rect-only frames come out byte-identical on any
+ * machine. Text uses the 5x7 bitmap font from bitmap_glyphs.h, which is not
+ * what the CPU path's native text draws; Backend keeps text frames on the CPU.
+ *
+ * Frame stats carry nanosecond timings: record (Begin to End), raster
+ * (replay) and flush (copy to the target).
+ */
+
+void chengGuiKernelFillRect(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                            int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+void chengGuiKernelBlendRect(void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                             int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+
+enum {
+  ChengSkiaOpRect = 0,
+  ChengSkiaOpText = 1
+};
+
+typedef struct {
+  int kind;
+  uint32_t color;
+  double x;
+  double y;
+  double w;
+  double h;
+  double fontSize;
+  uint32_t textOffset;
+  uint32_t textLength;
+} ChengSkiaOp;
+
+typedef struct {
+  ChengSkiaOp *ops;
+  int opCount;
+  int opCapacity;
+  char *text;
+  size_t textBytes;
+  size_t textCapacity;
+  double dpiScale;
+} ChengSkiaPicture;
+
 typedef struct {
   void *surface;
   int pixelWidth;
@@ -21,15 +71,33 @@ typedef struct {
   int commandCount;
   int rectCount;
   int textCount;
-  uint64_t frameStartMs;
+  uint64_t frameStartNs;
   int frameSerial;
+  ChengSkiaPicture picture;
+  uint32_t *pixels;
+  int bufferWidth;
+  int bufferHeight;
+  void *target;
+  int targetWidth;
+  int targetHeight;
+  int targetStrideBytes;
 } ChengSkiaRenderState;
 
+/* The first four fields are the original stats layout; Cheng checks the size
+ * through chengSkiaFrameStatsSize before reading the rest. */
 typedef struct {
   double gpuTimeMs;
   int commandCount;
   int rectCount;
   int textCount;
+  int frameSerial;
+  uint64_t recordNs;
+  uint64_t rasterNs;
+  uint64_t flushNs;
+  uint64_t totalNs;
+  int pixelWidth;
+  int pixelHeight;
+  uint64_t pictureBytes;
 } SkiaFrameStatsC;
 
 static int chengSkiaClampDimension(int value) {
@@ -59,13 +127,19 @@ static void chengSkiaCopyColorSpace(ChengSkiaRenderState *state,
   }
 }
 
-static uint64_t chengSkiaNowMs(void) {
+static uint64_t chengSkiaNowNs(void) {
 #ifdef _WIN32
-  return (uint64_t)GetTickCount64();
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (freq.QuadPart == 0) {
+    QueryPerformanceFrequency(&freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
 #else
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return (uint64_t)tv.tv_sec * 1000ULL + (uint64_t)(tv.tv_usec / 1000);
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 #endif
 }
 
@@ -73,6 +147,196 @@ static ChengSkiaRenderState *chengSkiaStateFrom(void *handle) {
   return (ChengSkiaRenderState *)handle;
 }
 
+/* ---- picture recording ------------------------------------------------------ */
+
+static ChengSkiaOp *chengSkiaPictureAppend(ChengSkiaPicture *picture) {
+  if (picture->opCount == picture->opCapacity) {
+    int capacity = picture->opCapacity < 64 ? 64 : picture->opCapacity * 2;
+    ChengSkiaOp *grown = (ChengSkiaOp *)realloc(picture->ops, (size_t)capacity * sizeof(ChengSkiaOp));
+    if (grown == NULL) {
+      return NULL;
+    }
+    picture->ops = grown;
+    picture->opCapacity = capacity;
+  }
+  ChengSkiaOp *op = &picture->ops[picture->opCount++];
+  memset(op, 0, sizeof(*op));
+  return op;
+}
+
+static bool chengSkiaPictureText(ChengSkiaPicture *picture, const char *text, size_t len,
+                                 uint32_t *offset) {
+  if (picture->textBytes + len > picture->textCapacity) {
+    size_t capacity = picture->textCapacity < 1024 ? 1024 : picture->textCapacity;
+    while (capacity < picture->textBytes + len) {
+      capacity *= 2;
+    }
+    char *grown = (char *)realloc(picture->text, capacity);
+    if (grown == NULL) {
+      return false;
+    }
+    picture->text = grown;
+    picture->textCapacity = capacity;
+  }
+  *offset = (uint32_t)picture->textBytes;
+  memcpy(picture->text + picture->textBytes, text, len);
+  picture->textBytes += len;
+  return true;
+}
+
+static uint32_t chengSkiaApplyOpacity(uint32_t color, double opacity) {
+  if (opacity >= 1.0) {
+    return color;
+  }
+  if (opacity <= 0.0) {
+    return color & 0x00FFFFFFu;
+  }
+  uint32_t alpha = (uint32_t)((double)(color >> 24) * opacity + 0.5);
+  return (color & 0x00FFFFFFu) | (alpha << 24);
+}
+
+/* ---- raster ----------------------------------------------------------------- */
+
+/* Logical edge to pixel edge: a pixel is covered when its center is inside. */
+static int chengSkiaPixelEdge(double logical, double scale) {
+  return (int)floor(logical * scale + 0.5);
+}
+
+/* Rects cover every pixel they touch, like toPixelRect in render/Backend.cheng. */
+static int chengSkiaRectEdgeLow(double logical, double scale) {
+  return (int)floor(logical * scale);
+}
+
+static int chengSkiaRectEdgeHigh(double logical, double scale) {
+  return (int)ceil(logical * scale);
+}
+
+static int chengSkiaGlyphScale(double pixelFontSize) {
+  if (pixelFontSize >= 22.0) {
+    return 3;
+  }
+  if (pixelFontSize >= 14.0) {
+    return 2;
+  }
+  return 1;
+}
+
+static void chengSkiaBlitGlyph(void *pixels, int width, int height, int strideBytes,
+                               int x, int y, int scale, uint64_t mask, uint32_t color) {
+  int row = 0;
+  while (row < ChengGlyph5x7Rows) {
+    uint32_t bits = (uint32_t)(mask >> (row * ChengGlyph5x7BitsPerRow)) & 0xFFu;
+    int next = row + 1;
+    while (next < ChengGlyph5x7Rows &&
+           ((uint32_t)(mask >> (next * ChengGlyph5x7BitsPerRow)) & 0xFFu) == bits) {
+      next++;
+    }
+    int col = 0;
+    while (bits != 0u) {
+      while ((bits & 1u) == 0u) {
+        bits >>= 1;
+        col++;
+      }
+      int span = 0;
+      while ((bits & 1u) != 0u) {
+        bits >>= 1;
+        span++;
+      }
+      chengGuiKernelBlendRect(pixels, width, height, strideBytes, x + col * scale, y + row * scale,
+                              span * scale, (next - row) * scale, color);
+      col += span;
+    }
+    row = next;
+  }
+}
+
+/* Lays text out in its box like render/text_bitmap.cheng: wrap at the right
+ * edge, stop at the bottom, one '?' per non-ASCII code point. */
+static void chengSkiaRasterText(const ChengSkiaPicture *picture, const ChengSkiaOp *op,
+                                void *pixels, int width, int height, int strideBytes) {
+  double scale = picture->dpiScale;
+  int boxX = chengSkiaPixelEdge(op->x, scale);
+  int boxY = chengSkiaPixelEdge(op->y, scale);
+  int boxW = chengSkiaPixelEdge(op->x + op->w, scale) - boxX;
+  int boxH = chengSkiaPixelEdge(op->y + op->h, scale) - boxY;
+  if (boxW <= 0 || boxH <= 0 || (op->color >> 24) == 0u) {
+    return;
+  }
+  int glyphScale = chengSkiaGlyphScale(op->fontSize * scale);
+  int glyphW = ChengGlyph5x7Cols * glyphScale;
+  int glyphH = ChengGlyph5x7Rows * glyphScale;
+  int advance = glyphW + glyphScale;
+  int cursorX = 0;
+  int cursorY = 0;
+  const unsigned char *text = (const unsigned char *)picture->text + op->textOffset;
+  for (uint32_t i = 0; i < op->textLength; i++) {
+    unsigned char ch = text[i];
+    if (ch >= 0x80u && ch < 0xC0u) {
+      continue; /* UTF-8 continuation byte */
+    }
+    if (ch == '\r') {
+      continue;
+    }
+    if (ch == '\n') {
+      cursorX = 0;
+      cursorY += glyphH + glyphScale;
+      if (cursorY + glyphH > boxH) {
+        return;
+      }
+      continue;
+    }
+    if (cursorX + glyphW > boxW) {
+      cursorX = 0;
+      cursorY += glyphH + glyphScale;
+    }
+    if (cursorY + glyphH > boxH) {
+      return;
+    }
+    uint64_t mask = chengGlyph5x7[ch < 0x80u ? ch : (unsigned char)'?'];
+    chengSkiaBlitGlyph(pixels, width, height, strideBytes, boxX + cursorX, boxY + cursorY, glyphScale,
+                       mask, op->color);
+    cursorX += advance;
+  }
+}
+
+static void chengSkiaRasterPicture(const ChengSkiaPicture *picture, void *pixels, int width,
+                                   int height, int strideBytes) {
+  chengGuiKernelFillRect(pixels, width, height, strideBytes, 0, 0, width, height, 0u);
+  double scale = picture->dpiScale;
+  for (int i = 0; i < picture->opCount; i++) {
+    const ChengSkiaOp *op = &picture->ops[i];
+    if (op->kind == ChengSkiaOpRect) {
+      int x0 = chengSkiaRectEdgeLow(op->x, scale);
+      int y0 = chengSkiaRectEdgeLow(op->y, scale);
+      int x1 = chengSkiaRectEdgeHigh(op->x + op->w, scale);
+      int y1 = chengSkiaRectEdgeHigh(op->y + op->h, scale);
+      if (x1 > x0 && y1 > y0) {
+        chengGuiKernelBlendRect(pixels, width, height, strideBytes, x0, y0, x1 - x0, y1 - y0, op->color);
+      }
+    } else if (op->kind == ChengSkiaOpText) {
+      chengSkiaRasterText(picture, op, pixels, width, height, strideBytes);
+    }
+  }
+}
+
+static bool chengSkiaEnsureBuffer(ChengSkiaRenderState *state) {
+  if (state->pixels != NULL && state->bufferWidth == state->pixelWidth &&
+      state->bufferHeight == state->pixelHeight) {
+    return true;
+  }
+  size_t bytes = (size_t)state->pixelWidth * (size_t)state->pixelHeight * sizeof(uint32_t);
+  uint32_t *grown = (uint32_t *)realloc(state->pixels, bytes);
+  if (grown == NULL) {
+    return false;
+  }
+  state->pixels = grown;
+  state->bufferWidth = state->pixelWidth;
+  state->bufferHeight = state->pixelHeight;
+  return true;
+}
+
+/* ---- ABI -------------------------------------------------------------------- */
+
 void *chengSkiaRenderCreate(void *surface,
                             int width,
                             int height,
@@ -90,8 +354,9 @@ void *chengSkiaRenderCreate(void *surface,
   state->logicalHeight = (double)state->pixelHeight;
   state->dpiScale = dpiScale > 0.0 ? dpiScale : 1.0;
   chengSkiaCopyColorSpace(state, colorSpace);
-  state->frameStartMs = 0;
+  state->frameStartNs = 0;
   state->frameSerial = 0;
+  state->picture.dpiScale = state->dpiScale;
   return state;
 }
 
@@ -100,6 +365,9 @@ void chengSkiaRenderDestroy(void *handle) {
   if (state == NULL) {
     return;
   }
+  free(state->picture.ops);
+  free(state->picture.text);
+  free(state->pixels);
   free(state);
 }
 
@@ -112,6 +380,19 @@ void chengSkiaRenderResize(void *handle, int width, int height) {
   state->pixelHeight = chengSkiaClampDimension(height);
 }
 
+/* Pixels written by End are also copied into `pixels` (0xAARRGGBB rows,
+ * clipped to both sizes). Pass NULL to stop copying. */
+void chengSkiaRenderSetTarget(void *handle, void *pixels, int width, int height, int strideBytes) {
+  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
+  if (state == NULL) {
+    return;
+  }
+  state->target = pixels;
+  state->targetWidth = width;
+  state->targetHeight = height;
+  state->targetStrideBytes = strideBytes;
+}
+
 void chengSkiaRenderBegin(void *handle,
                           double logicalWidth,
                           double logicalHeight,
@@ -128,7 +409,10 @@ void chengSkiaRenderBegin(void *handle,
   state->commandCount = 0;
   state->rectCount = 0;
   state->textCount = 0;
-  state->frameStartMs = chengSkiaNowMs();
+  state->picture.opCount = 0;
+  state->picture.textBytes = 0;
+  state->picture.dpiScale = state->dpiScale;
+  state->frameStartNs = chengSkiaNowNs();
 }
 
 void chengSkiaRenderDrawRect(void *handle,
@@ -142,14 +426,59 @@ void chengSkiaRenderDrawRect(void *handle,
   if (state == NULL) {
     return;
   }
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)opacity;
   state->commandCount += 1;
   state->rectCount += 1;
+  if (w <= 0.0 || h <= 0.0) {
+    return;
+  }
+  ChengSkiaOp *op = chengSkiaPictureAppend(&state->picture);
+  if (op == NULL) {
+    return;
+  }
+  op->kind = ChengSkiaOpRect;
+  op->color = chengSkiaApplyOpacity(color, opacity);
+  op->x = x;
+  op->y = y;
+  op->w = w;
+  op->h = h;
+}
+
+void chengSkiaRenderDrawTextLen(void *handle,
+                                double x,
+                                double y,
+                                double w,
+                                double h,
+                                uint32_t color,
+                                double fontSize,
+                                double opacity,
+                                const char *text,
+                                int textLen) {
+  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
+  if (state == NULL) {
+    return;
+  }
+  state->commandCount += 1;
+  state->textCount += 1;
+  if (text == NULL || textLen <= 0) {
+    return;
+  }
+  uint32_t offset = 0;
+  if (!chengSkiaPictureText(&state->picture, text, (size_t)textLen, &offset)) {
+    return;
+  }
+  ChengSkiaOp *op = chengSkiaPictureAppend(&state->picture);
+  if (op == NULL) {
+    return;
+  }
+  op->kind = ChengSkiaOpText;
+  op->color = chengSkiaApplyOpacity(color, opacity);
+  op->x = x;
+  op->y = y;
+  op->w = w;
+  op->h = h;
+  op->fontSize = fontSize;
+  op->textOffset = offset;
+  op->textLength = (uint32_t)textLen;
 }
 
 void chengSkiaRenderDrawText(void *handle,
@@ -161,20 +490,8 @@ void chengSkiaRenderDrawText(void *handle,
                              double fontSize,
                              double opacity,
                              const char *text) {
-  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
-  if (state == NULL) {
-    return;
-  }
-  (void)x;
-  (void)y;
-  (void)w;
-  (void)h;
-  (void)color;
-  (void)fontSize;
-  (void)opacity;
-  (void)text;
-  state->commandCount += 1;
-  state->textCount += 1;
+  int len = text == NULL ? 0 : (int)strlen(text);
+  chengSkiaRenderDrawTextLen(handle, x, y, w, h, color, fontSize, opacity, text, len);
 }
 
 void chengSkiaRenderEnd(void *handle, SkiaFrameStatsC *outStats) {
@@ -182,21 +499,274 @@ void chengSkiaRenderEnd(void *handle, SkiaFrameStatsC *outStats) {
   if (state == NULL) {
     return;
   }
-  uint64_t nowMs = chengSkiaNowMs();
-  double elapsed = 0.0;
-  if (state->frameStartMs != 0 && nowMs >= state->frameStartMs) {
-    elapsed = (double)(nowMs - state->frameStartMs);
+  uint64_t recordEnd = chengSkiaNowNs();
+  uint64_t recordNs = 0;
+  if (state->frameStartNs != 0 && recordEnd >= state->frameStartNs) {
+    recordNs = recordEnd - state->frameStartNs;
+  }
+  uint64_t rasterNs = 0;
+  uint64_t flushNs = 0;
+  if (chengSkiaEnsureBuffer(state)) {
+    int stride = state->bufferWidth * 4;
+    chengSkiaRasterPicture(&state->picture, state->pixels, state->bufferWidth, state->bufferHeight, stride);
+    uint64_t rasterEnd = chengSkiaNowNs();
+    rasterNs = rasterEnd - recordEnd;
+    if (state->target != NULL && state->targetWidth > 0 && state->targetHeight > 0) {
+      int w = state->targetWidth < state->bufferWidth ? state->targetWidth : state->bufferWidth;
+      int h = state->targetHeight < state->bufferHeight ? state->targetHeight : state->bufferHeight;
+      for (int row = 0; row < h; row++) {
+        memcpy((char *)state->target + (size_t)row * (size_t)state->targetStrideBytes,
+               state->pixels + (size_t)row * (size_t)state->bufferWidth, (size_t)w * sizeof(uint32_t));
+      }
+      flushNs = chengSkiaNowNs() - rasterEnd;
+    }
   }
   state->frameSerial += 1;
   if (outStats != NULL) {
-    outStats->gpuTimeMs = elapsed;
+    uint64_t totalNs = recordNs + rasterNs + flushNs;
+    outStats->gpuTimeMs = (double)totalNs / 1e6;
     outStats->commandCount = state->commandCount;
     outStats->rectCount = state->rectCount;
     outStats->textCount = state->textCount;
+    outStats->frameSerial = state->frameSerial;
+    outStats->recordNs = recordNs;
+    outStats->rasterNs = rasterNs;
+    outStats->flushNs = flushNs;
+    outStats->totalNs = totalNs;
+    outStats->pixelWidth = state->bufferWidth;
+    outStats->pixelHeight = state->bufferHeight;
+    outStats->pictureBytes = (uint64_t)state->picture.opCount * sizeof(ChengSkiaOp) + state->picture.textBytes;
   }
   state->commandCount = 0;
   state->rectCount = 0;
   state->textCount = 0;
-  state->frameStartMs = 0;
+  state->frameStartNs = 0;
+}
+
+size_t chengSkiaFrameStatsSize(void) {
+  return sizeof(SkiaFrameStatsC);
+}
+
+/* The buffer End rasterized into; valid until the next End, Resize or
+ * Destroy. Rows are width * 4 bytes apart. */
+const uint32_t *chengSkiaRenderPixels(void *handle, int *width, int *height) {
+  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
+  if (width != NULL) {
+    *width = state == NULL ? 0 : state->bufferWidth;
+  }
+  if (height != NULL) {
+    *height = state == NULL ? 0 : state->bufferHeight;
+  }
+  return state == NULL ? NULL : state->pixels;
+}
+
+/* Replays the last recorded picture into any buffer; 0 when there is none. */
+int chengSkiaRenderReplay(void *handle, void *pixels, int width, int height, int strideBytes) {
+  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
+  if (state == NULL || pixels == NULL || width <= 0 || height <= 0 || state->frameSerial == 0) {
+    return 0;
+  }
+  chengSkiaRasterPicture(&state->picture, pixels, width, height, strideBytes);
+  return 1;
+}
+
+/* FNV-1a over the rasterized pixels, for comparing output across runs and
+ * machines. */
+uint64_t chengSkiaRenderPixelHash(void *handle) {
+  ChengSkiaRenderState *state = chengSkiaStateFrom(handle);
+  uint64_t hash = 1469598103934665603ULL;
+  if (state == NULL || state->pixels == NULL) {
+    return hash;
+  }
+  size_t count = (size_t)state->bufferWidth * (size_t)state->bufferHeight;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t px = state->pixels[i];
+    for (int b = 0; b < 4; b++) {
+      hash ^= (px >> (b * 8)) & 0xFFu;
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+#ifdef CHENG_GUI_SKIA_STUB_TEST
+
+#include <stdio.h>
+
+/*
+ * Self-test:
+ *   cc -O2 -DCHENG_GUI_SKIA_STUB_TEST render/skia_stub.c render/pixel_kernels.c -lm -lpthread
+ * Records small frames and checks rect coverage (including fractional
+ * edges), blending against the shared kernel, text placement and clipping,
+ * the copy into a bound target, replay and the pixel hash.
+ */
+
+static int gChengSkiaTestFailures = 0;
+
+static void chengSkiaTestExpect(int ok, const char *what) {
+  if (!ok) {
+    fprintf(stderr, "skia_stub: FAIL %s\n", what);
+    gChengSkiaTestFailures++;
+  }
+}
+
+static uint32_t chengSkiaTestAt(void *handle, int x, int y) {
+  int width = 0;
+  int height = 0;
+  const uint32_t *pixels = chengSkiaRenderPixels(handle, &width, &height);
+  if (pixels == NULL || x < 0 || y < 0 || x >= width || y >= height) {
+    return 0xDEADBEEFu;
+  }
+  return pixels[(size_t)y * (size_t)width + (size_t)x];
+}
+
+static void chengSkiaTestRects(void) {
+  void *handle = chengSkiaRenderCreate(NULL, 64, 48, 2.0, "srgb");
+  chengSkiaRenderBegin(handle, 32.0, 24.0, 2.0, "srgb");
+  chengSkiaRenderDrawRect(handle, 4.0, 4.0, 8.0, 6.0, 0xFF102030u, 1.0);
+  chengSkiaRenderDrawRect(handle, 20.0, 4.0, 0.0, 6.0, 0xFFFFFFFFu, 1.0);
+  SkiaFrameStatsC stats;
+  memset(&stats, 0, sizeof(stats));
+  chengSkiaRenderEnd(handle, &stats);
+  chengSkiaTestExpect(stats.commandCount == 2 && stats.rectCount == 2, "rect stats count every call");
+  chengSkiaTestExpect(stats.pixelWidth == 64 && stats.pixelHeight == 48, "stats carry the buffer size");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 8, 8) == 0xFF102030u, "rect covers its first pixel");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 23, 19) == 0xFF102030u, "rect covers its last pixel");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 24, 19) == 0u, "rect stops at its right edge");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 8, 20) == 0u, "rect stops at its bottom edge");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 7, 8) == 0u, "background is cleared");
+  chengSkiaRenderDestroy(handle);
+
+  /* Fractional edges cover every touched pixel, as the CPU raster does. */
+  handle = chengSkiaRenderCreate(NULL, 16, 16, 1.0, "srgb");
+  chengSkiaRenderBegin(handle, 16.0, 16.0, 1.0, "srgb");
+  chengSkiaRenderDrawRect(handle, 2.25, 3.75, 4.5, 1.5, 0xFF405060u, 1.0);
+  chengSkiaRenderEnd(handle, NULL);
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 2, 3) == 0xFF405060u, "fractional rect covers its first touched pixel");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 6, 5) == 0xFF405060u, "fractional rect covers its last touched pixel");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 7, 5) == 0u && chengSkiaTestAt(handle, 2, 6) == 0u,
+                      "fractional rect stops past its touched pixels");
+  chengSkiaRenderDestroy(handle);
+}
+
+static void chengSkiaTestBlend(void) {
+  void *handle = chengSkiaRenderCreate(NULL, 8, 8, 1.0, "srgb");
+  chengSkiaRenderBegin(handle, 8.0, 8.0, 1.0, "srgb");
+  chengSkiaRenderDrawRect(handle, 0.0, 0.0, 8.0, 8.0, 0xFF0000FFu, 1.0);
+  chengSkiaRenderDrawRect(handle, 2.0, 2.0, 4.0, 4.0, 0xFFFF0000u, 0.5);
+  chengSkiaRenderDrawRect(handle, 0.0, 6.0, 8.0, 2.0, 0xFF00FF00u, 0.0);
+  chengSkiaRenderEnd(handle, NULL);
+  uint32_t expect = 0xFF0000FFu;
+  chengGuiKernelBlendRect(&expect, 1, 1, 4, 0, 0, 1, 1, chengSkiaApplyOpacity(0xFFFF0000u, 0.5));
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 3, 3) == expect, "half opacity blends like the kernel");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 1, 1) == 0xFF0000FFu, "blend stays inside its rect");
+  chengSkiaTestExpect(chengSkiaTestAt(handle, 3, 7) == 0xFF0000FFu, "zero opacity draws nothing");
+  chengSkiaRenderDestroy(handle);
+}
+
+static int chengSkiaTestCountLit(void *handle, int x0, int y0, int x1, int y1, uint32_t color) {
+  int count = 0;
+  for (int y = y0; y < y1; y++) {
+    for (int x = x0; x < x1; x++) {
+      if (chengSkiaTestAt(handle, x, y) == color) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+static void chengSkiaTestText(void) {
+  const uint32_t ink = 0xFFFFFFFFu;
+  void *handle = chengSkiaRenderCreate(NULL, 64, 32, 1.0, "srgb");
+  chengSkiaRenderBegin(handle, 64.0, 32.0, 1.0, "srgb");
+  chengSkiaRenderDrawText(handle, 2.0, 2.0, 12.0, 12.0, ink, 12.0, 1.0, "H");
+  chengSkiaRenderDrawTextLen(handle, 20.0, 2.0, 12.0, 12.0, ink, 12.0, 1.0, "\xE4\xB8\xAD", 3);
+  chengSkiaRenderDrawText(handle, 40.0, 2.0, 12.0, 12.0, ink, 12.0, 1.0, "?");
+  chengSkiaRenderDrawText(handle, 2.0, 20.0, 8.0, 8.0, ink, 12.0, 1.0, "WWWW");
+  SkiaFrameStatsC stats;
+  memset(&stats, 0, sizeof(stats));
+  chengSkiaRenderEnd(handle, &stats);
+  chengSkiaTestExpect(stats.textCount == 4, "text stats count every call");
+  uint64_t mask = chengGlyph5x7['H'];
+  int expectLit = 0;
+  for (int row = 0; row < ChengGlyph5x7Rows; row++) {
+    uint32_t bits = (uint32_t)(mask >> (row * ChengGlyph5x7BitsPerRow)) & 0xFFu;
+    for (int col = 0; col < ChengGlyph5x7Cols; col++) {
+      expectLit += (bits >> col) & 1u;
+    }
+  }
+  chengSkiaTestExpect(chengSkiaTestCountLit(handle, 0, 0, 18, 18, ink) == expectLit, "glyph matches the bitmap font");
+  int wide = chengSkiaTestCountLit(handle, 18, 0, 38, 18, ink);
+  int question = chengSkiaTestCountLit(handle, 38, 0, 58, 18, ink);
+  chengSkiaTestExpect(wide > 0 && wide == question, "non-ASCII draws one '?'");
+  chengSkiaTestExpect(chengSkiaTestCountLit(handle, 0, 28, 64, 32, ink) == 0, "text stops at its box");
+  chengSkiaTestExpect(chengSkiaTestCountLit(handle, 10, 18, 64, 32, ink) == 0, "text wraps inside its box");
+  chengSkiaRenderDestroy(handle);
+}
+
+static void chengSkiaTestTargetReplayHash(void) {
+  void *a = chengSkiaRenderCreate(NULL, 16, 16, 1.0, "srgb");
+  void *b = chengSkiaRenderCreate(NULL, 16, 16, 1.0, "srgb");
+  chengSkiaTestExpect(chengSkiaRenderReplay(a, (uint32_t[1]){0}, 1, 1, 4) == 0, "replay needs a recorded frame");
+  const int targetW = 12;
+  const int targetH = 10;
+  const int stride = 20 * 4;
+  uint32_t target[20 * 10];
+  for (int i = 0; i < 20 * 10; i++) {
+    target[i] = 0x12345678u;
+  }
+  chengSkiaRenderSetTarget(a, target, targetW, targetH, stride);
+  void *handles[2] = {a, b};
+  for (int i = 0; i < 2; i++) {
+    chengSkiaRenderBegin(handles[i], 16.0, 16.0, 1.0, "srgb");
+    chengSkiaRenderDrawRect(handles[i], 0.0, 0.0, 16.0, 16.0, 0xFF202020u, 1.0);
+    chengSkiaRenderDrawRect(handles[i], 3.0, 3.0, 10.0, 5.0, 0x80FF8000u, 1.0);
+    chengSkiaRenderDrawText(handles[i], 1.0, 9.0, 14.0, 7.0, 0xFFFFFFFFu, 10.0, 1.0, "ok");
+    chengSkiaRenderEnd(handles[i], NULL);
+  }
+  int width = 0;
+  int height = 0;
+  const uint32_t *pixels = chengSkiaRenderPixels(a, &width, &height);
+  int copied = 1;
+  for (int y = 0; y < targetH; y++) {
+    for (int x = 0; x < 20; x++) {
+      uint32_t want = x < targetW ? pixels[y * width + x] : 0x12345678u;
+      copied &= target[y * 20 + x] == want;
+    }
+  }
+  chengSkiaTestExpect(copied, "End copies into the target and leaves the stride padding alone");
+
+  uint32_t replay[16 * 16];
+  memset(replay, 0, sizeof(replay));
+  chengSkiaTestExpect(chengSkiaRenderReplay(a, replay, 16, 16, 16 * 4) == 1, "replay draws the last frame");
+  chengSkiaTestExpect(memcmp(replay, pixels, sizeof(replay)) == 0, "replay matches End byte for byte");
+
+  uint64_t hashA = chengSkiaRenderPixelHash(a);
+  chengSkiaTestExpect(hashA == chengSkiaRenderPixelHash(b), "same frame hashes the same");
+
+  chengSkiaRenderSetTarget(a, NULL, 0, 0, 0);
+  chengSkiaRenderBegin(a, 16.0, 16.0, 1.0, "srgb");
+  chengSkiaRenderDrawRect(a, 0.0, 0.0, 16.0, 16.0, 0xFF202020u, 1.0);
+  chengSkiaRenderDrawRect(a, 3.0, 3.0, 10.0, 5.0, 0x80FF8001u, 1.0);
+  chengSkiaRenderEnd(a, NULL);
+  chengSkiaTestExpect(chengSkiaRenderPixelHash(a) != hashA, "a changed frame hashes differently");
+  chengSkiaTestExpect(target[0] == replay[0], "an unbound target is left alone");
+  chengSkiaRenderDestroy(a);
+  chengSkiaRenderDestroy(b);
+}
+
+int main(void) {
+  chengSkiaTestRects();
+  chengSkiaTestBlend();
+  chengSkiaTestText();
+  chengSkiaTestTargetReplayHash();
+  if (gChengSkiaTestFailures > 0) {
+    fprintf(stderr, "skia_stub: %d check(s) failed\n", gChengSkiaTestFailures);
+    return 1;
+  }
+  printf("skia_stub: ok\n");
+  return 0;
 }
 
+#endif /* CHENG_GUI_SKIA_STUB_TEST */
@@ -0,0 +1,1280 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "snapshot_writer.h"
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
+/*
+ * Frame snapshots off the render thread.
+ *
+ * chengGuiSnapshotWriterSubmit copies a 0xAARRGGBB frame into one of a few
+ * pooled buffers and returns. A background thread hashes the copy, skips it
+ * when it matches the last snapshot written (same size, format and pixels),
+ * and otherwise encodes and writes it as
+ *
+ *   PNG   8-bit RGB, or RGBA when any pixel is not opaque. Each row is
+ *         filtered with the cheapest of None/Sub/Up/Paeth (minimum sum of
+ *         absolute differences), then deflated with greedy LZ77 and dynamic
+ *         Huffman blocks. Row stripes are filtered and compressed in parallel;
+ *         every stripe ends in a sync flush, so the stripes concatenate into
+ *         one zlib stream and only their Adler-32s need combining.
+ *   RGBA  raw R,G,B,A bytes (the .rgba.out dumps).
+ *   PPM   binary P6, alpha dropped.
+ *
+ * When every pool buffer is still queued, a submit either waits for one
+ * (ChengGuiSnapshotFlagBlock; the wait is reported as waitNs) or drops the
+ * frame. Windows has no writer thread: submits encode synchronously.
+ *
+ * GUI_SNAPSHOT_WORKERS caps the stripe threads per image (default one per CPU,
+ * at most 8). Built with -DCHENG_GUI_SNAPSHOT_MAIN this file is also a native
+ * replacement for scripts/convert_rgba_out_to_png.py:
+ *   cc -O2 -DCHENG_GUI_SNAPSHOT_MAIN render/snapshot_writer.c -lpthread -o snapshot_writer
+ *   snapshot_writer --in frame.rgba.out --out frame.png --width W --height H
+ */
+
+#if defined(_WIN32)
+#  define SNAPSHOT_EXPORT __declspec(dllexport)
+#  define CHENG_SNAPSHOT_THREADS 0
+#else
+#  define SNAPSHOT_EXPORT __attribute__((visibility("default")))
+#  define CHENG_SNAPSHOT_THREADS 1
+#endif
+
+#define CHENG_SNAPSHOT_MAX_POOL 8
+#define CHENG_SNAPSHOT_DEFAULT_POOL 4
+#define CHENG_SNAPSHOT_MAX_STRIPES 8
+#define CHENG_SNAPSHOT_MIN_STRIPE_ROWS 32
+#define CHENG_SNAPSHOT_PATH_MAX 1024
+#define CHENG_SNAPSHOT_WINDOW 32768
+#define CHENG_SNAPSHOT_HASH_BITS 15
+#define CHENG_SNAPSHOT_BLOCK_TOKENS 32768
+
+static uint64_t chengSnapshotNowNs(void) {
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (freq.QuadPart == 0) {
+    QueryPerformanceFrequency(&freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* ---- checksums ------------------------------------------------------------- */
+
+static const uint32_t kChengSnapshotCrcNibble[16] = {
+  0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+  0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+};
+
+/* Running CRC-32 without the final inversion; start from 0xFFFFFFFF. */
+static uint32_t chengSnapshotCrcUpdate(uint32_t crc, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ kChengSnapshotCrcNibble[crc & 15u];
+    crc = (crc >> 4) ^ kChengSnapshotCrcNibble[crc & 15u];
+  }
+  return crc;
+}
+
+#define CHENG_SNAPSHOT_ADLER_BASE 65521u
+
+static uint32_t chengSnapshotAdler(const uint8_t *data, size_t len) {
+  uint32_t a = 1u;
+  uint32_t b = 0u;
+  while (len > 0) {
+    /* 5552 is the longest run before b can overflow 32 bits. */
+    size_t chunk = len < 5552u ? len : 5552u;
+    len -= chunk;
+    for (size_t i = 0; i < chunk; i++) {
+      a += data[i];
+      b += a;
+    }
+    data += chunk;
+    a %= CHENG_SNAPSHOT_ADLER_BASE;
+    b %= CHENG_SNAPSHOT_ADLER_BASE;
+  }
+  return (b << 16) | a;
+}
+
+/* Adler-32 of A followed by B, given both sums and B's length. */
+static uint32_t chengSnapshotAdlerCombine(uint32_t adlerA, uint32_t adlerB, size_t lenB) {
+  const uint32_t base = CHENG_SNAPSHOT_ADLER_BASE;
+  uint32_t rem = (uint32_t)(lenB % base);
+  uint32_t a = adlerA & 0xFFFFu;
+  uint32_t b = (uint32_t)(((uint64_t)rem * a) % base);
+  uint32_t sumA = a + (adlerB & 0xFFFFu) + base - 1u;
+  uint32_t sumB = (adlerA >> 16) + (adlerB >> 16) + base - rem + b;
+  if (sumA >= base) sumA -= base;
+  if (sumA >= base) sumA -= base;
+  if (sumB >= 2u * base) sumB -= 2u * base;
+  if (sumB >= base) sumB -= base;
+  return (sumB << 16) | sumA;
+}
+
+/* ---- byte and bit output --------------------------------------------------- */
+
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+} ChengSnapshotBytes;
+
+static bool chengSnapshotReserve(ChengSnapshotBytes *bytes, size_t extra) {
+  if (bytes->len + extra <= bytes->cap) return true;
+  size_t cap = bytes->cap * 2;
+  if (cap < bytes->len + extra) cap = bytes->len + extra;
+  if (cap < 4096) cap = 4096;
+  uint8_t *grown = (uint8_t *)realloc(bytes->data, cap);
+  if (grown == NULL) return false;
+  bytes->data = grown;
+  bytes->cap = cap;
+  return true;
+}
+
+/* LSB-first deflate bit writer; callers reserve room before each block. */
+typedef struct {
+  ChengSnapshotBytes *out;
+  uint64_t bits;
+  int count;
+} ChengSnapshotBits;
+
+static inline void chengSnapshotPutBits(ChengSnapshotBits *w, uint32_t value, int n) {
+  w->bits |= (uint64_t)value << w->count;
+  w->count += n;
+  while (w->count >= 8) {
+    w->out->data[w->out->len++] = (uint8_t)w->bits;
+    w->bits >>= 8;
+    w->count -= 8;
+  }
+}
+
+static inline void chengSnapshotAlignBits(ChengSnapshotBits *w) {
+  if (w->count > 0) chengSnapshotPutBits(w, 0u, 8 - w->count);
+}
+
+/* ---- Huffman codes --------------------------------------------------------- */
+
+typedef struct {
+  uint32_t freq;
+  uint16_t sym;
+} ChengSnapshotSym;
+
+static int chengSnapshotSymCompare(const void *lhs, const void *rhs) {
+  const ChengSnapshotSym *a = (const ChengSnapshotSym *)lhs;
+  const ChengSnapshotSym *b = (const ChengSnapshotSym *)rhs;
+  if (a->freq != b->freq) return a->freq < b->freq ? -1 : 1;
+  return (int)a->sym - (int)b->sym;
+}
+
+/* Moffat-Katajainen in place: weights sorted ascending become code lengths. */
+static void chengSnapshotMinRedundancy(uint32_t *a, int n) {
+  if (n == 1) {
+    a[0] = 1;
+    return;
+  }
+  a[0] += a[1];
+  int root = 0;
+  int leaf = 2;
+  for (int next = 1; next < n - 1; next++) {
+    if (leaf >= n || a[root] < a[leaf]) {
+      a[next] = a[root];
+      a[root++] = (uint32_t)next;
+    } else {
+      a[next] = a[leaf++];
+    }
+    if (leaf >= n || (root < next && a[root] < a[leaf])) {
+      a[next] += a[root];
+      a[root++] = (uint32_t)next;
+    } else {
+      a[next] += a[leaf++];
+    }
+  }
+  a[n - 2] = 0;
+  for (int next = n - 3; next >= 0; next--) a[next] = a[a[next]] + 1;
+  int avail = 1;
+  int used = 0;
+  uint32_t depth = 0;
+  root = n - 2;
+  int next = n - 1;
+  while (avail > 0) {
+    while (root >= 0 && a[root] == depth) {
+      used++;
+      root--;
+    }
+    while (avail > used) {
+      a[next--] = depth;
+      avail--;
+    }
+    avail = 2 * used;
+    depth++;
+    used = 0;
+  }
+}
+
+static inline uint32_t chengSnapshotReverse(uint32_t code, int len) {
+  uint32_t out = 0;
+  for (int i = 0; i < len; i++) {
+    out = (out << 1) | (code & 1u);
+    code >>= 1;
+  }
+  return out;
+}
+
+/* Length-limited canonical code for `freq`; unused symbols get length 0. */
+static void chengSnapshotBuildCode(const uint32_t *freq, int n, int maxLen, uint8_t *lengths, uint16_t *codes) {
+  ChengSnapshotSym syms[288];
+  uint32_t weights[288];
+  int used = 0;
+  for (int i = 0; i < n; i++) {
+    lengths[i] = 0;
+    codes[i] = 0;
+    if (freq[i] > 0) {
+      syms[used].freq = freq[i];
+      syms[used].sym = (uint16_t)i;
+      used++;
+    }
+  }
+  if (used == 0) return;
+  qsort(syms, (size_t)used, sizeof(syms[0]), chengSnapshotSymCompare);
+  for (int i = 0; i < used; i++) weights[i] = syms[i].freq;
+  chengSnapshotMinRedundancy(weights, used);
+  int perLen[33];
+  memset(perLen, 0, sizeof(perLen));
+  for (int i = 0; i < used; i++) perLen[weights[i] > 32 ? 32 : weights[i]]++;
+  /* Fold overlong codes into maxLen, then lengthen shorter ones until the
+     Kraft sum is exactly one again. */
+  for (int len = maxLen + 1; len <= 32; len++) {
+    perLen[maxLen] += perLen[len];
+    perLen[len] = 0;
+  }
+  uint32_t total = 0;
+  for (int len = maxLen; len > 0; len--) total += (uint32_t)perLen[len] << (maxLen - len);
+  while (total > (1u << maxLen)) {
+    perLen[maxLen]--;
+    for (int len = maxLen - 1; len > 0; len--) {
+      if (perLen[len] > 0) {
+        perLen[len]--;
+        perLen[len + 1] += 2;
+        break;
+      }
+    }
+    total--;
+  }
+  int j = used;
+  for (int len = 1; len <= maxLen; len++) {
+    for (int k = perLen[len]; k > 0; k--) lengths[syms[--j].sym] = (uint8_t)len;
+  }
+  uint32_t nextCode[17];
+  int count[17];
+  memset(count, 0, sizeof(count));
+  for (int i = 0; i < n; i++) count[lengths[i]]++;
+  count[0] = 0;
+  uint32_t code = 0;
+  for (int len = 1; len <= 16; len++) {
+    code = (code + (uint32_t)count[len - 1]) << 1;
+    nextCode[len] = code;
+  }
+  for (int i = 0; i < n; i++) {
+    if (lengths[i] > 0) codes[i] = (uint16_t)chengSnapshotReverse(nextCode[lengths[i]]++, lengths[i]);
+  }
+}
+
+/* ---- deflate --------------------------------------------------------------- */
+
+/* A token is a literal byte, or 0x80000000 | (length - 3) << 16 | (distance - 1). */
+#define CHENG_SNAPSHOT_MATCH 0x80000000u
+
+static inline void chengSnapshotLengthSymbol(int length, int *sym, int *extraBits, int *extra) {
+  int l = length - 3;
+  if (length == 258) {
+    *sym = 285;
+    *extraBits = 0;
+    *extra = 0;
+  } else if (l < 8) {
+    *sym = 257 + l;
+    *extraBits = 0;
+    *extra = 0;
+  } else {
+    int b = 31 - __builtin_clz((unsigned)l);
+    int hi = (l >> (b - 2)) & 3;
+    *sym = 257 + 4 * (b - 1) + hi;
+    *extraBits = b - 2;
+    *extra = l - ((4 + hi) << (b - 2));
+  }
+}
+
+static inline void chengSnapshotDistanceSymbol(int distance, int *sym, int *extraBits, int *extra) {
+  int d = distance - 1;
+  if (d < 4) {
+    *sym = d;
+    *extraBits = 0;
+    *extra = 0;
+  } else {
+    int b = 31 - __builtin_clz((unsigned)d);
+    int hi = (d >> (b - 1)) & 1;
+    *sym = 2 * b + hi;
+    *extraBits = b - 1;
+    *extra = d - ((2 + hi) << (b - 1));
+  }
+}
+
+static const uint8_t kChengSnapshotClOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+static const uint8_t kChengSnapshotClExtra[19] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 7};
+
+/* Run-length codes for the literal and distance code lengths (symbols 0-18). */
+static int chengSnapshotRunLengths(const uint8_t *lens, int n, uint8_t *syms, uint8_t *extras) {
+  int out = 0;
+  int i = 0;
+  while (i < n) {
+    uint8_t v = lens[i];
+    int run = 1;
+    while (i + run < n && lens[i + run] == v) run++;
+    i += run;
+    if (v == 0) {
+      while (run >= 11) {
+        int r = run < 138 ? run : 138;
+        syms[out] = 18;
+        extras[out++] = (uint8_t)(r - 11);
+        run -= r;
+      }
+      if (run >= 3) {
+        syms[out] = 17;
+        extras[out++] = (uint8_t)(run - 3);
+        run = 0;
+      }
+    } else {
+      syms[out] = v;
+      extras[out++] = 0;
+      run--;
+      while (run >= 3) {
+        int r = run < 6 ? run : 6;
+        syms[out] = 16;
+        extras[out++] = (uint8_t)(r - 3);
+        run -= r;
+      }
+    }
+    while (run > 0) {
+      syms[out] = v;
+      extras[out++] = 0;
+      run--;
+    }
+  }
+  return out;
+}
+
+static void chengSnapshotStoredBlocks(ChengSnapshotBits *w, const uint8_t *raw, size_t len) {
+  do {
+    size_t chunk = len < 65535u ? len : 65535u;
+    chengSnapshotPutBits(w, 0u, 3);
+    chengSnapshotAlignBits(w);
+    ChengSnapshotBytes *out = w->out;
+    out->data[out->len++] = (uint8_t)chunk;
+    out->data[out->len++] = (uint8_t)(chunk >> 8);
+    out->data[out->len++] = (uint8_t)~chunk;
+    out->data[out->len++] = (uint8_t)(~chunk >> 8);
+    memcpy(out->data + out->len, raw, chunk);
+    out->len += chunk;
+    raw += chunk;
+    len -= chunk;
+  } while (len > 0);
+}
+
+/* One non-final block for `tokens`, which encode raw[0, rawLen): dynamic
+   Huffman, or stored when that would be larger. */
+static bool chengSnapshotEmitBlock(ChengSnapshotBits *w, const uint32_t *tokens, size_t count, const uint8_t *raw, size_t rawLen) {
+  if (!chengSnapshotReserve(w->out, rawLen + (rawLen / 65535u + 1u) * 5u + 1024u)) return false;
+  uint32_t litFreq[286];
+  uint32_t distFreq[30];
+  memset(litFreq, 0, sizeof(litFreq));
+  memset(distFreq, 0, sizeof(distFreq));
+  for (size_t i = 0; i < count; i++) {
+    uint32_t t = tokens[i];
+    if (t & CHENG_SNAPSHOT_MATCH) {
+      int sym, extraBits, extra;
+      chengSnapshotLengthSymbol((int)((t >> 16) & 0xFFu) + 3, &sym, &extraBits, &extra);
+      litFreq[sym]++;
+      chengSnapshotDistanceSymbol((int)(t & 0xFFFFu) + 1, &sym, &extraBits, &extra);
+      distFreq[sym]++;
+    } else {
+      litFreq[t]++;
+    }
+  }
+  litFreq[256] = 1;
+  /* Some inflaters reject a distance code with fewer than two entries, so
+     unused codes are padded in until there are two, even in a block with no
+     matches at all. */
+  int distUsed = 0;
+  for (int i = 0; i < 30; i++) distUsed += distFreq[i] > 0 ? 1 : 0;
+  for (int i = 0; i < 30 && distUsed < 2; i++) {
+    if (distFreq[i] == 0) {
+      distFreq[i] = 1;
+      distUsed++;
+    }
+  }
+  uint8_t lens[286 + 30];
+  uint16_t litCode[286];
+  uint16_t distCode[30];
+  chengSnapshotBuildCode(litFreq, 286, 15, lens, litCode);
+  chengSnapshotBuildCode(distFreq, 30, 15, lens + 286, distCode);
+  int nlit = 286;
+  while (nlit > 257 && lens[nlit - 1] == 0) nlit--;
+  int ndist = 30;
+  while (ndist > 1 && lens[286 + ndist - 1] == 0) ndist--;
+  uint8_t packed[286 + 30];
+  memcpy(packed, lens, (size_t)nlit);
+  memcpy(packed + nlit, lens + 286, (size_t)ndist);
+  uint8_t rleSyms[286 + 30];
+  uint8_t rleExtras[286 + 30];
+  int rleCount = chengSnapshotRunLengths(packed, nlit + ndist, rleSyms, rleExtras);
+  uint32_t clFreq[19];
+  memset(clFreq, 0, sizeof(clFreq));
+  for (int i = 0; i < rleCount; i++) clFreq[rleSyms[i]]++;
+  uint8_t clLens[19];
+  uint16_t clCode[19];
+  chengSnapshotBuildCode(clFreq, 19, 7, clLens, clCode);
+  int nclen = 19;
+  while (nclen > 4 && clLens[kChengSnapshotClOrder[nclen - 1]] == 0) nclen--;
+
+  uint64_t bits = 3 + 5 + 5 + 4 + 3 * (uint64_t)nclen;
+  for (int i = 0; i < rleCount; i++) bits += clLens[rleSyms[i]] + kChengSnapshotClExtra[rleSyms[i]];
+  for (int i = 0; i < 286; i++) {
+    if (litFreq[i] == 0) continue;
+    int extraBits = 0;
+    if (i >= 265 && i < 285) extraBits = (i - 261) / 4;
+    bits += (uint64_t)litFreq[i] * (lens[i] + (uint64_t)extraBits);
+  }
+  for (int i = 0; i < 30; i++) {
+    if (distFreq[i] == 0) continue;
+    int extraBits = i < 4 ? 0 : i / 2 - 1;
+    bits += (uint64_t)distFreq[i] * (lens[286 + i] + (uint64_t)extraBits);
+  }
+  uint64_t storedBits = (uint64_t)rawLen * 8u + (rawLen / 65535u + 1u) * 40u + 8u;
+  if (bits >= storedBits) {
+    chengSnapshotStoredBlocks(w, raw, rawLen);
+    return true;
+  }
+
+  chengSnapshotPutBits(w, 2u << 1, 3);
+  chengSnapshotPutBits(w, (uint32_t)(nlit - 257), 5);
+  chengSnapshotPutBits(w, (uint32_t)(ndist - 1), 5);
+  chengSnapshotPutBits(w, (uint32_t)(nclen - 4), 4);
+  for (int i = 0; i < nclen; i++) chengSnapshotPutBits(w, clLens[kChengSnapshotClOrder[i]], 3);
+  for (int i = 0; i < rleCount; i++) {
+    uint8_t s = rleSyms[i];
+    chengSnapshotPutBits(w, clCode[s], clLens[s]);
+    if (kChengSnapshotClExtra[s] > 0) chengSnapshotPutBits(w, rleExtras[i], kChengSnapshotClExtra[s]);
+  }
+  for (size_t i = 0; i < count; i++) {
+    uint32_t t = tokens[i];
+    if (t & CHENG_SNAPSHOT_MATCH) {
+      int sym, extraBits, extra;
+      chengSnapshotLengthSymbol((int)((t >> 16) & 0xFFu) + 3, &sym, &extraBits, &extra);
+      chengSnapshotPutBits(w, litCode[sym], lens[sym]);
+      if (extraBits > 0) chengSnapshotPutBits(w, (uint32_t)extra, extraBits);
+      chengSnapshotDistanceSymbol((int)(t & 0xFFFFu) + 1, &sym, &extraBits, &extra);
+      chengSnapshotPutBits(w, distCode[sym], lens[286 + sym]);
+      if (extraBits > 0) chengSnapshotPutBits(w, (uint32_t)extra, extraBits);
+    } else {
+      chengSnapshotPutBits(w, litCode[t], lens[t]);
+    }
+  }
+  chengSnapshotPutBits(w, litCode[256], lens[256]);
+  return true;
+}
+
+static inline uint32_t chengSnapshotLoad32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline size_t chengSnapshotMatchLength(const uint8_t *a, const uint8_t *b, size_t limit) {
+  size_t len = 0;
+  while (len + 8 <= limit) {
+    uint64_t x, y;
+    memcpy(&x, a + len, 8);
+    memcpy(&y, b + len, 8);
+    uint64_t diff = x ^ y;
+    if (diff != 0) return len + (size_t)(__builtin_ctzll(diff) >> 3);
+    len += 8;
+  }
+  while (len < limit && a[len] == b[len]) len++;
+  return len;
+}
+
+/* Compresses data[0, len) into non-final blocks followed by a sync flush,
+   so the output is byte aligned and can be followed by another stream part. */
+static bool chengSnapshotDeflate(const uint8_t *data, size_t len, int32_t *head, uint32_t *tokens, ChengSnapshotBytes *out) {
+  ChengSnapshotBits w;
+  w.out = out;
+  w.bits = 0;
+  w.count = 0;
+  memset(head, 0xFF, sizeof(int32_t) << CHENG_SNAPSHOT_HASH_BITS);
+  size_t count = 0;
+  size_t blockStart = 0;
+  size_t pos = 0;
+  while (pos < len) {
+    size_t step = 1;
+    uint32_t token = data[pos];
+    if (pos + 4 <= len) {
+      uint32_t h = (chengSnapshotLoad32(data + pos) * 2654435761u) >> (32 - CHENG_SNAPSHOT_HASH_BITS);
+      int32_t cand = head[h];
+      head[h] = (int32_t)pos;
+      if (cand >= 0 && pos - (size_t)cand <= CHENG_SNAPSHOT_WINDOW) {
+        size_t limit = len - pos < 258u ? len - pos : 258u;
+        size_t match = chengSnapshotMatchLength(data + cand, data + pos, limit);
+        if (match >= 4) {
+          token = CHENG_SNAPSHOT_MATCH | (uint32_t)(match - 3) << 16 | (uint32_t)(pos - (size_t)cand - 1);
+          step = match;
+          /* Long matches are mostly flat runs; seeding their tail is enough. */
+          size_t from = match <= 32 ? pos + 1 : pos + match - 3;
+          for (size_t i = from; i < pos + match && i + 4 <= len; i++) {
+            head[(chengSnapshotLoad32(data + i) * 2654435761u) >> (32 - CHENG_SNAPSHOT_HASH_BITS)] = (int32_t)i;
+          }
+        }
+      }
+    }
+    tokens[count++] = token;
+    pos += step;
+    if (count == CHENG_SNAPSHOT_BLOCK_TOKENS) {
+      if (!chengSnapshotEmitBlock(&w, tokens, count, data + blockStart, pos - blockStart)) return false;
+      count = 0;
+      blockStart = pos;
+    }
+  }
+  if (count > 0 && !chengSnapshotEmitBlock(&w, tokens, count, data + blockStart, pos - blockStart)) return false;
+  if (!chengSnapshotReserve(out, 16)) return false;
+  chengSnapshotPutBits(&w, 0u, 3);
+  chengSnapshotAlignBits(&w);
+  out->data[out->len++] = 0x00;
+  out->data[out->len++] = 0x00;
+  out->data[out->len++] = 0xFF;
+  out->data[out->len++] = 0xFF;
+  return true;
+}
+
+/* ---- PNG rows -------------------------------------------------------------- */
+
+static void chengSnapshotPackRow(const uint32_t *src, int width, int bpp, uint8_t *dst) {
+  if (bpp == 4) {
+    for (int x = 0; x < width; x++) {
+      uint32_t p = src[x];
+      dst[0] = (uint8_t)(p >> 16);
+      dst[1] = (uint8_t)(p >> 8);
+      dst[2] = (uint8_t)p;
+      dst[3] = (uint8_t)(p >> 24);
+      dst += 4;
+    }
+  } else {
+    for (int x = 0; x < width; x++) {
+      uint32_t p = src[x];
+      dst[0] = (uint8_t)(p >> 16);
+      dst[1] = (uint8_t)(p >> 8);
+      dst[2] = (uint8_t)p;
+      dst += 3;
+    }
+  }
+}
+
+static inline uint32_t chengSnapshotCost(uint8_t v) {
+  int8_t signedValue = (int8_t)v;
+  return (uint32_t)(signedValue < 0 ? -signedValue : signedValue);
+}
+
+static inline uint8_t chengSnapshotPaeth(int a, int b, int c) {
+  int pa = b > c ? b - c : c - b;
+  int pb = a > c ? a - c : c - a;
+  int pc = a + b - 2 * c;
+  pc = pc < 0 ? -pc : pc;
+  int pick = pb <= pc ? b : c;
+  return (uint8_t)(pa <= pb && pa <= pc ? a : pick);
+}
+
+/* Writes the filter byte and the filtered row to dst; prev is NULL on the
+   first image row. scratch holds three candidate rows. */
+static void chengSnapshotFilterRow(const uint8_t *cur, const uint8_t *prev, size_t n, int bpp, uint8_t *scratch, uint8_t *dst) {
+  uint8_t *sub = scratch;
+  uint8_t *up = scratch + n;
+  uint8_t *paeth = scratch + 2 * n;
+  size_t lead = (size_t)bpp < n ? (size_t)bpp : n;
+  uint32_t costNone = 0;
+  uint32_t costSub = 0;
+  uint32_t costUp = UINT32_MAX;
+  uint32_t costPaeth = UINT32_MAX;
+  for (size_t i = 0; i < n; i++) costNone += chengSnapshotCost(cur[i]);
+  for (size_t i = 0; i < lead; i++) sub[i] = cur[i];
+  for (size_t i = lead; i < n; i++) sub[i] = (uint8_t)(cur[i] - cur[i - bpp]);
+  for (size_t i = 0; i < n; i++) costSub += chengSnapshotCost(sub[i]);
+  if (prev != NULL) {
+    costUp = 0;
+    costPaeth = 0;
+    for (size_t i = 0; i < n; i++) {
+      up[i] = (uint8_t)(cur[i] - prev[i]);
+      costUp += chengSnapshotCost(up[i]);
+    }
+    /* With no left neighbour Paeth predicts from above, like Up. */
+    for (size_t i = 0; i < lead; i++) paeth[i] = up[i];
+    for (size_t i = lead; i < n; i++) paeth[i] = (uint8_t)(cur[i] - chengSnapshotPaeth(cur[i - bpp], prev[i], prev[i - bpp]));
+    for (size_t i = 0; i < n; i++) costPaeth += chengSnapshotCost(paeth[i]);
+  }
+  uint8_t kind = 0;
+  const uint8_t *best = cur;
+  uint32_t bestCost = costNone;
+  if (costSub < bestCost) {
+    kind = 1;
+    best = sub;
+    bestCost = costSub;
+  }
+  if (costUp < bestCost) {
+    kind = 2;
+    best = up;
+    bestCost = costUp;
+  }
+  if (costPaeth < bestCost) {
+    kind = 4;
+    best = paeth;
+  }
+  dst[0] = kind;
+  memcpy(dst + 1, best, n);
+}
+
+/* One horizontal band of the image, filtered and deflated independently. */
+typedef struct {
+  const uint32_t *pixels;
+  int width;
+  int y0;
+  int y1;
+  int bpp;
+  uint8_t *scratch;
+  size_t scratchCap;
+  uint8_t *filtered;
+  size_t filteredCap;
+  size_t filteredLen;
+  int32_t *head;
+  uint32_t *tokens;
+  ChengSnapshotBytes out;
+  uint32_t adler;
+  bool ok;
+} ChengSnapshotStripe;
+
+typedef struct {
+  ChengSnapshotStripe stripes[CHENG_SNAPSHOT_MAX_STRIPES];
+  int stripeLimit;
+} ChengSnapshotEncoder;
+
+static void chengSnapshotEncoderFree(ChengSnapshotEncoder *enc) {
+  for (int i = 0; i < CHENG_SNAPSHOT_MAX_STRIPES; i++) {
+    ChengSnapshotStripe *s = &enc->stripes[i];
+    free(s->scratch);
+    free(s->filtered);
+    free(s->head);
+    free(s->tokens);
+    free(s->out.data);
+    memset(s, 0, sizeof(*s));
+  }
+}
+
+static bool chengSnapshotGrow(uint8_t **buf, size_t *cap, size_t want) {
+  if (*cap >= want) return true;
+  uint8_t *grown = (uint8_t *)realloc(*buf, want);
+  if (grown == NULL) return false;
+  *buf = grown;
+  *cap = want;
+  return true;
+}
+
+static void chengSnapshotStripeRun(ChengSnapshotStripe *s) {
+  s->ok = false;
+  s->out.len = 0;
+  size_t rowBytes = (size_t)s->width * (size_t)s->bpp;
+  size_t rows = (size_t)(s->y1 - s->y0);
+  if (!chengSnapshotGrow(&s->scratch, &s->scratchCap, rowBytes * 5)) return;
+  if (!chengSnapshotGrow(&s->filtered, &s->filteredCap, rows * (rowBytes + 1))) return;
+  if (s->head == NULL) s->head = (int32_t *)malloc(sizeof(int32_t) << CHENG_SNAPSHOT_HASH_BITS);
+  if (s->tokens == NULL) s->tokens = (uint32_t *)malloc(sizeof(uint32_t) * CHENG_SNAPSHOT_BLOCK_TOKENS);
+  if (s->head == NULL || s->tokens == NULL) return;
+  uint8_t *cur = s->scratch + rowBytes * 3;
+  uint8_t *prev = s->scratch + rowBytes * 4;
+  bool hasPrev = s->y0 > 0;
+  if (hasPrev) chengSnapshotPackRow(s->pixels + (size_t)(s->y0 - 1) * (size_t)s->width, s->width, s->bpp, prev);
+  uint8_t *dst = s->filtered;
+  for (int y = s->y0; y < s->y1; y++) {
+    chengSnapshotPackRow(s->pixels + (size_t)y * (size_t)s->width, s->width, s->bpp, cur);
+    chengSnapshotFilterRow(cur, hasPrev ? prev : NULL, rowBytes, s->bpp, s->scratch, dst);
+    dst += rowBytes + 1;
+    uint8_t *swap = prev;
+    prev = cur;
+    cur = swap;
+    hasPrev = true;
+  }
+  s->filteredLen = rows * (rowBytes + 1);
+  s->adler = chengSnapshotAdler(s->filtered, s->filteredLen);
+  s->ok = chengSnapshotDeflate(s->filtered, s->filteredLen, s->head, s->tokens, &s->out);
+}
+
+#if CHENG_SNAPSHOT_THREADS
+static void *chengSnapshotStripeThread(void *arg) {
+  chengSnapshotStripeRun((ChengSnapshotStripe *)arg);
+  return NULL;
+}
+#endif
+
+static int chengSnapshotCpuCount(void) {
+#if defined(_WIN32)
+  return 1;
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+#endif
+}
+
+static int chengSnapshotDefaultStripes(void) {
+  int limit = chengSnapshotCpuCount();
+  const char *env = getenv("GUI_SNAPSHOT_WORKERS");
+  if (env != NULL && env[0] != '\0') {
+    int parsed = atoi(env);
+    if (parsed > 0) limit = parsed;
+  }
+  if (limit > CHENG_SNAPSHOT_MAX_STRIPES) limit = CHENG_SNAPSHOT_MAX_STRIPES;
+  return limit < 1 ? 1 : limit;
+}
+
+static bool chengSnapshotWriteChunk(FILE *file, const char *tag, const uint8_t *data, size_t len) {
+  uint8_t header[8] = {(uint8_t)(len >> 24), (uint8_t)(len >> 16), (uint8_t)(len >> 8), (uint8_t)len,
+                       (uint8_t)tag[0], (uint8_t)tag[1], (uint8_t)tag[2], (uint8_t)tag[3]};
+  uint32_t crc = chengSnapshotCrcUpdate(0xFFFFFFFFu, header + 4, 4);
+  crc = chengSnapshotCrcUpdate(crc, data, len) ^ 0xFFFFFFFFu;
+  uint8_t trailer[4] = {(uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc};
+  return fwrite(header, 1, 8, file) == 8 && (len == 0 || fwrite(data, 1, len, file) == len) &&
+         fwrite(trailer, 1, 4, file) == 4;
+}
+
+/* Encodes tightly packed pixels; returns the file size, 0 on failure. */
+static uint64_t chengSnapshotWritePng(ChengSnapshotEncoder *enc, const uint32_t *pixels, int width, int height, bool opaque,
+                                      const char *path, uint64_t *encodeNs, uint64_t *writeNs) {
+  uint64_t start = chengSnapshotNowNs();
+  int bpp = opaque ? 3 : 4;
+  int stripes = height / CHENG_SNAPSHOT_MIN_STRIPE_ROWS;
+  if (stripes > enc->stripeLimit) stripes = enc->stripeLimit;
+  if (stripes < 1) stripes = 1;
+  for (int i = 0; i < stripes; i++) {
+    ChengSnapshotStripe *s = &enc->stripes[i];
+    s->pixels = pixels;
+    s->width = width;
+    s->bpp = bpp;
+    s->y0 = (int)((int64_t)height * i / stripes);
+    s->y1 = (int)((int64_t)height * (i + 1) / stripes);
+  }
+#if CHENG_SNAPSHOT_THREADS
+  pthread_t threads[CHENG_SNAPSHOT_MAX_STRIPES];
+  bool started[CHENG_SNAPSHOT_MAX_STRIPES];
+  for (int i = 1; i < stripes; i++) {
+    started[i] = pthread_create(&threads[i], NULL, chengSnapshotStripeThread, &enc->stripes[i]) == 0;
+  }
+  chengSnapshotStripeRun(&enc->stripes[0]);
+  for (int i = 1; i < stripes; i++) {
+    if (started[i]) pthread_join(threads[i], NULL);
+    else chengSnapshotStripeRun(&enc->stripes[i]);
+  }
+#else
+  for (int i = 0; i < stripes; i++) chengSnapshotStripeRun(&enc->stripes[i]);
+#endif
+  size_t idatLen = 2 + 2 + 4;
+  uint32_t adler = 1u;
+  for (int i = 0; i < stripes; i++) {
+    const ChengSnapshotStripe *s = &enc->stripes[i];
+    if (!s->ok) return 0;
+    idatLen += s->out.len;
+    adler = chengSnapshotAdlerCombine(adler, s->adler, s->filteredLen);
+  }
+  uint64_t encoded = chengSnapshotNowNs();
+  *encodeNs += encoded - start;
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) return 0;
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  uint8_t ihdr[13] = {(uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+                      (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+                      8, (uint8_t)(opaque ? 2 : 6), 0, 0, 0};
+  bool ok = fwrite(signature, 1, 8, file) == 8 && chengSnapshotWriteChunk(file, "IHDR", ihdr, sizeof(ihdr));
+  if (ok) {
+    /* IDAT is streamed stripe by stripe, with the CRC carried across pieces:
+       zlib header, stripes, an empty final fixed block, Adler-32. */
+    static const uint8_t zlibHeader[2] = {0x78, 0x01};
+    static const uint8_t finalBlock[2] = {0x03, 0x00};
+    uint8_t header[8] = {(uint8_t)(idatLen >> 24), (uint8_t)(idatLen >> 16), (uint8_t)(idatLen >> 8), (uint8_t)idatLen,
+                         'I', 'D', 'A', 'T'};
+    uint8_t tail[4] = {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16), (uint8_t)(adler >> 8), (uint8_t)adler};
+    uint32_t crc = chengSnapshotCrcUpdate(0xFFFFFFFFu, header + 4, 4);
+    ok = fwrite(header, 1, 8, file) == 8 && fwrite(zlibHeader, 1, 2, file) == 2;
+    crc = chengSnapshotCrcUpdate(crc, zlibHeader, 2);
+    for (int i = 0; ok && i < stripes; i++) {
+      const ChengSnapshotBytes *part = &enc->stripes[i].out;
+      ok = fwrite(part->data, 1, part->len, file) == part->len;
+      crc = chengSnapshotCrcUpdate(crc, part->data, part->len);
+    }
+    crc = chengSnapshotCrcUpdate(crc, finalBlock, 2);
+    crc = chengSnapshotCrcUpdate(crc, tail, 4) ^ 0xFFFFFFFFu;
+    uint8_t trailer[4] = {(uint8_t)(crc >> 24), (uint8_t)(crc >> 16), (uint8_t)(crc >> 8), (uint8_t)crc};
+    ok = ok && fwrite(finalBlock, 1, 2, file) == 2 && fwrite(tail, 1, 4, file) == 4 && fwrite(trailer, 1, 4, file) == 4;
+  }
+  ok = ok && chengSnapshotWriteChunk(file, "IEND", NULL, 0);
+  ok = fclose(file) == 0 && ok;
+  *writeNs += chengSnapshotNowNs() - encoded;
+  return ok ? (uint64_t)(8 + 25 + 12 + idatLen + 12) : 0;
+}
+
+/* Raw RGBA or PPM, one converted row at a time. */
+static uint64_t chengSnapshotWriteRaw(ChengSnapshotEncoder *enc, const uint32_t *pixels, int width, int height, int format,
+                                      const char *path, uint64_t *writeNs) {
+  uint64_t start = chengSnapshotNowNs();
+  ChengSnapshotStripe *s = &enc->stripes[0];
+  int bpp = format == ChengGuiSnapshotPpm ? 3 : 4;
+  size_t rowBytes = (size_t)width * (size_t)bpp;
+  if (!chengSnapshotGrow(&s->scratch, &s->scratchCap, rowBytes)) return 0;
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) return 0;
+  uint64_t total = 0;
+  bool ok = true;
+  if (format == ChengGuiSnapshotPpm) {
+    int n = fprintf(file, "P6\n%d %d\n255\n", width, height);
+    ok = n > 0;
+    total += n > 0 ? (uint64_t)n : 0u;
+  }
+  for (int y = 0; ok && y < height; y++) {
+    chengSnapshotPackRow(pixels + (size_t)y * (size_t)width, width, bpp, s->scratch);
+    ok = fwrite(s->scratch, 1, rowBytes, file) == rowBytes;
+    total += rowBytes;
+  }
+  ok = fclose(file) == 0 && ok;
+  *writeNs += chengSnapshotNowNs() - start;
+  return ok ? total : 0;
+}
+
+/* ---- writer ---------------------------------------------------------------- */
+
+typedef struct {
+  uint32_t *pixels;
+  size_t capacity;
+  int width;
+  int height;
+  int format;
+  int flags;
+  bool busy;
+  char path[CHENG_SNAPSHOT_PATH_MAX];
+} ChengSnapshotSlot;
+
+typedef struct {
+#if CHENG_SNAPSHOT_THREADS
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t room;
+  pthread_t thread;
+  bool threadStarted;
+#endif
+  int poolSize;
+  ChengSnapshotSlot slots[CHENG_SNAPSHOT_MAX_POOL];
+  int queue[CHENG_SNAPSHOT_MAX_POOL];
+  int queueHead;
+  int queueCount;
+  bool encoding;
+  bool stop;
+  ChengSnapshotEncoder encoder;
+  /* Last snapshot written, for skipping repeats; writer thread only. */
+  bool hasLast;
+  uint64_t lastHash;
+  int lastWidth;
+  int lastHeight;
+  int lastFormat;
+  ChengGuiSnapshotStats stats;
+} ChengSnapshotWriter;
+
+#if CHENG_SNAPSHOT_THREADS
+#  define CHENG_SNAPSHOT_LOCK(w) pthread_mutex_lock(&(w)->lock)
+#  define CHENG_SNAPSHOT_UNLOCK(w) pthread_mutex_unlock(&(w)->lock)
+#else
+#  define CHENG_SNAPSHOT_LOCK(w) ((void)(w))
+#  define CHENG_SNAPSHOT_UNLOCK(w) ((void)(w))
+#endif
+
+/* FNV-1a over pixel pairs; also reports whether every alpha byte is 0xFF. */
+static uint64_t chengSnapshotHash(const uint32_t *pixels, size_t count, bool *opaque) {
+  uint64_t hash = 1469598103934665603ULL;
+  uint64_t alpha = 0xFF000000FF000000ULL;
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    uint64_t v;
+    memcpy(&v, pixels + i, 8);
+    alpha &= v;
+    hash = (hash ^ v) * 1099511628211ULL;
+  }
+  if (i < count) {
+    alpha &= (uint64_t)pixels[i] | 0xFF00000000000000ULL;
+    hash = (hash ^ pixels[i]) * 1099511628211ULL;
+  }
+  *opaque = alpha == 0xFF000000FF000000ULL;
+  return hash;
+}
+
+/* Returns 1 when written, 0 when skipped as a repeat, -1 on failure. */
+static int chengSnapshotProcess(ChengSnapshotWriter *w, ChengSnapshotSlot *slot, uint64_t *bytesOut, uint64_t *encodeNs,
+                                uint64_t *writeNs) {
+  bool opaque = false;
+  uint64_t start = chengSnapshotNowNs();
+  uint64_t hash = chengSnapshotHash(slot->pixels, (size_t)slot->width * (size_t)slot->height, &opaque);
+  hash ^= ((uint64_t)(uint32_t)slot->width << 32) | (uint32_t)slot->height;
+  *encodeNs += chengSnapshotNowNs() - start;
+  if ((slot->flags & ChengGuiSnapshotFlagForce) == 0 && w->hasLast && w->lastHash == hash && w->lastWidth == slot->width &&
+      w->lastHeight == slot->height && w->lastFormat == slot->format) {
+    return 0;
+  }
+  uint64_t bytes = 0;
+  if (slot->format == ChengGuiSnapshotPng) {
+    bytes = chengSnapshotWritePng(&w->encoder, slot->pixels, slot->width, slot->height, opaque, slot->path, encodeNs, writeNs);
+  } else {
+    bytes = chengSnapshotWriteRaw(&w->encoder, slot->pixels, slot->width, slot->height, slot->format, slot->path, writeNs);
+  }
+  if (bytes == 0) return -1;
+  w->hasLast = true;
+  w->lastHash = hash;
+  w->lastWidth = slot->width;
+  w->lastHeight = slot->height;
+  w->lastFormat = slot->format;
+  *bytesOut = bytes;
+  return 1;
+}
+
+static void chengSnapshotFinish(ChengSnapshotWriter *w, ChengSnapshotSlot *slot) {
+  uint64_t bytesOut = 0;
+  uint64_t encodeNs = 0;
+  uint64_t writeNs = 0;
+  int rc = chengSnapshotProcess(w, slot, &bytesOut, &encodeNs, &writeNs);
+  CHENG_SNAPSHOT_LOCK(w);
+  if (rc > 0) w->stats.written++;
+  else if (rc == 0) w->stats.skipped++;
+  else w->stats.failed++;
+  w->stats.bytesOut += bytesOut;
+  w->stats.encodeNs += encodeNs;
+  w->stats.writeNs += writeNs;
+  if (rc > 0) w->stats.lastHash = w->lastHash;
+  w->stats.pending--;
+  slot->busy = false;
+  CHENG_SNAPSHOT_UNLOCK(w);
+}
+
+#if CHENG_SNAPSHOT_THREADS
+static void *chengSnapshotWriterThread(void *arg) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)arg;
+  pthread_mutex_lock(&w->lock);
+  for (;;) {
+    while (w->queueCount == 0 && !w->stop) pthread_cond_wait(&w->wake, &w->lock);
+    if (w->queueCount == 0) break;
+    ChengSnapshotSlot *slot = &w->slots[w->queue[w->queueHead]];
+    w->queueHead = (w->queueHead + 1) % CHENG_SNAPSHOT_MAX_POOL;
+    w->queueCount--;
+    w->encoding = true;
+    pthread_mutex_unlock(&w->lock);
+    chengSnapshotFinish(w, slot);
+    pthread_mutex_lock(&w->lock);
+    w->encoding = false;
+    pthread_cond_broadcast(&w->room);
+  }
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
+}
+#endif
+
+SNAPSHOT_EXPORT void *chengGuiSnapshotWriterCreate(int32_t poolSize) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)calloc(1, sizeof(ChengSnapshotWriter));
+  if (w == NULL) return NULL;
+  if (poolSize <= 0) poolSize = CHENG_SNAPSHOT_DEFAULT_POOL;
+  if (poolSize > CHENG_SNAPSHOT_MAX_POOL) poolSize = CHENG_SNAPSHOT_MAX_POOL;
+  w->poolSize = poolSize;
+  w->encoder.stripeLimit = chengSnapshotDefaultStripes();
+#if CHENG_SNAPSHOT_THREADS
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->wake, NULL);
+  pthread_cond_init(&w->room, NULL);
+  w->threadStarted = pthread_create(&w->thread, NULL, chengSnapshotWriterThread, w) == 0;
+#endif
+  return w;
+}
+
+/* Copies the frame and queues it. Returns 1 when queued (or, without a writer
+   thread, processed), 0 when dropped for lack of a pool buffer, <0 on bad
+   arguments or allocation failure. */
+SNAPSHOT_EXPORT int32_t chengGuiSnapshotWriterSubmit(void *writer, const void *pixels, int32_t width, int32_t height,
+                                                     int32_t strideBytes, const char *path, int32_t format, int32_t flags) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)writer;
+  if (w == NULL || pixels == NULL || path == NULL || path[0] == '\0') return -1;
+  if (width <= 0 || height <= 0 || strideBytes < width * 4) return -1;
+  if (format < ChengGuiSnapshotPng || format > ChengGuiSnapshotPpm) return -1;
+  if (strlen(path) >= CHENG_SNAPSHOT_PATH_MAX) return -1;
+  uint64_t start = chengSnapshotNowNs();
+  CHENG_SNAPSHOT_LOCK(w);
+  w->stats.submitted++;
+  ChengSnapshotSlot *slot = NULL;
+  for (;;) {
+    for (int i = 0; i < w->poolSize; i++) {
+      if (!w->slots[i].busy) {
+        slot = &w->slots[i];
+        break;
+      }
+    }
+    if (slot != NULL) break;
+#if CHENG_SNAPSHOT_THREADS
+    if ((flags & ChengGuiSnapshotFlagBlock) != 0 && w->threadStarted) {
+      pthread_cond_wait(&w->room, &w->lock);
+      continue;
+    }
+#endif
+    w->stats.dropped++;
+    CHENG_SNAPSHOT_UNLOCK(w);
+    return 0;
+  }
+  slot->busy = true;
+  w->stats.pending++;
+  w->stats.waitNs += chengSnapshotNowNs() - start;
+  CHENG_SNAPSHOT_UNLOCK(w);
+
+  uint64_t copyStart = chengSnapshotNowNs();
+  size_t count = (size_t)width * (size_t)height;
+  if (slot->capacity < count) {
+    uint32_t *grown = (uint32_t *)realloc(slot->pixels, count * sizeof(uint32_t));
+    if (grown == NULL) {
+      CHENG_SNAPSHOT_LOCK(w);
+      slot->busy = false;
+      w->stats.pending--;
+      w->stats.failed++;
+      CHENG_SNAPSHOT_UNLOCK(w);
+      return -2;
+    }
+    slot->pixels = grown;
+    slot->capacity = count;
+  }
+  const uint8_t *src = (const uint8_t *)pixels;
+  if (strideBytes == width * 4) {
+    memcpy(slot->pixels, src, count * sizeof(uint32_t));
+  } else {
+    for (int32_t y = 0; y < height; y++) {
+      memcpy(slot->pixels + (size_t)y * (size_t)width, src + (size_t)y * (size_t)strideBytes, (size_t)width * 4u);
+    }
+  }
+  slot->width = width;
+  slot->height = height;
+  slot->format = format;
+  slot->flags = flags;
+  memcpy(slot->path, path, strlen(path) + 1);
+  uint64_t copyNs = chengSnapshotNowNs() - copyStart;
+
+  CHENG_SNAPSHOT_LOCK(w);
+  w->stats.copyNs += copyNs;
+  w->stats.bytesIn += (uint64_t)count * 4u;
+#if CHENG_SNAPSHOT_THREADS
+  if (w->threadStarted) {
+    w->queue[(w->queueHead + w->queueCount) % CHENG_SNAPSHOT_MAX_POOL] = (int)(slot - w->slots);
+    w->queueCount++;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    return 1;
+  }
+#endif
+  CHENG_SNAPSHOT_UNLOCK(w);
+  chengSnapshotFinish(w, slot);
+  return 1;
+}
+
+/* Waits until every queued snapshot is on disk; returns the failures so far. */
+SNAPSHOT_EXPORT int32_t chengGuiSnapshotWriterFlush(void *writer) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)writer;
+  if (w == NULL) return 0;
+  CHENG_SNAPSHOT_LOCK(w);
+#if CHENG_SNAPSHOT_THREADS
+  while (w->queueCount > 0 || w->encoding) pthread_cond_wait(&w->room, &w->lock);
+#endif
+  int32_t failed = (int32_t)w->stats.failed;
+  CHENG_SNAPSHOT_UNLOCK(w);
+  return failed;
+}
+
+SNAPSHOT_EXPORT void chengGuiSnapshotWriterDestroy(void *writer) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)writer;
+  if (w == NULL) return;
+#if CHENG_SNAPSHOT_THREADS
+  pthread_mutex_lock(&w->lock);
+  w->stop = true;
+  pthread_cond_signal(&w->wake);
+  pthread_mutex_unlock(&w->lock);
+  if (w->threadStarted) pthread_join(w->thread, NULL);
+  pthread_cond_destroy(&w->room);
+  pthread_cond_destroy(&w->wake);
+  pthread_mutex_destroy(&w->lock);
+#endif
+  for (int i = 0; i < CHENG_SNAPSHOT_MAX_POOL; i++) free(w->slots[i].pixels);
+  chengSnapshotEncoderFree(&w->encoder);
+  free(w);
+}
+
+SNAPSHOT_EXPORT size_t chengGuiSnapshotStatsSize(void) {
+  return sizeof(ChengGuiSnapshotStats);
+}
+
+SNAPSHOT_EXPORT int32_t chengGuiSnapshotWriterStats(void *writer, ChengGuiSnapshotStats *out) {
+  ChengSnapshotWriter *w = (ChengSnapshotWriter *)writer;
+  if (out == NULL) return -1;
+  memset(out, 0, sizeof(*out));
+  if (w == NULL) return -1;
+  CHENG_SNAPSHOT_LOCK(w);
+  *out = w->stats;
+  CHENG_SNAPSHOT_UNLOCK(w);
+  return 0;
+}
+
+static ChengSnapshotWriter *gChengSnapshotDefault = NULL;
+
+static void chengSnapshotDefaultShutdown(void) {
+  ChengSnapshotWriter *w = gChengSnapshotDefault;
+  gChengSnapshotDefault = NULL;
+  chengGuiSnapshotWriterDestroy(w);
+}
+
+/* Process-wide writer shared by the backend and the headless host; queued
+   snapshots are drained at exit. Call from the render thread only. */
+SNAPSHOT_EXPORT void *chengGuiSnapshotDefaultWriter(void) {
+  if (gChengSnapshotDefault == NULL) {
+    gChengSnapshotDefault = (ChengSnapshotWriter *)chengGuiSnapshotWriterCreate(CHENG_SNAPSHOT_DEFAULT_POOL);
+    if (gChengSnapshotDefault != NULL) atexit(chengSnapshotDefaultShutdown);
+  }
+  return gChengSnapshotDefault;
+}
+
+/* Synchronous PNG of one frame; returns 0 on success. */
+SNAPSHOT_EXPORT int32_t chengGuiSnapshotEncodePng(const void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                                  const char *path) {
+  if (pixels == NULL || path == NULL || width <= 0 || height <= 0 || strideBytes < width * 4) return -1;
+  size_t count = (size_t)width * (size_t)height;
+  const uint32_t *packed = (const uint32_t *)pixels;
+  uint32_t *copy = NULL;
+  if (strideBytes != width * 4) {
+    copy = (uint32_t *)malloc(count * sizeof(uint32_t));
+    if (copy == NULL) return -2;
+    for (int32_t y = 0; y < height; y++) {
+      memcpy(copy + (size_t)y * (size_t)width, (const uint8_t *)pixels + (size_t)y * (size_t)strideBytes, (size_t)width * 4u);
+    }
+    packed = copy;
+  }
+  ChengSnapshotEncoder enc;
+  memset(&enc, 0, sizeof(enc));
+  enc.stripeLimit = chengSnapshotDefaultStripes();
+  bool opaque = false;
+  chengSnapshotHash(packed, count, &opaque);
+  uint64_t encodeNs = 0;
+  uint64_t writeNs = 0;
+  uint64_t bytes = chengSnapshotWritePng(&enc, packed, width, height, opaque, path, &encodeNs, &writeNs);
+  chengSnapshotEncoderFree(&enc);
+  free(copy);
+  return bytes > 0 ? 0 : -3;
+}
+
+#ifdef CHENG_GUI_SNAPSHOT_MAIN
+
+/*
+ * Converts a raw RGBA dump (R,G,B,A bytes, as GUI_HEADLESS_DUMP_DIR writes)
+ * to PNG. Exit codes follow scripts/convert_rgba_out_to_png.py. With --bench,
+ * also reports encode throughput on the same frame.
+ */
+
+int main(int argc, char **argv) {
+  const char *in = NULL;
+  const char *out = NULL;
+  int width = 0;
+  int height = 0;
+  bool bench = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--in") == 0 && i + 1 < argc) in = argv[++i];
+    else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out = argv[++i];
+    else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--bench") == 0) bench = true;
+    else {
+      fprintf(stderr, "usage: %s --in <frame.rgba.out> --out <frame.png> --width W --height H [--bench]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (in == NULL || out == NULL || width <= 0 || height <= 0) {
+    fprintf(stderr, "invalid width/height\n");
+    return 2;
+  }
+  FILE *file = fopen(in, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "cannot open %s\n", in);
+    return 2;
+  }
+  size_t expected = (size_t)width * (size_t)height * 4u;
+  uint8_t *rgba = (uint8_t *)malloc(expected + 1);
+  size_t got = rgba != NULL ? fread(rgba, 1, expected + 1, file) : 0;
+  fclose(file);
+  if (rgba == NULL) return 2;
+  if (got >= 2 && rgba[0] == 'w' && rgba[1] == '=') {
+    fprintf(stderr, "input appears to be fallback metadata, not raw RGBA bytes\n");
+    free(rgba);
+    return 3;
+  }
+  if (got != expected) {
+    fprintf(stderr, "input size mismatch: got=%zu expected=%zu\n", got, expected);
+    free(rgba);
+    return 4;
+  }
+  uint32_t *pixels = (uint32_t *)malloc(expected);
+  if (pixels == NULL) return 2;
+  for (size_t i = 0; i < expected / 4u; i++) {
+    const uint8_t *p = rgba + i * 4u;
+    pixels[i] = ((uint32_t)p[3] << 24) | ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | (uint32_t)p[2];
+  }
+  free(rgba);
+  if (chengGuiSnapshotEncodePng(pixels, width, height, width * 4, out) != 0) {
+    fprintf(stderr, "cannot write %s\n", out);
+    free(pixels);
+    return 5;
+  }
+  if (bench) {
+    /* Reuses one encoder, as the writer thread does; encode excludes the file write. */
+    ChengSnapshotEncoder enc;
+    memset(&enc, 0, sizeof(enc));
+    enc.stripeLimit = chengSnapshotDefaultStripes();
+    bool opaque = false;
+    chengSnapshotHash(pixels, expected / 4u, &opaque);
+    int rounds = 10;
+    uint64_t encodeNs = 0;
+    uint64_t writeNs = 0;
+    uint64_t bytes = 0;
+    for (int i = 0; i <= rounds; i++) {
+      if (i == 1) encodeNs = writeNs = 0;
+      bytes = chengSnapshotWritePng(&enc, pixels, width, height, opaque, out, &encodeNs, &writeNs);
+    }
+    chengSnapshotEncoderFree(&enc);
+    double ms = (double)encodeNs / 1e6 / rounds;
+    printf("[snapshot] png %dx%d stripes=%d bytes=%llu encodeMs=%.3f writeMs=%.3f %.1f MPix/s\n", width, height,
+           enc.stripeLimit, (unsigned long long)bytes, ms, (double)writeNs / 1e6 / rounds, (double)width * height / (ms * 1000.0));
+  }
+  free(pixels);
+  return 0;
+}
+
+#endif
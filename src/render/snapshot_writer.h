@@ -0,0 +1,48 @@
+/* Background frame snapshot writer, see render/snapshot_writer.c. Native hosts
+ * that dump frames include this instead of redeclaring the ABI; the Cheng
+ * bindings live in render/snapshot_writer.cheng. */
+#ifndef CHENG_GUI_SNAPSHOT_WRITER_H
+#define CHENG_GUI_SNAPSHOT_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum {
+  ChengGuiSnapshotPng = 0,
+  ChengGuiSnapshotRgba = 1,
+  ChengGuiSnapshotPpm = 2
+};
+
+enum {
+  ChengGuiSnapshotFlagForce = 1, /* write even when identical to the last snapshot */
+  ChengGuiSnapshotFlagBlock = 2  /* wait for a pool buffer instead of dropping */
+};
+
+typedef struct {
+  int64_t submitted;
+  int64_t written;
+  int64_t skipped; /* identical to the previous snapshot */
+  int64_t dropped; /* no free pool buffer */
+  int64_t failed;
+  int64_t pending; /* copied but not yet written */
+  uint64_t bytesIn;
+  uint64_t bytesOut;
+  uint64_t copyNs; /* caller: copying frames into the pool */
+  uint64_t waitNs; /* caller: blocked on a full pool */
+  uint64_t encodeNs;
+  uint64_t writeNs;
+  uint64_t lastHash;
+} ChengGuiSnapshotStats;
+
+void *chengGuiSnapshotWriterCreate(int32_t poolSize);
+int32_t chengGuiSnapshotWriterSubmit(void *writer, const void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                     const char *path, int32_t format, int32_t flags);
+int32_t chengGuiSnapshotWriterFlush(void *writer);
+void chengGuiSnapshotWriterDestroy(void *writer);
+size_t chengGuiSnapshotStatsSize(void);
+int32_t chengGuiSnapshotWriterStats(void *writer, ChengGuiSnapshotStats *out);
+void *chengGuiSnapshotDefaultWriter(void);
+int32_t chengGuiSnapshotEncodePng(const void *pixels, int32_t width, int32_t height, int32_t strideBytes,
+                                  const char *path);
+
+#endif
@@ -0,0 +1,1150 @@
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Linux text backend. Outlines come from TrueType (glyf) fonts found on the
+ * system or next to the executable, are rasterized with an exact-area
+ * coverage accumulator and cached in a single 8-bit glyph atlas keyed by
+ * (font, size, glyph). Drawing a run is then a coverage blend from the atlas.
+ */
+
+enum {
+  ChengTextFontUi = 0,
+  ChengTextFontCode = 1,
+  ChengTextFontIcon = 2,
+  ChengTextFontCount = 3
+};
+
+/* Coverage blend kernel from render/pixel_kernels.c. */
+void chengGuiKernelBlendMaskRow(uint32_t *dst, const uint8_t *mask, int32_t count, uint32_t color);
+
+#define CHENG_TEXT_ATLAS_SIZE 1024
+#define CHENG_TEXT_CACHE_SLOTS 8192
+#define CHENG_TEXT_CACHE_LIMIT 6144
+#define CHENG_TEXT_MAX_COMPOSITE_DEPTH 8
+
+typedef struct {
+  unsigned char *data;
+  size_t size;
+  uint32_t glyf;
+  uint32_t loca;
+  uint32_t hmtx;
+  uint32_t cmap;
+  int cmapFormat;
+  int indexToLocFormat;
+  int numGlyphs;
+  int numHMetrics;
+  int unitsPerEm;
+  int ascent;
+  int descent;
+  int lineGap;
+  int32_t asciiGlyph[128];
+  int loaded;
+  int failed;
+  char path[PATH_MAX];
+} ChengTtfFont;
+
+typedef struct {
+  uint64_t key;
+  uint16_t atlasX;
+  uint16_t atlasY;
+  uint16_t width;
+  uint16_t height;
+  int16_t left;
+  int16_t top;
+  uint8_t used;
+} ChengTextGlyph;
+
+typedef struct {
+  int64_t lookups;
+  int64_t hits;
+  int64_t misses;
+  int64_t atlasResets;
+  double rasterMs;
+  int32_t glyphCount;
+  int32_t atlasWidth;
+  int32_t atlasHeight;
+  int32_t atlasUsedHeight;
+} ChengGuiTextAtlasStats;
+
+typedef struct {
+  float x0;
+  float y0;
+  float x1;
+  float y1;
+} ChengTextLine;
+
+typedef struct {
+  ChengTextLine *lines;
+  int count;
+  int cap;
+  double scale;
+  double originX;
+  double originY;
+} ChengTextOutline;
+
+static ChengTtfFont gChengTextFonts[ChengTextFontCount];
+static uint8_t *gChengTextAtlas = NULL;
+static ChengTextGlyph *gChengTextCache = NULL;
+static int gChengTextShelfX = 0;
+static int gChengTextShelfY = 0;
+static int gChengTextShelfHeight = 0;
+static ChengGuiTextAtlasStats gChengTextStats;
+static float *gChengTextAccum = NULL;
+static size_t gChengTextAccumCap = 0;
+static ChengTextOutline gChengTextOutline;
+
+static double chengTextNowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static uint16_t chengTtfU16(const ChengTtfFont *font, size_t offset) {
+  if (offset + 2 > font->size) return 0;
+  return (uint16_t)((font->data[offset] << 8) | font->data[offset + 1]);
+}
+
+static int16_t chengTtfS16(const ChengTtfFont *font, size_t offset) {
+  return (int16_t)chengTtfU16(font, offset);
+}
+
+static uint32_t chengTtfU32(const ChengTtfFont *font, size_t offset) {
+  if (offset + 4 > font->size) return 0;
+  return ((uint32_t)font->data[offset] << 24) | ((uint32_t)font->data[offset + 1] << 16) |
+         ((uint32_t)font->data[offset + 2] << 8) | (uint32_t)font->data[offset + 3];
+}
+
+static uint32_t chengTtfFindTable(const ChengTtfFont *font, uint32_t base, const char *tag) {
+  uint16_t numTables = chengTtfU16(font, base + 4);
+  for (uint16_t i = 0; i < numTables; i++) {
+    size_t record = (size_t)base + 12u + (size_t)i * 16u;
+    if (record + 16 > font->size) return 0;
+    if (memcmp(font->data + record, tag, 4) == 0) {
+      return chengTtfU32(font, record + 8);
+    }
+  }
+  return 0;
+}
+
+static int chengTtfSelectCmap(ChengTtfFont *font, uint32_t cmap) {
+  uint16_t count = chengTtfU16(font, cmap + 2);
+  uint32_t best = 0;
+  int bestFormat = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    size_t record = (size_t)cmap + 4u + (size_t)i * 8u;
+    uint16_t platform = chengTtfU16(font, record);
+    uint16_t encoding = chengTtfU16(font, record + 2);
+    uint32_t offset = cmap + chengTtfU32(font, record + 4);
+    uint16_t format = chengTtfU16(font, offset);
+    bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+    bool symbol = platform == 3 && encoding == 0;
+    if (!unicode && !symbol) continue;
+    if (format == 12) {
+      best = offset;
+      bestFormat = 12;
+      break;
+    }
+    if (format == 4 && bestFormat == 0) {
+      best = offset;
+      bestFormat = 4;
+    }
+  }
+  font->cmap = best;
+  font->cmapFormat = bestFormat;
+  return bestFormat != 0;
+}
+
+static uint32_t chengTtfGlyphIndexUncached(const ChengTtfFont *font, uint32_t codepoint) {
+  uint32_t t = font->cmap;
+  if (font->cmapFormat == 4) {
+    if (codepoint > 0xFFFFu) return 0;
+    uint16_t segX2 = chengTtfU16(font, t + 6);
+    int lo = 0;
+    int hi = segX2 / 2 - 1;
+    while (lo <= hi) {
+      int mid = (lo + hi) / 2;
+      uint16_t end = chengTtfU16(font, t + 14 + (size_t)mid * 2);
+      if (end < codepoint) {
+        lo = mid + 1;
+        continue;
+      }
+      uint16_t start = chengTtfU16(font, t + 16 + segX2 + (size_t)mid * 2);
+      if (start > codepoint) {
+        hi = mid - 1;
+        continue;
+      }
+      uint16_t delta = chengTtfU16(font, t + 16 + (size_t)segX2 * 2 + (size_t)mid * 2);
+      size_t rangePos = t + 16 + (size_t)segX2 * 3 + (size_t)mid * 2;
+      uint16_t rangeOffset = chengTtfU16(font, rangePos);
+      if (rangeOffset == 0) {
+        return (uint16_t)(codepoint + delta);
+      }
+      uint16_t glyph = chengTtfU16(font, rangePos + rangeOffset + (codepoint - start) * 2);
+      return glyph == 0 ? 0 : (uint16_t)(glyph + delta);
+    }
+    return 0;
+  }
+  if (font->cmapFormat == 12) {
+    uint32_t groups = chengTtfU32(font, t + 12);
+    uint32_t lo = 0;
+    uint32_t hi = groups;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      size_t group = (size_t)t + 16u + (size_t)mid * 12u;
+      uint32_t start = chengTtfU32(font, group);
+      uint32_t end = chengTtfU32(font, group + 4);
+      if (codepoint < start) {
+        hi = mid;
+      } else if (codepoint > end) {
+        lo = mid + 1;
+      } else {
+        return chengTtfU32(font, group + 8) + (codepoint - start);
+      }
+    }
+  }
+  return 0;
+}
+
+static uint32_t chengTtfGlyphIndex(const ChengTtfFont *font, uint32_t codepoint) {
+  if (codepoint < 128u) {
+    return (uint32_t)font->asciiGlyph[codepoint];
+  }
+  return chengTtfGlyphIndexUncached(font, codepoint);
+}
+
+static int chengTtfAdvanceUnits(const ChengTtfFont *font, uint32_t glyph) {
+  if (font->numHMetrics <= 0) return 0;
+  uint32_t metric = glyph < (uint32_t)font->numHMetrics ? glyph : (uint32_t)font->numHMetrics - 1u;
+  return chengTtfU16(font, font->hmtx + (size_t)metric * 4u);
+}
+
+static int chengTtfGlyphRange(const ChengTtfFont *font, uint32_t glyph, uint32_t *start, uint32_t *end) {
+  if ((int)glyph >= font->numGlyphs) return 0;
+  if (font->indexToLocFormat == 0) {
+    *start = font->glyf + (uint32_t)chengTtfU16(font, font->loca + (size_t)glyph * 2u) * 2u;
+    *end = font->glyf + (uint32_t)chengTtfU16(font, font->loca + (size_t)glyph * 2u + 2u) * 2u;
+  } else {
+    *start = font->glyf + chengTtfU32(font, font->loca + (size_t)glyph * 4u);
+    *end = font->glyf + chengTtfU32(font, font->loca + (size_t)glyph * 4u + 4u);
+  }
+  return *end > *start && *end <= font->size;
+}
+
+static int chengTtfLoad(ChengTtfFont *font, const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) return 0;
+  if (fseek(file, 0, SEEK_END) != 0) {
+    fclose(file);
+    return 0;
+  }
+  long size = ftell(file);
+  if (size < 12 || fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return 0;
+  }
+  unsigned char *data = (unsigned char *)malloc((size_t)size);
+  if (data == NULL || fread(data, 1, (size_t)size, file) != (size_t)size) {
+    free(data);
+    fclose(file);
+    return 0;
+  }
+  fclose(file);
+  font->data = data;
+  font->size = (size_t)size;
+  uint32_t base = 0;
+  if (memcmp(data, "ttcf", 4) == 0) {
+    base = chengTtfU32(font, 12);
+  }
+  uint32_t head = chengTtfFindTable(font, base, "head");
+  uint32_t hhea = chengTtfFindTable(font, base, "hhea");
+  uint32_t maxp = chengTtfFindTable(font, base, "maxp");
+  uint32_t cmap = chengTtfFindTable(font, base, "cmap");
+  font->glyf = chengTtfFindTable(font, base, "glyf");
+  font->loca = chengTtfFindTable(font, base, "loca");
+  font->hmtx = chengTtfFindTable(font, base, "hmtx");
+  if (head == 0 || hhea == 0 || maxp == 0 || cmap == 0 || font->glyf == 0 || font->loca == 0 || font->hmtx == 0 ||
+      !chengTtfSelectCmap(font, cmap)) {
+    free(data);
+    font->data = NULL;
+    font->size = 0;
+    return 0;
+  }
+  font->unitsPerEm = chengTtfU16(font, head + 18);
+  font->indexToLocFormat = chengTtfS16(font, head + 50);
+  font->numGlyphs = chengTtfU16(font, maxp + 4);
+  font->ascent = chengTtfS16(font, hhea + 4);
+  font->descent = chengTtfS16(font, hhea + 6);
+  font->lineGap = chengTtfS16(font, hhea + 8);
+  font->numHMetrics = chengTtfU16(font, hhea + 34);
+  if (font->unitsPerEm <= 0) font->unitsPerEm = 1000;
+  for (uint32_t cp = 0; cp < 128u; cp++) {
+    font->asciiGlyph[cp] = (int32_t)chengTtfGlyphIndexUncached(font, cp);
+  }
+  snprintf(font->path, sizeof(font->path), "%s", path);
+  return 1;
+}
+
+static int chengTextReadable(const char *path) {
+  return path != NULL && path[0] != '\0' && access(path, R_OK) == 0;
+}
+
+static int chengTextJoinReadable(const char *base, const char *suffix, char *buffer, size_t cap) {
+  if (base == NULL || base[0] == '\0') return 0;
+  int written = snprintf(buffer, cap, "%s/%s", base, suffix);
+  if (written <= 0 || (size_t)written >= cap) return 0;
+  return access(buffer, R_OK) == 0;
+}
+
+static int chengTextExecutableDir(char *buffer, size_t cap) {
+  ssize_t len = readlink("/proc/self/exe", buffer, cap - 1);
+  if (len <= 0) return 0;
+  buffer[len] = '\0';
+  char *slash = strrchr(buffer, '/');
+  if (slash == NULL) return 0;
+  *slash = '\0';
+  return 1;
+}
+
+static int chengTextResolveFontPath(int slot, char *buffer, size_t cap) {
+  static const char *uiCandidates[] = {
+      "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+      "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+      "/usr/share/fonts/TTF/DejaVuSans.ttf",
+      "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+      "/usr/share/fonts/liberation/LiberationSans-Regular.ttf",
+      "/usr/share/fonts/truetype/noto/NotoSans-Regular.ttf",
+      "/usr/share/fonts/noto/NotoSans-Regular.ttf",
+      "/usr/share/fonts/truetype/freefont/FreeSans.ttf",
+      NULL,
+  };
+  static const char *codeCandidates[] = {
+      "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+      "/usr/share/fonts/dejavu/DejaVuSansMono.ttf",
+      "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+      "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
+      "/usr/share/fonts/liberation/LiberationMono-Regular.ttf",
+      "/usr/share/fonts/truetype/noto/NotoSansMono-Regular.ttf",
+      "/usr/share/fonts/noto/NotoSansMono-Regular.ttf",
+      "/usr/share/fonts/truetype/freefont/FreeMono.ttf",
+      NULL,
+  };
+  const char *envName = slot == ChengTextFontCode ? "GUI_CODE_FONT" : (slot == ChengTextFontIcon ? "IDE_ICON_FONT" : "GUI_FONT");
+  const char *bundled = slot == ChengTextFontCode ? "resources/fonts/code.ttf" :
+                        (slot == ChengTextFontIcon ? "resources/fonts/codicon.ttf" : "resources/fonts/ui.ttf");
+  const char *env = getenv(envName);
+  if (chengTextReadable(env)) {
+    snprintf(buffer, cap, "%s", env);
+    return 1;
+  }
+  if (chengTextJoinReadable(getenv("IDE_RESOURCE_ROOT"), bundled + strlen("resources/"), buffer, cap)) return 1;
+  if (chengTextJoinReadable(getenv("IDE_ROOT"), bundled, buffer, cap)) return 1;
+  char exeDir[PATH_MAX];
+  if (chengTextExecutableDir(exeDir, sizeof(exeDir))) {
+    if (chengTextJoinReadable(exeDir, bundled, buffer, cap)) return 1;
+    char parentBundled[64];
+    snprintf(parentBundled, sizeof(parentBundled), "../%s", bundled);
+    if (chengTextJoinReadable(exeDir, parentBundled, buffer, cap)) return 1;
+  }
+  if (slot == ChengTextFontIcon) {
+    return chengTextJoinReadable(".", bundled, buffer, cap);
+  }
+  const char **candidates = slot == ChengTextFontCode ? codeCandidates : uiCandidates;
+  for (size_t i = 0; candidates[i] != NULL; i++) {
+    if (chengTextReadable(candidates[i])) {
+      snprintf(buffer, cap, "%s", candidates[i]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static ChengTtfFont *chengTextFont(int slot) {
+  ChengTtfFont *font = &gChengTextFonts[slot];
+  if (font->loaded) return font;
+  if (font->failed) return NULL;
+  char path[PATH_MAX];
+  if (!chengTextResolveFontPath(slot, path, sizeof(path)) || !chengTtfLoad(font, path)) {
+    font->failed = 1;
+    return NULL;
+  }
+  font->loaded = 1;
+  return font;
+}
+
+/* Resolves a codepoint to a glyph, falling back between the UI and code
+   fonts so either face can cover what the other lacks. */
+static ChengTtfFont *chengTextResolveGlyph(int slot, uint32_t codepoint, uint32_t *glyph, int *resolvedSlot) {
+  ChengTtfFont *primary = chengTextFont(slot);
+  if (primary != NULL) {
+    *glyph = chengTtfGlyphIndex(primary, codepoint);
+    *resolvedSlot = slot;
+    if (*glyph != 0 || slot == ChengTextFontIcon) return primary;
+  }
+  if (slot != ChengTextFontIcon) {
+    int otherSlot = slot == ChengTextFontUi ? ChengTextFontCode : ChengTextFontUi;
+    ChengTtfFont *other = chengTextFont(otherSlot);
+    if (other != NULL) {
+      uint32_t otherGlyph = chengTtfGlyphIndex(other, codepoint);
+      if (otherGlyph != 0 || primary == NULL) {
+        *glyph = otherGlyph;
+        *resolvedSlot = otherSlot;
+        return other;
+      }
+    }
+  }
+  return primary;
+}
+
+static void chengTextOutlineLine(ChengTextOutline *outline, double x0, double y0, double x1, double y1) {
+  if (outline->count == outline->cap) {
+    int cap = outline->cap == 0 ? 256 : outline->cap * 2;
+    ChengTextLine *lines = (ChengTextLine *)realloc(outline->lines, sizeof(ChengTextLine) * (size_t)cap);
+    if (lines == NULL) return;
+    outline->lines = lines;
+    outline->cap = cap;
+  }
+  ChengTextLine *line = &outline->lines[outline->count++];
+  line->x0 = (float)(x0 * outline->scale - outline->originX);
+  line->y0 = (float)(-y0 * outline->scale - outline->originY);
+  line->x1 = (float)(x1 * outline->scale - outline->originX);
+  line->y1 = (float)(-y1 * outline->scale - outline->originY);
+}
+
+static void chengTextOutlineQuad(ChengTextOutline *outline, double x0, double y0, double cx, double cy, double x1, double y1) {
+  double devX = (x0 - 2.0 * cx + x1) * outline->scale;
+  double devY = (y0 - 2.0 * cy + y1) * outline->scale;
+  double devSq = devX * devX + devY * devY;
+  if (devSq < 0.333) {
+    chengTextOutlineLine(outline, x0, y0, x1, y1);
+    return;
+  }
+  int segments = 1 + (int)floor(sqrt(sqrt(3.0 * devSq)));
+  double px = x0;
+  double py = y0;
+  for (int i = 1; i < segments; i++) {
+    double t = (double)i / (double)segments;
+    double mt = 1.0 - t;
+    double nx = mt * mt * x0 + 2.0 * mt * t * cx + t * t * x1;
+    double ny = mt * mt * y0 + 2.0 * mt * t * cy + t * t * y1;
+    chengTextOutlineLine(outline, px, py, nx, ny);
+    px = nx;
+    py = ny;
+  }
+  chengTextOutlineLine(outline, px, py, x1, y1);
+}
+
+static void chengTextEmitContour(ChengTextOutline *outline, const double *xs, const double *ys, const uint8_t *onCurve, int count) {
+  if (count < 2) return;
+  double startX;
+  double startY;
+  int first;
+  if (onCurve[0]) {
+    startX = xs[0];
+    startY = ys[0];
+    first = 1;
+  } else if (onCurve[count - 1]) {
+    startX = xs[count - 1];
+    startY = ys[count - 1];
+    first = 0;
+    count--;
+  } else {
+    startX = (xs[0] + xs[count - 1]) * 0.5;
+    startY = (ys[0] + ys[count - 1]) * 0.5;
+    first = 0;
+  }
+  double penX = startX;
+  double penY = startY;
+  bool hasControl = false;
+  double ctrlX = 0.0;
+  double ctrlY = 0.0;
+  for (int i = first; i < count; i++) {
+    if (onCurve[i]) {
+      if (hasControl) {
+        chengTextOutlineQuad(outline, penX, penY, ctrlX, ctrlY, xs[i], ys[i]);
+      } else {
+        chengTextOutlineLine(outline, penX, penY, xs[i], ys[i]);
+      }
+      penX = xs[i];
+      penY = ys[i];
+      hasControl = false;
+    } else {
+      if (hasControl) {
+        double midX = (ctrlX + xs[i]) * 0.5;
+        double midY = (ctrlY + ys[i]) * 0.5;
+        chengTextOutlineQuad(outline, penX, penY, ctrlX, ctrlY, midX, midY);
+        penX = midX;
+        penY = midY;
+      }
+      ctrlX = xs[i];
+      ctrlY = ys[i];
+      hasControl = true;
+    }
+  }
+  if (hasControl) {
+    chengTextOutlineQuad(outline, penX, penY, ctrlX, ctrlY, startX, startY);
+  } else {
+    chengTextOutlineLine(outline, penX, penY, startX, startY);
+  }
+}
+
+static void chengTextEmitGlyph(const ChengTtfFont *font, uint32_t glyph, const double *xform, int depth, ChengTextOutline *outline) {
+  uint32_t start = 0;
+  uint32_t end = 0;
+  if (depth > CHENG_TEXT_MAX_COMPOSITE_DEPTH || !chengTtfGlyphRange(font, glyph, &start, &end)) return;
+  int16_t contours = chengTtfS16(font, start);
+  if (contours < 0) {
+    size_t p = start + 10;
+    uint16_t flags;
+    do {
+      flags = chengTtfU16(font, p);
+      uint16_t component = chengTtfU16(font, p + 2);
+      p += 4;
+      double dx = 0.0;
+      double dy = 0.0;
+      if (flags & 0x0001u) {
+        dx = chengTtfS16(font, p);
+        dy = chengTtfS16(font, p + 2);
+        p += 4;
+      } else {
+        dx = (int8_t)(p < font->size ? font->data[p] : 0);
+        dy = (int8_t)(p + 1 < font->size ? font->data[p + 1] : 0);
+        p += 2;
+      }
+      if ((flags & 0x0002u) == 0) {
+        dx = 0.0;
+        dy = 0.0;
+      }
+      double a = 1.0, b = 0.0, c = 0.0, d = 1.0;
+      if (flags & 0x0008u) {
+        a = d = chengTtfS16(font, p) / 16384.0;
+        p += 2;
+      } else if (flags & 0x0040u) {
+        a = chengTtfS16(font, p) / 16384.0;
+        d = chengTtfS16(font, p + 2) / 16384.0;
+        p += 4;
+      } else if (flags & 0x0080u) {
+        a = chengTtfS16(font, p) / 16384.0;
+        b = chengTtfS16(font, p + 2) / 16384.0;
+        c = chengTtfS16(font, p + 4) / 16384.0;
+        d = chengTtfS16(font, p + 6) / 16384.0;
+        p += 8;
+      }
+      double child[6] = {
+          xform[0] * a + xform[2] * b, xform[1] * a + xform[3] * b,
+          xform[0] * c + xform[2] * d, xform[1] * c + xform[3] * d,
+          xform[0] * dx + xform[2] * dy + xform[4], xform[1] * dx + xform[3] * dy + xform[5],
+      };
+      chengTextEmitGlyph(font, component, child, depth + 1, outline);
+    } while ((flags & 0x0020u) != 0 && p < end);
+    return;
+  }
+  if (contours == 0) return;
+  size_t endPts = start + 10;
+  int pointCount = chengTtfU16(font, endPts + (size_t)(contours - 1) * 2u) + 1;
+  size_t p = endPts + (size_t)contours * 2u;
+  p += 2u + chengTtfU16(font, p);
+  if (pointCount <= 0 || pointCount > 0xFFFF) return;
+  uint8_t *flags = (uint8_t *)malloc((size_t)pointCount * 2u);
+  double *xs = (double *)malloc(sizeof(double) * (size_t)pointCount * 2u);
+  if (flags == NULL || xs == NULL) {
+    free(flags);
+    free(xs);
+    return;
+  }
+  uint8_t *onCurve = flags + pointCount;
+  double *ys = xs + pointCount;
+  for (int i = 0; i < pointCount && p < end;) {
+    uint8_t flag = font->data[p++];
+    int repeat = 0;
+    if ((flag & 0x08u) && p < end) repeat = font->data[p++];
+    for (int r = 0; r <= repeat && i < pointCount; r++) flags[i++] = flag;
+  }
+  int value = 0;
+  for (int i = 0; i < pointCount; i++) {
+    if (flags[i] & 0x02u) {
+      int delta = p < end ? font->data[p++] : 0;
+      value += (flags[i] & 0x10u) ? delta : -delta;
+    } else if ((flags[i] & 0x10u) == 0) {
+      value += chengTtfS16(font, p);
+      p += 2;
+    }
+    xs[i] = value;
+  }
+  value = 0;
+  for (int i = 0; i < pointCount; i++) {
+    if (flags[i] & 0x04u) {
+      int delta = p < end ? font->data[p++] : 0;
+      value += (flags[i] & 0x20u) ? delta : -delta;
+    } else if ((flags[i] & 0x20u) == 0) {
+      value += chengTtfS16(font, p);
+      p += 2;
+    }
+    ys[i] = value;
+  }
+  for (int i = 0; i < pointCount; i++) {
+    double fx = xs[i];
+    double fy = ys[i];
+    xs[i] = xform[0] * fx + xform[2] * fy + xform[4];
+    ys[i] = xform[1] * fx + xform[3] * fy + xform[5];
+    onCurve[i] = (uint8_t)(flags[i] & 0x01u);
+  }
+  int contourStart = 0;
+  for (int c = 0; c < contours; c++) {
+    int contourEnd = chengTtfU16(font, endPts + (size_t)c * 2u);
+    if (contourEnd >= pointCount || contourEnd < contourStart) break;
+    chengTextEmitContour(outline, xs + contourStart, ys + contourStart, onCurve + contourStart, contourEnd - contourStart + 1);
+    contourStart = contourEnd + 1;
+  }
+  free(flags);
+  free(xs);
+}
+
+static void chengTextAccumulateLine(float *acc, int width, int height, const ChengTextLine *line) {
+  float x0 = line->x0, y0 = line->y0, x1 = line->x1, y1 = line->y1;
+  if (fabsf(y0 - y1) <= 1e-6f) return;
+  float dir = 1.0f;
+  if (y0 > y1) {
+    float t = x0; x0 = x1; x1 = t;
+    t = y0; y0 = y1; y1 = t;
+    dir = -1.0f;
+  }
+  float dxdy = (x1 - x0) / (y1 - y0);
+  float x = x0;
+  int yStart = y0 < 0.0f ? 0 : (int)y0;
+  if (y0 < 0.0f) x -= y0 * dxdy;
+  int yEnd = (int)ceilf(y1);
+  if (yEnd > height) yEnd = height;
+  for (int y = yStart; y < yEnd; y++) {
+    float *row = acc + (size_t)y * (size_t)width;
+    float dy = fminf((float)(y + 1), y1) - fmaxf((float)y, y0);
+    float xNext = x + dxdy * dy;
+    float d = dy * dir;
+    float xa = x < xNext ? x : xNext;
+    float xb = x < xNext ? xNext : x;
+    float xaFloor = floorf(xa);
+    int xai = (int)xaFloor;
+    float xbCeil = ceilf(xb);
+    int xbi = (int)xbCeil;
+    if (xai < 0) {
+      x = xNext;
+      continue;
+    }
+    if (xbi <= xai + 1) {
+      float xmf = 0.5f * (x + xNext) - xaFloor;
+      row[xai] += d - d * xmf;
+      row[xai + 1] += d * xmf;
+    } else {
+      float s = 1.0f / (xb - xa);
+      float xaf = xa - xaFloor;
+      float a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+      float xbf = xb - xbCeil + 1.0f;
+      float am = 0.5f * s * xbf * xbf;
+      row[xai] += d * a0;
+      if (xbi == xai + 2) {
+        row[xai + 1] += d * (1.0f - a0 - am);
+      } else {
+        float a1 = s * (1.5f - xaf);
+        row[xai + 1] += d * (a1 - a0);
+        for (int xi = xai + 2; xi < xbi - 1; xi++) row[xi] += d * s;
+        float a2 = a1 + (float)(xbi - xai - 3) * s;
+        row[xbi - 1] += d * (1.0f - a2 - am);
+      }
+      row[xbi] += d * am;
+    }
+    x = xNext;
+  }
+}
+
+static void chengTextResetAtlas(void) {
+  if (gChengTextCache != NULL) {
+    memset(gChengTextCache, 0, sizeof(ChengTextGlyph) * CHENG_TEXT_CACHE_SLOTS);
+  }
+  gChengTextShelfX = 0;
+  gChengTextShelfY = 0;
+  gChengTextShelfHeight = 0;
+  gChengTextStats.glyphCount = 0;
+  gChengTextStats.atlasUsedHeight = 0;
+}
+
+static int chengTextEnsureAtlas(void) {
+  if (gChengTextAtlas != NULL) return 1;
+  gChengTextAtlas = (uint8_t *)calloc((size_t)CHENG_TEXT_ATLAS_SIZE * CHENG_TEXT_ATLAS_SIZE, 1);
+  gChengTextCache = (ChengTextGlyph *)calloc(CHENG_TEXT_CACHE_SLOTS, sizeof(ChengTextGlyph));
+  if (gChengTextAtlas == NULL || gChengTextCache == NULL) {
+    free(gChengTextAtlas);
+    free(gChengTextCache);
+    gChengTextAtlas = NULL;
+    gChengTextCache = NULL;
+    return 0;
+  }
+  gChengTextStats.atlasWidth = CHENG_TEXT_ATLAS_SIZE;
+  gChengTextStats.atlasHeight = CHENG_TEXT_ATLAS_SIZE;
+  return 1;
+}
+
+static int chengTextAtlasAlloc(int width, int height, int *outX, int *outY) {
+  if (width > CHENG_TEXT_ATLAS_SIZE || height > CHENG_TEXT_ATLAS_SIZE) return 0;
+  if (gChengTextShelfX + width > CHENG_TEXT_ATLAS_SIZE) {
+    gChengTextShelfY += gChengTextShelfHeight + 1;
+    gChengTextShelfX = 0;
+    gChengTextShelfHeight = 0;
+  }
+  if (gChengTextShelfY + height > CHENG_TEXT_ATLAS_SIZE) return 0;
+  *outX = gChengTextShelfX;
+  *outY = gChengTextShelfY;
+  gChengTextShelfX += width + 1;
+  if (height > gChengTextShelfHeight) gChengTextShelfHeight = height;
+  gChengTextStats.atlasUsedHeight = gChengTextShelfY + gChengTextShelfHeight;
+  return 1;
+}
+
+static uint64_t chengTextGlyphKey(int slot, int sizeKey, uint32_t glyph) {
+  return ((uint64_t)(slot + 1) << 48) | ((uint64_t)(uint32_t)sizeKey << 24) | (uint64_t)(glyph & 0xFFFFFFu);
+}
+
+static size_t chengTextCacheHome(uint64_t key) {
+  return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 51) & (CHENG_TEXT_CACHE_SLOTS - 1);
+}
+
+static ChengTextGlyph *chengTextRasterize(const ChengTtfFont *font, double scale, uint32_t glyph, ChengTextGlyph *slotEntry, uint64_t key) {
+  double start = chengTextNowMs();
+  int64_t resetsBefore = gChengTextStats.atlasResets;
+  ChengTextOutline *outline = &gChengTextOutline;
+  outline->count = 0;
+  outline->scale = scale;
+  outline->originX = 0.0;
+  outline->originY = 0.0;
+  uint32_t glyphStart = 0;
+  uint32_t glyphEnd = 0;
+  int left = 0, top = 0, width = 0, height = 0;
+  if (chengTtfGlyphRange(font, glyph, &glyphStart, &glyphEnd)) {
+    double xMin = chengTtfS16(font, glyphStart + 2) * scale;
+    double yMin = chengTtfS16(font, glyphStart + 4) * scale;
+    double xMax = chengTtfS16(font, glyphStart + 6) * scale;
+    double yMax = chengTtfS16(font, glyphStart + 8) * scale;
+    left = (int)floor(xMin) - 1;
+    top = (int)floor(-yMax) - 1;
+    width = (int)ceil(xMax) - left + 2;
+    height = (int)ceil(-yMin) - top + 1;
+    outline->originX = (double)left;
+    outline->originY = (double)top;
+    static const double identity[6] = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    chengTextEmitGlyph(font, glyph, identity, 0, outline);
+  }
+  if (outline->count == 0 || width <= 0 || height <= 0) {
+    width = 0;
+    height = 0;
+  }
+  int atlasX = 0;
+  int atlasY = 0;
+  if (width > 0 && !chengTextAtlasAlloc(width, height, &atlasX, &atlasY)) {
+    chengTextResetAtlas();
+    gChengTextStats.atlasResets++;
+    if (!chengTextAtlasAlloc(width, height, &atlasX, &atlasY)) {
+      return NULL;
+    }
+  }
+  if (width > 0) {
+    size_t cells = (size_t)width * (size_t)height + 4u;
+    if (cells > gChengTextAccumCap) {
+      float *acc = (float *)realloc(gChengTextAccum, sizeof(float) * cells);
+      if (acc == NULL) return NULL;
+      gChengTextAccum = acc;
+      gChengTextAccumCap = cells;
+    }
+    memset(gChengTextAccum, 0, sizeof(float) * cells);
+    for (int i = 0; i < outline->count; i++) {
+      chengTextAccumulateLine(gChengTextAccum, width, height, &outline->lines[i]);
+    }
+    float sum = 0.0f;
+    for (int y = 0; y < height; y++) {
+      uint8_t *dst = gChengTextAtlas + (size_t)(atlasY + y) * CHENG_TEXT_ATLAS_SIZE + (size_t)atlasX;
+      const float *src = gChengTextAccum + (size_t)y * (size_t)width;
+      for (int x = 0; x < width; x++) {
+        sum += src[x];
+        float coverage = fabsf(sum);
+        dst[x] = (uint8_t)(coverage >= 1.0f ? 255 : (int)(coverage * 255.0f + 0.5f));
+      }
+    }
+  }
+  /* An atlas reset empties the table, so the probe slot we were handed is no
+     longer where a lookup would start; store at the home slot instead. */
+  if (gChengTextStats.atlasResets != resetsBefore) {
+    slotEntry = &gChengTextCache[chengTextCacheHome(key)];
+  }
+  slotEntry->key = key;
+  slotEntry->atlasX = (uint16_t)atlasX;
+  slotEntry->atlasY = (uint16_t)atlasY;
+  slotEntry->width = (uint16_t)width;
+  slotEntry->height = (uint16_t)height;
+  slotEntry->left = (int16_t)left;
+  slotEntry->top = (int16_t)top;
+  slotEntry->used = 1;
+  gChengTextStats.glyphCount++;
+  gChengTextStats.rasterMs += chengTextNowMs() - start;
+  return slotEntry;
+}
+
+static ChengTextGlyph *chengTextLookupGlyph(int slot, const ChengTtfFont *font, double fontSize, uint32_t glyph) {
+  if (!chengTextEnsureAtlas()) return NULL;
+  if (gChengTextStats.glyphCount >= CHENG_TEXT_CACHE_LIMIT) {
+    chengTextResetAtlas();
+    gChengTextStats.atlasResets++;
+  }
+  int sizeKey = (int)lround(fontSize * 4.0);
+  uint64_t key = chengTextGlyphKey(slot, sizeKey, glyph);
+  size_t index = chengTextCacheHome(key);
+  gChengTextStats.lookups++;
+  while (gChengTextCache[index].used) {
+    if (gChengTextCache[index].key == key) {
+      gChengTextStats.hits++;
+      return &gChengTextCache[index];
+    }
+    index = (index + 1) & (CHENG_TEXT_CACHE_SLOTS - 1);
+  }
+  gChengTextStats.misses++;
+  double scale = (double)sizeKey / 4.0 / (double)font->unitsPerEm;
+  return chengTextRasterize(font, scale, glyph, &gChengTextCache[index], key);
+}
+
+static int chengTextUtf8Decode(const unsigned char *s, size_t len, uint32_t *out) {
+  if (len == 0) return 0;
+  unsigned char c0 = s[0];
+  if (c0 < 0x80u) {
+    *out = c0;
+    return 1;
+  }
+  if ((c0 & 0xE0u) == 0xC0u && len >= 2 && (s[1] & 0xC0u) == 0x80u) {
+    *out = ((uint32_t)(c0 & 0x1Fu) << 6) | (uint32_t)(s[1] & 0x3Fu);
+    return 2;
+  }
+  if ((c0 & 0xF0u) == 0xE0u && len >= 3 && (s[1] & 0xC0u) == 0x80u && (s[2] & 0xC0u) == 0x80u) {
+    *out = ((uint32_t)(c0 & 0x0Fu) << 12) | ((uint32_t)(s[1] & 0x3Fu) << 6) | (uint32_t)(s[2] & 0x3Fu);
+    return 3;
+  }
+  if ((c0 & 0xF8u) == 0xF0u && len >= 4 && (s[1] & 0xC0u) == 0x80u && (s[2] & 0xC0u) == 0x80u &&
+      (s[3] & 0xC0u) == 0x80u) {
+    *out = ((uint32_t)(c0 & 0x07u) << 18) | ((uint32_t)(s[1] & 0x3Fu) << 12) | ((uint32_t)(s[2] & 0x3Fu) << 6) |
+           (uint32_t)(s[3] & 0x3Fu);
+    return 4;
+  }
+  *out = 0xFFFDu;
+  return 1;
+}
+
+static double chengTextAdvance(int slot, uint32_t codepoint, double fontSize) {
+  uint32_t glyph = 0;
+  int resolvedSlot = slot;
+  ChengTtfFont *font = chengTextResolveGlyph(slot, codepoint, &glyph, &resolvedSlot);
+  if (font == NULL) return 0.0;
+  return (double)chengTtfAdvanceUnits(font, glyph) * fontSize / (double)font->unitsPerEm;
+}
+
+static double chengTextMeasure(int slot, const char *text, size_t textLen, double fontSize, size_t stopByte) {
+  if (text == NULL) return 0.0;
+  if (fontSize <= 1.0) fontSize = 12.0;
+  double pen = 0.0;
+  size_t i = 0;
+  while (i < textLen && i < stopByte) {
+    uint32_t cp = 0;
+    int step = chengTextUtf8Decode((const unsigned char *)text + i, textLen - i, &cp);
+    if (step <= 0 || i + (size_t)step > stopByte) break;
+    pen += chengTextAdvance(slot, cp, fontSize);
+    i += (size_t)step;
+  }
+  return pen;
+}
+
+static int32_t chengTextIndexAt(int slot, const char *text, double fontSize, double x) {
+  if (text == NULL || x <= 0.0) return 0;
+  if (fontSize <= 1.0) fontSize = 12.0;
+  size_t len = strlen(text);
+  double pen = 0.0;
+  size_t i = 0;
+  while (i < len) {
+    uint32_t cp = 0;
+    int step = chengTextUtf8Decode((const unsigned char *)text + i, len - i, &cp);
+    if (step <= 0) break;
+    double advance = chengTextAdvance(slot, cp, fontSize);
+    if (x < pen + advance * 0.5) return (int32_t)i;
+    pen += advance;
+    i += (size_t)step;
+  }
+  return (int32_t)len;
+}
+
+static void chengTextBlendGlyph(uint8_t *pixels,
+                                int width,
+                                int height,
+                                int strideBytes,
+                                const ChengTextGlyph *glyph,
+                                int originX,
+                                int originY,
+                                int clipX0,
+                                int clipY0,
+                                int clipX1,
+                                int clipY1,
+                                uint32_t color) {
+  int x0 = originX + glyph->left;
+  int y0 = originY + glyph->top;
+  int gx0 = x0 < clipX0 ? clipX0 - x0 : 0;
+  int gy0 = y0 < clipY0 ? clipY0 - y0 : 0;
+  int gx1 = glyph->width;
+  int gy1 = glyph->height;
+  if (x0 + gx1 > clipX1) gx1 = clipX1 - x0;
+  if (y0 + gy1 > clipY1) gy1 = clipY1 - y0;
+  if (gx0 >= gx1 || gy0 >= gy1) return;
+  (void)width;
+  (void)height;
+  for (int gy = gy0; gy < gy1; gy++) {
+    const uint8_t *cov = gChengTextAtlas + (size_t)(glyph->atlasY + gy) * CHENG_TEXT_ATLAS_SIZE + glyph->atlasX;
+    uint32_t *dst = (uint32_t *)(pixels + (size_t)(y0 + gy) * (size_t)strideBytes) + x0;
+    chengGuiKernelBlendMaskRow(dst + gx0, cov + gx0, gx1 - gx0, color);
+  }
+}
+
+static int chengTextDraw(int slot,
+                         void *pixels,
+                         int width,
+                         int height,
+                         int strideBytes,
+                         double x,
+                         double y,
+                         double w,
+                         double h,
+                         uint32_t color,
+                         double fontSize,
+                         const char *text,
+                         size_t textLen) {
+  if (pixels == NULL || text == NULL) return -1;
+  if (width <= 0 || height <= 0) return -2;
+  if (strideBytes <= 0) strideBytes = width * 4;
+  if (fontSize <= 1.0) fontSize = 12.0;
+  ChengTtfFont *baseFont = chengTextFont(slot);
+  if (baseFont == NULL && slot != ChengTextFontIcon) {
+    baseFont = chengTextFont(slot == ChengTextFontUi ? ChengTextFontCode : ChengTextFontUi);
+  }
+  if (baseFont == NULL) return -6;
+  if (((color >> 24) & 0xFFu) == 0) return 0;
+
+  int clipX0 = 0, clipY0 = 0, clipX1 = width, clipY1 = height;
+  if (w > 0.0 && h > 0.0) {
+    int rx0 = (int)floor(x);
+    int ry0 = (int)floor(y);
+    int rx1 = (int)ceil(x + w);
+    int ry1 = (int)ceil(y + h);
+    if (rx0 > clipX0) clipX0 = rx0;
+    if (ry0 > clipY0) clipY0 = ry0;
+    if (rx1 < clipX1) clipX1 = rx1;
+    if (ry1 < clipY1) clipY1 = ry1;
+  }
+  if (clipX0 >= clipX1 || clipY0 >= clipY1) return 0;
+
+  double unitScale = fontSize / (double)baseFont->unitsPerEm;
+  double ascent = (double)baseFont->ascent * unitScale;
+  double textHeight = ((double)baseFont->ascent - (double)baseFont->descent) * unitScale;
+  double baselineY = y + ascent;
+  if (h > 0.0 && textHeight > 0.0 && h > textHeight) {
+    baselineY = y + (h - textHeight) * 0.5 + ascent;
+  }
+  int originY = (int)lround(baselineY);
+  double pen = x;
+  size_t i = 0;
+  while (i < textLen) {
+    uint32_t cp = 0;
+    int step = chengTextUtf8Decode((const unsigned char *)text + i, textLen - i, &cp);
+    if (step <= 0) break;
+    i += (size_t)step;
+    uint32_t glyphIndex = 0;
+    int resolvedSlot = slot;
+    ChengTtfFont *font = chengTextResolveGlyph(slot, cp, &glyphIndex, &resolvedSlot);
+    if (font == NULL) continue;
+    double advance = (double)chengTtfAdvanceUnits(font, glyphIndex) * fontSize / (double)font->unitsPerEm;
+    if (cp != ' ' && cp != '\t' && pen < (double)clipX1) {
+      ChengTextGlyph *glyph = chengTextLookupGlyph(resolvedSlot, font, fontSize, glyphIndex);
+      if (glyph != NULL && glyph->width > 0) {
+        chengTextBlendGlyph((uint8_t *)pixels, width, height, strideBytes, glyph, (int)lround(pen), originY,
+                            clipX0, clipY0, clipX1, clipY1, color);
+      }
+    }
+    pen += advance;
+  }
+  return 0;
+}
+
+static size_t chengTextSafeLen(const char *text) {
+  if (text == NULL) return 0;
+  return strnlen(text, (size_t)(1u << 20));
+}
+
+int chengGuiDrawTextBgra(void *pixels,
+                         int width,
+                         int height,
+                         int strideBytes,
+                         double x,
+                         double y,
+                         double w,
+                         double h,
+                         uint32_t color,
+                         double fontSize,
+                         const char *text) {
+  return chengTextDraw(ChengTextFontUi, pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text,
+                       chengTextSafeLen(text));
+}
+
+int chengGuiDrawTextBgraLen(void *pixels,
+                            int width,
+                            int height,
+                            int strideBytes,
+                            double x,
+                            double y,
+                            double w,
+                            double h,
+                            uint32_t color,
+                            double fontSize,
+                            const char *text,
+                            int textLen) {
+  if (text == NULL) return -1;
+  if (textLen < 0) return -11;
+  return chengTextDraw(ChengTextFontUi, pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text,
+                       (size_t)textLen);
+}
+
+int chengGuiLinuxDrawTextBgraCode(void *pixels,
+                                  int width,
+                                  int height,
+                                  int strideBytes,
+                                  double x,
+                                  double y,
+                                  double w,
+                                  double h,
+                                  uint32_t color,
+                                  double fontSize,
+                                  const char *text) {
+  return chengTextDraw(ChengTextFontCode, pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text,
+                       chengTextSafeLen(text));
+}
+
+int chengGuiLinuxDrawTextBgraIcon(void *pixels,
+                                  int width,
+                                  int height,
+                                  int strideBytes,
+                                  double x,
+                                  double y,
+                                  double w,
+                                  double h,
+                                  uint32_t color,
+                                  double fontSize,
+                                  const char *text) {
+  return chengTextDraw(ChengTextFontIcon, pixels, width, height, strideBytes, x, y, w, h, color, fontSize, text,
+                       chengTextSafeLen(text));
+}
+
+double chengGuiTextWidth(const char *text, double fontSize) {
+  return chengTextMeasure(ChengTextFontUi, text, chengTextSafeLen(text), fontSize, SIZE_MAX);
+}
+
+double chengGuiTextWidthCode(const char *text, double fontSize) {
+  return chengTextMeasure(ChengTextFontCode, text, chengTextSafeLen(text), fontSize, SIZE_MAX);
+}
+
+double chengGuiTextWidthIcon(const char *text, double fontSize) {
+  if (chengTextFont(ChengTextFontIcon) == NULL) return 0.0;
+  return chengTextMeasure(ChengTextFontIcon, text, chengTextSafeLen(text), fontSize, SIZE_MAX);
+}
+
+double chengGuiTextWidthFileIcon(const char *text, double fontSize) {
+  (void)text;
+  (void)fontSize;
+  return 0.0;
+}
+
+double chengGuiTextXAtIndex(const char *text, double fontSize, int32_t byteIndex) {
+  if (byteIndex <= 0) return 0.0;
+  return chengTextMeasure(ChengTextFontUi, text, chengTextSafeLen(text), fontSize, (size_t)byteIndex);
+}
+
+double chengGuiTextXAtIndexCode(const char *text, double fontSize, int32_t byteIndex) {
+  if (byteIndex <= 0) return 0.0;
+  return chengTextMeasure(ChengTextFontCode, text, chengTextSafeLen(text), fontSize, (size_t)byteIndex);
+}
+
+/* Fills outX[0..textLen] with the pen position of every byte: bytes inside a
+   codepoint share its start position and outX[textLen] is the line width. */
+int chengGuiTextByteAdvancesCode(const char *text, int textLen, double fontSize, double *outX) {
+  if (text == NULL || outX == NULL || textLen < 0) return -1;
+  if (fontSize <= 1.0) fontSize = 12.0;
+  if (chengTextFont(ChengTextFontCode) == NULL && chengTextFont(ChengTextFontUi) == NULL) return -6;
+  double pen = 0.0;
+  size_t len = (size_t)textLen;
+  size_t i = 0;
+  while (i < len) {
+    uint32_t cp = 0;
+    int step = chengTextUtf8Decode((const unsigned char *)text + i, len - i, &cp);
+    if (step <= 0) break;
+    for (int k = 0; k < step; k++) outX[i + (size_t)k] = pen;
+    pen += chengTextAdvance(ChengTextFontCode, cp, fontSize);
+    i += (size_t)step;
+  }
+  outX[len] = pen;
+  return 0;
+}
+
+int32_t chengGuiTextIndexAtX(const char *text, double fontSize, double x) {
+  return chengTextIndexAt(ChengTextFontUi, text, fontSize, x);
+}
+
+int32_t chengGuiTextIndexAtXCode(const char *text, double fontSize, double x) {
+  return chengTextIndexAt(ChengTextFontCode, text, fontSize, x);
+}
+
+int chengGuiIconFontAvailable(void) {
+  ChengTtfFont *font = chengTextFont(ChengTextFontIcon);
+  return font != NULL && chengTtfGlyphIndex(font, 0xEAF0u) != 0 ? 1 : 0;
+}
+
+int chengGuiFileIconFontAvailable(void) {
+  /* The file icon font ships as WOFF, which this backend does not decode. */
+  return 0;
+}
+
+int chengGuiNativeTextAvailable(void) {
+  return chengTextFont(ChengTextFontUi) != NULL || chengTextFont(ChengTextFontCode) != NULL ? 1 : 0;
+}
+
+const char *chengGuiNativeTextBackend(void) {
+  return chengGuiNativeTextAvailable() ? "linux-ttf-atlas" : "unavailable";
+}
+
+int chengGuiTextAtlasStats(ChengGuiTextAtlasStats *stats) {
+  if (stats == NULL) return -1;
+  *stats = gChengTextStats;
+  return 0;
+}
+
+size_t chengGuiTextAtlasStatsStructSize(void) {
+  return sizeof(ChengGuiTextAtlasStats);
+}
+
+void chengGuiTextAtlasLogSummary(const char *tag) {
+  const ChengGuiTextAtlasStats *s = &gChengTextStats;
+  double hitRate = s->lookups > 0 ? (double)s->hits * 100.0 / (double)s->lookups : 0.0;
+  fprintf(stderr,
+          "[%s] text backend=%s lookups=%lld hits=%lld hitRate=%.1f%% rasterMs=%.3f glyphs=%d resets=%lld\n",
+          tag != NULL ? tag : "gui-text",
+          chengGuiNativeTextBackend(),
+          (long long)s->lookups,
+          (long long)s->hits,
+          hitRate,
+          s->rasterMs,
+          (int)s->glyphCount,
+          (long long)s->atlasResets);
+}
@@ -1676,6 +1676,66 @@ double chengGuiTextXAtIndexCode(const char *text, double fontSize, int32_t byteI
   return x;
 }
 
+int chengGuiTextByteAdvancesCode(const char *text, int textLen, double fontSize, double *outX) {
+  if (text == NULL || outX == NULL || textLen < 0) return -1;
+  if (fontSize <= 1.0) fontSize = 12.0;
+  if (textLen == 0) {
+    outX[0] = 0.0;
+    return 0;
+  }
+
+  CFStringRef cfText = chengCreateUtf8StringLen(text, (size_t)textLen);
+  if (cfText == NULL) return -5;
+  CTFontRef font = createChengFont(fontSize);
+  if (font == NULL) {
+    CFRelease(cfText);
+    return -6;
+  }
+
+  const void *keys[] = {kCTFontAttributeName};
+  const void *values[] = {font};
+  CFDictionaryRef attrs = CFDictionaryCreate(kCFAllocatorDefault,
+                                             keys,
+                                             values,
+                                             1,
+                                             &kCFTypeDictionaryKeyCallBacks,
+                                             &kCFTypeDictionaryValueCallBacks);
+  if (attrs == NULL) {
+    CFRelease(font);
+    CFRelease(cfText);
+    return -8;
+  }
+
+  CFAttributedStringRef attrString = CFAttributedStringCreate(kCFAllocatorDefault, cfText, attrs);
+  CFRelease(attrs);
+  CFRelease(cfText);
+  CFRelease(font);
+  if (attrString == NULL) return -9;
+
+  CTLineRef line = CTLineCreateWithAttributedString(attrString);
+  CFRelease(attrString);
+  if (line == NULL) return -10;
+
+  // One pass over the UTF-8 bytes: every byte of a codepoint maps to the
+  // offset of that codepoint's first UTF-16 unit.
+  CFIndex utf16 = 0;
+  int32_t i = 0;
+  while (i < textLen) {
+    uint32_t cp = 0;
+    int step = utf8Decode((const unsigned char *)text + i, textLen - i, &cp);
+    if (step <= 0) break;
+    double x = CTLineGetOffsetForStringIndex(line, utf16, NULL);
+    if (x < 0.0) x = 0.0;
+    for (int k = 0; k < step && i + k < textLen; k++) outX[i + k] = x;
+    utf16 += (CFIndex)utf16UnitsForCodepoint(cp);
+    i += step;
+  }
+  double width = CTLineGetTypographicBounds(line, NULL, NULL, NULL);
+  CFRelease(line);
+  outX[textLen] = width < 0.0 ? 0.0 : width;
+  return 0;
+}
+
 int32_t chengGuiTextIndexAtXCode(const char *text, double fontSize, double x) {
   if (text == NULL) return 0;
   if (fontSize <= 1.0) fontSize = 12.0;
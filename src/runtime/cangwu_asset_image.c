@@ -0,0 +1,1625 @@
+#include "cangwu_asset_image.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define CW_FOURCC(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#define SEC_STRINGS CW_FOURCC('S', 'T', 'R', 'S')
+#define SEC_SINGLES CW_FOURCC('S', 'N', 'G', 'L')
+#define SEC_PHRASES CW_FOURCC('P', 'H', 'R', 'S')
+#define SEC_REVERSE CW_FOURCC('R', 'V', 'R', 'S')
+#define SEC_DICT CW_FOURCC('D', 'I', 'C', 'T')
+#define SEC_DICT_BMP CW_FOURCC('D', 'B', 'M', 'P')
+#define SEC_DICT_NONBMP_CP CW_FOURCC('D', 'N', 'B', 'C')
+#define SEC_DICT_NONBMP_IDX CW_FOURCC('D', 'N', 'B', 'I')
+#define SEC_GBK CW_FOURCC('L', 'G', 'B', 'K')
+#define SEC_GB2312 CW_FOURCC('L', 'G', 'B', '2')
+#define SEC_SOURCES CW_FOURCC('S', 'R', 'C', 'S')
+
+static const uint32_t kIndexSections[CW_IMAGE_INDEX_COUNT] = {
+    CW_FOURCC('I', 'X', 'R', 'V'),
+};
+
+static const uint32_t kTrieSections[CW_IMAGE_TRIE_COUNT] = {
+    CW_FOURCC('T', 'R', 'S', 'G'),
+    CW_FOURCC('T', 'R', 'P', 'H'),
+};
+
+/* check[] of a free slot and of the root. */
+#define TRIE_FREE (-1)
+#define TRIE_ROOT (-2)
+
+static const char kImageMagic[8] = {'C', 'W', 'I', 'M', 'G', '\r', '\n', 0x1a};
+
+/* Recorded so a rebuilt TSV invalidates the image; the phrase table may be absent. */
+static const char* const kSourceFiles[] = {
+    "cangwu_single_v1.tsv",
+    "cangwu_phrase_v1.tsv",
+    "cangwu_reverse_v1.tsv",
+    "utfzh_dict_v1.tsv",
+    "legacy_gbk_to_u_v1.tsv",
+    "legacy_gb2312_to_u_v1.tsv",
+};
+#define SOURCE_FILE_COUNT (sizeof(kSourceFiles) / sizeof(kSourceFiles[0]))
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t file_size;
+    uint64_t payload_hash;
+    uint64_t header_hash;
+    uint32_t header_size;
+    uint32_t flags;
+    uint8_t reserved[16];
+} ImageHeader;
+
+typedef struct {
+    uint32_t id;
+    uint32_t count;
+    uint64_t offset;
+    uint64_t size;
+} ImageSection;
+
+typedef struct {
+    int64_t size;
+    int64_t mtime;
+} ImageSource;
+
+#define MAX_SECTIONS 24
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void set_err(char* err, size_t err_len, const char* fmt, ...) {
+    if (err == NULL || err_len == 0) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(err, err_len, fmt, ap);
+    va_end(ap);
+}
+
+/* FNV-1a over 64-bit words, bytes for the tail; ~8x faster than bytewise. */
+static uint64_t hash_bytes(uint64_t h, const unsigned char* data, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h ^= word;
+        h *= 1099511628211ull;
+    }
+    for (; i < len; i++) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static bool path_join(char* out, size_t cap, const char* dir, const char* name) {
+    int n = snprintf(out, cap, "%s/%s", dir, name);
+    return n > 0 && (size_t)n < cap;
+}
+
+static void source_stat(const char* data_root, size_t i, ImageSource* out) {
+    char path[4096];
+    struct stat st;
+    out->size = -1;
+    out->mtime = 0;
+    if (path_join(path, sizeof(path), data_root, kSourceFiles[i]) && stat(path, &st) == 0) {
+        out->size = (int64_t)st.st_size;
+        out->mtime = (int64_t)st.st_mtime;
+    }
+}
+
+/* ---- builder ---- */
+
+typedef struct {
+    unsigned char* data;
+    size_t len;
+    size_t cap;
+} Vec;
+
+static bool vec_reserve(Vec* v, size_t need) {
+    if (need <= v->cap) {
+        return true;
+    }
+    size_t cap = v->cap > 0 ? v->cap : 4096;
+    while (cap < need) {
+        cap *= 2;
+    }
+    unsigned char* next = (unsigned char*)realloc(v->data, cap);
+    if (next == NULL) {
+        return false;
+    }
+    v->data = next;
+    v->cap = cap;
+    return true;
+}
+
+static bool vec_push(Vec* v, const void* data, size_t len) {
+    if (!vec_reserve(v, v->len + len)) {
+        return false;
+    }
+    if (len > 0) {
+        memcpy(v->data + v->len, data, len);
+    }
+    v->len += len;
+    return true;
+}
+
+static bool vec_pad8(Vec* v) {
+    static const unsigned char zeros[8] = {0};
+    size_t pad = (8 - (v->len & 7u)) & 7u;
+    return vec_push(v, zeros, pad);
+}
+
+/* Interned NUL-terminated strings; offset 0 is the empty string. */
+typedef struct {
+    Vec bytes;
+    uint32_t* slots;
+    size_t slot_cap;
+    size_t used;
+} StringPool;
+
+static uint64_t hash_str(const char* s, size_t len) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static bool pool_init(StringPool* pool) {
+    memset(pool, 0, sizeof(*pool));
+    pool->slot_cap = 1u << 16;
+    pool->slots = (uint32_t*)calloc(pool->slot_cap, sizeof(uint32_t));
+    if (pool->slots == NULL) {
+        return false;
+    }
+    return vec_push(&pool->bytes, "", 1);
+}
+
+static void pool_free(StringPool* pool) {
+    free(pool->bytes.data);
+    free(pool->slots);
+    memset(pool, 0, sizeof(*pool));
+}
+
+static bool pool_grow(StringPool* pool) {
+    size_t cap = pool->slot_cap * 2;
+    uint32_t* slots = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    if (slots == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < pool->slot_cap; i++) {
+        uint32_t off = pool->slots[i];
+        if (off == 0) {
+            continue;
+        }
+        const char* s = (const char*)pool->bytes.data + off;
+        size_t pos = (size_t)hash_str(s, strlen(s)) & (cap - 1);
+        while (slots[pos] != 0) {
+            pos = (pos + 1) & (cap - 1);
+        }
+        slots[pos] = off;
+    }
+    free(pool->slots);
+    pool->slots = slots;
+    pool->slot_cap = cap;
+    return true;
+}
+
+static bool pool_add_len(StringPool* pool, const char* s, size_t len, uint32_t* out) {
+    if (len == 0) {
+        *out = 0;
+        return true;
+    }
+    if ((pool->used + 1) * 2 > pool->slot_cap && !pool_grow(pool)) {
+        return false;
+    }
+    size_t pos = (size_t)hash_str(s, len) & (pool->slot_cap - 1);
+    while (pool->slots[pos] != 0) {
+        const char* old = (const char*)pool->bytes.data + pool->slots[pos];
+        if (strncmp(old, s, len) == 0 && old[len] == '\0') {
+            *out = pool->slots[pos];
+            return true;
+        }
+        pos = (pos + 1) & (pool->slot_cap - 1);
+    }
+    if (pool->bytes.len + len + 1 > UINT32_MAX) {
+        return false;
+    }
+    uint32_t off = (uint32_t)pool->bytes.len;
+    if (!vec_push(&pool->bytes, s, len) || !vec_push(&pool->bytes, "", 1)) {
+        return false;
+    }
+    pool->slots[pos] = off;
+    pool->used += 1;
+    *out = off;
+    return true;
+}
+
+static bool pool_add(StringPool* pool, const char* s, uint32_t* out) {
+    return pool_add_len(pool, s, strlen(s), out);
+}
+
+/* Same as cwNormalizeCodeInput: keep ASCII letters, upper-cased. */
+static bool pool_add_code(StringPool* pool, const char* s, uint32_t* out) {
+    char buf[64];
+    size_t n = 0;
+    for (; *s != '\0' && n + 1 < sizeof(buf); s++) {
+        char ch = *s;
+        if (ch >= 'a' && ch <= 'z') {
+            buf[n++] = (char)(ch - 'a' + 'A');
+        } else if (ch >= 'A' && ch <= 'Z') {
+            buf[n++] = ch;
+        }
+    }
+    return pool_add_len(pool, buf, n, out);
+}
+
+static uint32_t struct_from_label(const char* text) {
+    if (strcmp(text, "UD") == 0) {
+        return 1;
+    }
+    if (strcmp(text, "ENC") == 0) {
+        return 2;
+    }
+    if (strcmp(text, "MIX") == 0) {
+        return 3;
+    }
+    return 0;
+}
+
+typedef struct {
+    char* data;
+    size_t len;
+    char* cursor;
+} TsvFile;
+
+static bool tsv_open(const char* path, TsvFile* out) {
+    memset(out, 0, sizeof(*out));
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    long size = ok ? ftell(f) : -1;
+    ok = ok && size >= 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        out->data = (char*)malloc((size_t)size + 1);
+        ok = out->data != NULL && fread(out->data, 1, (size_t)size, f) == (size_t)size;
+    }
+    fclose(f);
+    if (!ok) {
+        free(out->data);
+        out->data = NULL;
+        return false;
+    }
+    out->data[size] = '\0';
+    out->len = (size_t)size;
+    out->cursor = out->data;
+    return true;
+}
+
+static bool is_trim_char(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+/*
+ * Next data row split in place, with the Cheng loader's rules: the line is
+ * trimmed, blank and '#' lines are skipped. Returns the column count, or -1
+ * at end of file.
+ */
+static int tsv_next(TsvFile* tsv, char** cols, int max_cols) {
+    char* end = tsv->data + tsv->len;
+    while (tsv->cursor < end) {
+        char* line = tsv->cursor;
+        char* nl = memchr(line, '\n', (size_t)(end - line));
+        char* stop = nl != NULL ? nl : end;
+        tsv->cursor = nl != NULL ? nl + 1 : end;
+        while (line < stop && is_trim_char(*line)) {
+            line++;
+        }
+        while (stop > line && is_trim_char(stop[-1])) {
+            stop--;
+        }
+        if (line == stop || *line == '#') {
+            continue;
+        }
+        *stop = '\0';
+        int n = 0;
+        cols[n++] = line;
+        for (char* p = line; *p != '\0' && n < max_cols; p++) {
+            if (*p == '\t') {
+                *p = '\0';
+                cols[n++] = p + 1;
+            }
+        }
+        return n;
+    }
+    return -1;
+}
+
+static int64_t parse_i64(const char* text) {
+    return (int64_t)strtoll(text, NULL, 10);
+}
+
+static int hex_key(const char* text) {
+    if (strlen(text) != 4) {
+        return -1;
+    }
+    int out = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = text[i];
+        int nibble = -1;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = 10 + c - 'A';
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = 10 + c - 'a';
+        }
+        if (nibble < 0) {
+            return -1;
+        }
+        out = (out << 4) | nibble;
+    }
+    return out;
+}
+
+typedef struct {
+    uint32_t key;
+    uint32_t id;
+} IndexPair;
+
+typedef struct {
+    IndexPair* items;
+    size_t len;
+    size_t cap;
+} IndexPairs;
+
+static bool pairs_push(IndexPairs* pairs, uint32_t key, uint32_t id) {
+    if (key == 0) {
+        return true;
+    }
+    if (pairs->len == pairs->cap) {
+        size_t cap = pairs->cap > 0 ? pairs->cap * 2 : 1024;
+        IndexPair* next = (IndexPair*)realloc(pairs->items, cap * sizeof(IndexPair));
+        if (next == NULL) {
+            return false;
+        }
+        pairs->items = next;
+        pairs->cap = cap;
+    }
+    pairs->items[pairs->len].key = key;
+    pairs->items[pairs->len].id = id;
+    pairs->len += 1;
+    return true;
+}
+
+static const char* g_sort_strings = NULL;
+
+static int cmp_index_pair(const void* a, const void* b) {
+    const IndexPair* pa = (const IndexPair*)a;
+    const IndexPair* pb = (const IndexPair*)b;
+    if (pa->key != pb->key) {
+        int c = strcmp(g_sort_strings + pa->key, g_sort_strings + pb->key);
+        if (c != 0) {
+            return c;
+        }
+    }
+    if (pa->id < pb->id) return -1;
+    if (pa->id > pb->id) return 1;
+    return 0;
+}
+
+static int cmp_legacy_pair(const void* a, const void* b) {
+    const CwImageLegacyPair* pa = (const CwImageLegacyPair*)a;
+    const CwImageLegacyPair* pb = (const CwImageLegacyPair*)b;
+    if (pa->key < pb->key) return -1;
+    if (pa->key > pb->key) return 1;
+    return 0;
+}
+
+static int cmp_i32_pair(const void* a, const void* b) {
+    const int32_t* pa = (const int32_t*)a;
+    const int32_t* pb = (const int32_t*)b;
+    if (pa[0] < pb[0]) return -1;
+    if (pa[0] > pb[0]) return 1;
+    return 0;
+}
+
+typedef struct {
+    StringPool pool;
+    Vec singles;
+    Vec phrases;
+    Vec reverse;
+    Vec dict;
+    Vec gbk;
+    Vec gb2312;
+    int32_t* dict_bmp;
+    Vec nonbmp;
+    IndexPairs index[CW_IMAGE_INDEX_COUNT];
+    IndexPairs codes[CW_IMAGE_TRIE_COUNT];
+    ImageSource sources[SOURCE_FILE_COUNT];
+} Builder;
+
+static void builder_free(Builder* b) {
+    pool_free(&b->pool);
+    free(b->singles.data);
+    free(b->phrases.data);
+    free(b->reverse.data);
+    free(b->dict.data);
+    free(b->gbk.data);
+    free(b->gb2312.data);
+    free(b->dict_bmp);
+    free(b->nonbmp.data);
+    for (int i = 0; i < CW_IMAGE_INDEX_COUNT; i++) {
+        free(b->index[i].items);
+    }
+    for (int i = 0; i < CW_IMAGE_TRIE_COUNT; i++) {
+        free(b->codes[i].items);
+    }
+}
+
+static bool load_singles(Builder* b, const char* path, char* err, size_t err_len) {
+    TsvFile tsv;
+    if (!tsv_open(path, &tsv)) {
+        set_err(err, err_len, "cannot read %s", path);
+        return false;
+    }
+    char* cols[8];
+    int n;
+    bool ok = true;
+    while (ok && (n = tsv_next(&tsv, cols, 8)) >= 0) {
+        if (n < 6) {
+            continue;
+        }
+        CwImageSingle rec;
+        memset(&rec, 0, sizeof(rec));
+        uint32_t id = (uint32_t)(b->singles.len / sizeof(rec));
+        ok = pool_add(&b->pool, cols[0], &rec.text) && pool_add_code(&b->pool, cols[1], &rec.code) &&
+             pool_add_code(&b->pool, cols[3], &rec.canonical) && pool_add(&b->pool, cols[5], &rec.pinyin);
+        rec.struct_kind = struct_from_label(cols[2]);
+        rec.freq = parse_i64(cols[4]);
+        ok = ok && vec_push(&b->singles, &rec, sizeof(rec)) && pairs_push(&b->codes[CW_IMAGE_TRIE_SINGLES], rec.code, id);
+    }
+    free(tsv.data);
+    if (!ok) {
+        set_err(err, err_len, "out of memory reading %s", path);
+    }
+    return ok;
+}
+
+static bool load_phrases(Builder* b, const char* path, char* err, size_t err_len) {
+    TsvFile tsv;
+    if (!tsv_open(path, &tsv)) {
+        /* Optional, as in cwParsePhrases. */
+        return true;
+    }
+    char* cols[4];
+    int n;
+    bool ok = true;
+    while (ok && (n = tsv_next(&tsv, cols, 4)) >= 0) {
+        if (n < 3) {
+            continue;
+        }
+        CwImagePhrase rec;
+        memset(&rec, 0, sizeof(rec));
+        uint32_t id = (uint32_t)(b->phrases.len / sizeof(rec));
+        ok = pool_add(&b->pool, cols[0], &rec.text) && pool_add_code(&b->pool, cols[1], &rec.code);
+        rec.freq = parse_i64(cols[2]);
+        ok = ok && vec_push(&b->phrases, &rec, sizeof(rec)) && pairs_push(&b->codes[CW_IMAGE_TRIE_PHRASES], rec.code, id);
+    }
+    free(tsv.data);
+    if (!ok) {
+        set_err(err, err_len, "out of memory reading %s", path);
+    }
+    return ok;
+}
+
+static bool load_reverse(Builder* b, const char* path, char* err, size_t err_len) {
+    TsvFile tsv;
+    if (!tsv_open(path, &tsv)) {
+        set_err(err, err_len, "cannot read %s", path);
+        return false;
+    }
+    char* cols[9];
+    char key[512];
+    int n;
+    bool ok = true;
+    while (ok && (n = tsv_next(&tsv, cols, 9)) >= 0) {
+        if (n < 8) {
+            continue;
+        }
+        CwImageReverse rec;
+        memset(&rec, 0, sizeof(rec));
+        uint32_t id = (uint32_t)(b->reverse.len / sizeof(rec));
+        ok = pool_add(&b->pool, cols[0], &rec.mode) && pool_add(&b->pool, cols[1], &rec.key) &&
+             pool_add(&b->pool, cols[2], &rec.text) && pool_add_code(&b->pool, cols[3], &rec.code) &&
+             pool_add_code(&b->pool, cols[4], &rec.canonical) && pool_add(&b->pool, cols[7], &rec.pinyin);
+        rec.struct_kind = struct_from_label(cols[5]);
+        rec.freq = parse_i64(cols[6]);
+        int klen = snprintf(key, sizeof(key), "%s:%s", cols[0], cols[1]);
+        uint32_t key_off = 0;
+        ok = ok && klen > 0 && (size_t)klen < sizeof(key) && pool_add(&b->pool, key, &key_off) &&
+             vec_push(&b->reverse, &rec, sizeof(rec)) && pairs_push(&b->index[CW_IMAGE_INDEX_REVERSE], key_off, id);
+    }
+    free(tsv.data);
+    if (!ok) {
+        set_err(err, err_len, "bad row or out of memory reading %s", path);
+    }
+    return ok;
+}
+
+static bool load_dict(Builder* b, const char* path, char* err, size_t err_len) {
+    TsvFile tsv;
+    if (!tsv_open(path, &tsv)) {
+        set_err(err, err_len, "cannot read %s", path);
+        return false;
+    }
+    b->dict_bmp = (int32_t*)calloc(65536u, sizeof(int32_t));
+    if (b->dict_bmp == NULL) {
+        free(tsv.data);
+        set_err(err, err_len, "out of memory");
+        return false;
+    }
+    char* cols[5];
+    int n;
+    bool ok = true;
+    while (ok && (n = tsv_next(&tsv, cols, 5)) >= 0) {
+        if (n < 3) {
+            continue;
+        }
+        int32_t row = (int32_t)(b->dict.len / sizeof(CwImageDictRow));
+        long idx = strtol(cols[0], NULL, 10);
+        long cp = strtol(cols[2], NULL, 10);
+        if (idx != row || cp < 0 || cp > 0x10FFFF) {
+            /* The Cheng loader numbers rows, the C one trusts column 0: keep them equal. */
+            set_err(err, err_len, "%s: row %d has index %ld code point %ld", path, row, idx, cp);
+            ok = false;
+            break;
+        }
+        CwImageDictRow rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.cp = (int32_t)cp;
+        rec.freq = n >= 4 ? parse_i64(cols[3]) : 0;
+        ok = pool_add(&b->pool, cols[1], &rec.text) && vec_push(&b->dict, &rec, sizeof(rec));
+        if (cp < 65536) {
+            b->dict_bmp[cp] = row + 1;
+        } else {
+            int32_t pair[2] = {(int32_t)cp, row};
+            ok = ok && vec_push(&b->nonbmp, pair, sizeof(pair));
+        }
+        if (!ok) {
+            set_err(err, err_len, "out of memory reading %s", path);
+        }
+    }
+    free(tsv.data);
+    if (ok && b->nonbmp.len > 2 * sizeof(int32_t)) {
+        qsort(b->nonbmp.data, b->nonbmp.len / (2 * sizeof(int32_t)), 2 * sizeof(int32_t), cmp_i32_pair);
+    }
+    return ok;
+}
+
+static bool load_legacy(Vec* out, const char* path, char* err, size_t err_len) {
+    TsvFile tsv;
+    if (!tsv_open(path, &tsv)) {
+        set_err(err, err_len, "cannot read %s", path);
+        return false;
+    }
+    char* cols[3];
+    int n;
+    bool ok = true;
+    while (ok && (n = tsv_next(&tsv, cols, 3)) >= 0) {
+        if (n < 2) {
+            continue;
+        }
+        int key = hex_key(cols[0]);
+        long cp = strtol(cols[1], NULL, 10);
+        if (key < 0 || cp < 0 || cp > 0x10FFFF) {
+            continue;
+        }
+        CwImageLegacyPair pair = {(int32_t)key, (int32_t)cp};
+        ok = vec_push(out, &pair, sizeof(pair));
+    }
+    free(tsv.data);
+    if (!ok) {
+        set_err(err, err_len, "out of memory reading %s", path);
+        return false;
+    }
+    if (out->len > sizeof(CwImageLegacyPair)) {
+        qsort(out->data, out->len / sizeof(CwImageLegacyPair), sizeof(CwImageLegacyPair), cmp_legacy_pair);
+    }
+    return true;
+}
+
+/* Index section: sorted keys[count], then the ids of every key back to back. */
+static bool emit_index(Builder* b, IndexPairs* pairs, Vec* out, uint32_t* key_count) {
+    g_sort_strings = (const char*)b->pool.bytes.data;
+    if (pairs->len > 1) {
+        qsort(pairs->items, pairs->len, sizeof(IndexPair), cmp_index_pair);
+    }
+    g_sort_strings = NULL;
+    *key_count = 0;
+    for (size_t i = 0; i < pairs->len; i++) {
+        if (i == 0 || pairs->items[i].key != pairs->items[i - 1].key) {
+            *key_count += 1;
+        }
+    }
+    if (!vec_reserve(out, (size_t)*key_count * sizeof(CwImageIndexKey) + pairs->len * sizeof(uint32_t))) {
+        return false;
+    }
+    size_t i = 0;
+    while (i < pairs->len) {
+        size_t j = i;
+        while (j < pairs->len && pairs->items[j].key == pairs->items[i].key) {
+            j++;
+        }
+        CwImageIndexKey key = {pairs->items[i].key, (uint32_t)i, (uint32_t)(j - i), 0};
+        vec_push(out, &key, sizeof(key));
+        i = j;
+    }
+    for (i = 0; i < pairs->len; i++) {
+        vec_push(out, &pairs->items[i].id, sizeof(uint32_t));
+    }
+    return true;
+}
+
+enum { TRIE_BASE, TRIE_CHECK, TRIE_LO, TRIE_EXACT_END, TRIE_HI, TRIE_ARRAYS };
+
+typedef struct {
+    int32_t* a[TRIE_ARRAYS];
+    size_t size;
+    size_t cap;
+} TrieArrays;
+
+static bool trie_grow(TrieArrays* t, size_t size) {
+    if (size <= t->size) {
+        return true;
+    }
+    if (size > t->cap) {
+        size_t cap = t->cap > 0 ? t->cap : 4096;
+        while (cap < size) {
+            cap *= 2;
+        }
+        for (int k = 0; k < TRIE_ARRAYS; k++) {
+            int32_t* next = (int32_t*)realloc(t->a[k], cap * sizeof(int32_t));
+            if (next == NULL) {
+                return false;
+            }
+            t->a[k] = next;
+        }
+        t->cap = cap;
+    }
+    for (size_t i = t->size; i < size; i++) {
+        for (int k = 0; k < TRIE_ARRAYS; k++) {
+            t->a[k][i] = k == TRIE_CHECK ? TRIE_FREE : 0;
+        }
+    }
+    t->size = size;
+    return true;
+}
+
+typedef struct {
+    int32_t state;
+    uint32_t depth;
+    uint32_t lo;
+    uint32_t hi;
+} TrieNode;
+
+/*
+ * Trie section: base, check, lo, exact_end and hi for every state, then the
+ * row ids. Built like cwBuildCodeTrie: breadth first over the (code, row)
+ * sorted pairs, each state taking the first base whose child slots are free.
+ */
+static bool emit_trie(Builder* b, IndexPairs* pairs, Vec* out, uint32_t* state_count) {
+    const char* strings = (const char*)b->pool.bytes.data;
+    g_sort_strings = strings;
+    if (pairs->len > 1) {
+        qsort(pairs->items, pairs->len, sizeof(IndexPair), cmp_index_pair);
+    }
+    g_sort_strings = NULL;
+    /* Every state but the root consumes one code byte, so this bounds the queue. */
+    size_t max_states = 1;
+    for (size_t i = 0; i < pairs->len; i++) {
+        max_states += strlen(strings + pairs->items[i].key);
+    }
+    TrieNode* queue = (TrieNode*)malloc(max_states * sizeof(TrieNode));
+    TrieArrays t;
+    memset(&t, 0, sizeof(t));
+    bool ok = queue != NULL && trie_grow(&t, 1);
+    size_t head = 0;
+    size_t tail = 0;
+    size_t next_free = 1;
+    if (ok) {
+        t.a[TRIE_CHECK][0] = TRIE_ROOT;
+        queue[tail++] = (TrieNode){0, 0, 0, (uint32_t)pairs->len};
+    }
+    while (ok && head < tail) {
+        TrieNode node = queue[head++];
+        uint32_t i = node.lo;
+        while (i < node.hi && strings[pairs->items[i].key + node.depth] == '\0') {
+            i++;
+        }
+        t.a[TRIE_LO][node.state] = (int32_t)node.lo;
+        t.a[TRIE_EXACT_END][node.state] = (int32_t)i;
+        t.a[TRIE_HI][node.state] = (int32_t)node.hi;
+        int32_t syms[26];
+        uint32_t sym_lo[26];
+        uint32_t sym_hi[26];
+        int nsym = 0;
+        while (i < node.hi) {
+            char ch = strings[pairs->items[i].key + node.depth];
+            uint32_t j = i + 1;
+            while (j < node.hi && strings[pairs->items[j].key + node.depth] == ch) {
+                j++;
+            }
+            syms[nsym] = ch - 'A' + 1;
+            sym_lo[nsym] = i;
+            sym_hi[nsym] = j;
+            nsym++;
+            i = j;
+        }
+        if (nsym == 0) {
+            continue;
+        }
+        while (next_free < t.size && t.a[TRIE_CHECK][next_free] != TRIE_FREE) {
+            next_free++;
+        }
+        int32_t base = (int32_t)next_free - syms[0];
+        if (base < 0) {
+            base = 0;
+        }
+        for (;;) {
+            ok = trie_grow(&t, (size_t)base + (size_t)syms[nsym - 1] + 1);
+            bool fits = true;
+            for (int k = 0; ok && k < nsym; k++) {
+                if (t.a[TRIE_CHECK][base + syms[k]] != TRIE_FREE) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (!ok || fits) {
+                break;
+            }
+            base++;
+        }
+        t.a[TRIE_BASE][node.state] = base;
+        for (int k = 0; ok && k < nsym; k++) {
+            int32_t child = base + syms[k];
+            t.a[TRIE_CHECK][child] = node.state;
+            queue[tail++] = (TrieNode){child, node.depth + 1, sym_lo[k], sym_hi[k]};
+        }
+    }
+    free(queue);
+    if (ok) {
+        ok = vec_reserve(out, t.size * TRIE_ARRAYS * sizeof(int32_t) + pairs->len * sizeof(uint32_t));
+        for (int k = 0; ok && k < TRIE_ARRAYS; k++) {
+            vec_push(out, t.a[k], t.size * sizeof(int32_t));
+        }
+        for (size_t i = 0; ok && i < pairs->len; i++) {
+            vec_push(out, &pairs->items[i].id, sizeof(uint32_t));
+        }
+        *state_count = (uint32_t)t.size;
+    }
+    for (int k = 0; k < TRIE_ARRAYS; k++) {
+        free(t.a[k]);
+    }
+    return ok;
+}
+
+typedef struct {
+    ImageSection table[MAX_SECTIONS];
+    uint32_t count;
+    Vec body;
+} Layout;
+
+static bool layout_add(Layout* layout, uint32_t id, uint32_t count, const void* data, size_t size) {
+    if (layout->count >= MAX_SECTIONS || !vec_pad8(&layout->body)) {
+        return false;
+    }
+    ImageSection* sec = &layout->table[layout->count++];
+    sec->id = id;
+    sec->count = count;
+    sec->offset = layout->body.len;
+    sec->size = size;
+    return vec_push(&layout->body, data, size);
+}
+
+static bool write_image(const char* out_path, Layout* layout, char* err, size_t err_len) {
+    size_t head = sizeof(ImageHeader) + layout->count * sizeof(ImageSection);
+    size_t payload_start = (head + 7u) & ~(size_t)7u;
+    for (uint32_t i = 0; i < layout->count; i++) {
+        layout->table[i].offset += payload_start;
+    }
+    static const unsigned char zeros[8] = {0};
+    ImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kImageMagic, sizeof(header.magic));
+    header.version = CW_IMAGE_VERSION;
+    header.section_count = layout->count;
+    header.file_size = payload_start + layout->body.len;
+    header.header_size = (uint32_t)sizeof(ImageHeader);
+    /* The payload starts at payload_start; the alignment gap hashes as zeros. */
+    header.payload_hash = hash_bytes(1469598103934665603ull, layout->body.data, layout->body.len);
+    uint64_t h = hash_bytes(1469598103934665603ull, (const unsigned char*)&header, sizeof(header));
+    header.header_hash = hash_bytes(h, (const unsigned char*)layout->table, layout->count * sizeof(ImageSection));
+
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", out_path) >= (int)sizeof(tmp_path)) {
+        set_err(err, err_len, "output path too long");
+        return false;
+    }
+    FILE* f = fopen(tmp_path, "wb");
+    if (f == NULL) {
+        set_err(err, err_len, "cannot write %s: %s", tmp_path, strerror(errno));
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(layout->table, sizeof(ImageSection), layout->count, f) == layout->count &&
+              fwrite(zeros, 1, payload_start - head, f) == payload_start - head &&
+              fwrite(layout->body.data, 1, layout->body.len, f) == layout->body.len;
+    ok = (fclose(f) == 0) && ok;
+    /* Readers map the file, so replace it atomically rather than rewrite it. */
+    if (!ok || rename(tmp_path, out_path) != 0) {
+        set_err(err, err_len, "cannot write %s: %s", out_path, strerror(errno));
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+bool cw_image_build(const char* data_root, const char* out_path, char* err, size_t err_len) {
+    if (data_root == NULL || out_path == NULL) {
+        set_err(err, err_len, "missing path");
+        return false;
+    }
+    Builder b;
+    memset(&b, 0, sizeof(b));
+    Layout layout;
+    memset(&layout, 0, sizeof(layout));
+    if (!pool_init(&b.pool)) {
+        set_err(err, err_len, "out of memory");
+        return false;
+    }
+    for (size_t i = 0; i < SOURCE_FILE_COUNT; i++) {
+        source_stat(data_root, i, &b.sources[i]);
+    }
+    char paths[SOURCE_FILE_COUNT][4096];
+    for (size_t i = 0; i < SOURCE_FILE_COUNT; i++) {
+        if (!path_join(paths[i], sizeof(paths[i]), data_root, kSourceFiles[i])) {
+            set_err(err, err_len, "data root path too long");
+            builder_free(&b);
+            return false;
+        }
+    }
+    bool ok = load_singles(&b, paths[0], err, err_len) && load_phrases(&b, paths[1], err, err_len) &&
+              load_reverse(&b, paths[2], err, err_len) && load_dict(&b, paths[3], err, err_len) &&
+              load_legacy(&b.gbk, paths[4], err, err_len) && load_legacy(&b.gb2312, paths[5], err, err_len);
+
+    Vec index_bytes[CW_IMAGE_INDEX_COUNT];
+    uint32_t index_keys[CW_IMAGE_INDEX_COUNT];
+    memset(index_bytes, 0, sizeof(index_bytes));
+    memset(index_keys, 0, sizeof(index_keys));
+    for (int i = 0; ok && i < CW_IMAGE_INDEX_COUNT; i++) {
+        ok = emit_index(&b, &b.index[i], &index_bytes[i], &index_keys[i]);
+    }
+    Vec trie_bytes[CW_IMAGE_TRIE_COUNT];
+    uint32_t trie_states[CW_IMAGE_TRIE_COUNT];
+    memset(trie_bytes, 0, sizeof(trie_bytes));
+    memset(trie_states, 0, sizeof(trie_states));
+    for (int i = 0; ok && i < CW_IMAGE_TRIE_COUNT; i++) {
+        ok = emit_trie(&b, &b.codes[i], &trie_bytes[i], &trie_states[i]);
+    }
+    if (ok) {
+        size_t nonbmp_count = b.nonbmp.len / (2 * sizeof(int32_t));
+        int32_t* split = (int32_t*)malloc((nonbmp_count * 2 + 1) * sizeof(int32_t));
+        ok = split != NULL;
+        if (ok) {
+            const int32_t* pairs = (const int32_t*)b.nonbmp.data;
+            for (size_t i = 0; i < nonbmp_count; i++) {
+                split[i] = pairs[i * 2];
+                split[nonbmp_count + i] = pairs[i * 2 + 1];
+            }
+            ok = layout_add(&layout, SEC_STRINGS, (uint32_t)b.pool.bytes.len, b.pool.bytes.data, b.pool.bytes.len) &&
+                 layout_add(&layout, SEC_SINGLES, (uint32_t)(b.singles.len / sizeof(CwImageSingle)), b.singles.data,
+                            b.singles.len) &&
+                 layout_add(&layout, SEC_PHRASES, (uint32_t)(b.phrases.len / sizeof(CwImagePhrase)), b.phrases.data,
+                            b.phrases.len) &&
+                 layout_add(&layout, SEC_REVERSE, (uint32_t)(b.reverse.len / sizeof(CwImageReverse)), b.reverse.data,
+                            b.reverse.len) &&
+                 layout_add(&layout, SEC_DICT, (uint32_t)(b.dict.len / sizeof(CwImageDictRow)), b.dict.data,
+                            b.dict.len) &&
+                 layout_add(&layout, SEC_DICT_BMP, 65536u, b.dict_bmp, 65536u * sizeof(int32_t)) &&
+                 layout_add(&layout, SEC_DICT_NONBMP_CP, (uint32_t)nonbmp_count, split,
+                            nonbmp_count * sizeof(int32_t)) &&
+                 layout_add(&layout, SEC_DICT_NONBMP_IDX, (uint32_t)nonbmp_count, split + nonbmp_count,
+                            nonbmp_count * sizeof(int32_t)) &&
+                 layout_add(&layout, SEC_GBK, (uint32_t)(b.gbk.len / sizeof(CwImageLegacyPair)), b.gbk.data,
+                            b.gbk.len) &&
+                 layout_add(&layout, SEC_GB2312, (uint32_t)(b.gb2312.len / sizeof(CwImageLegacyPair)),
+                            b.gb2312.data, b.gb2312.len) &&
+                 layout_add(&layout, SEC_SOURCES, (uint32_t)SOURCE_FILE_COUNT, b.sources, sizeof(b.sources));
+            for (int i = 0; ok && i < CW_IMAGE_INDEX_COUNT; i++) {
+                ok = layout_add(&layout, kIndexSections[i], index_keys[i], index_bytes[i].data, index_bytes[i].len);
+            }
+            for (int i = 0; ok && i < CW_IMAGE_TRIE_COUNT; i++) {
+                ok = layout_add(&layout, kTrieSections[i], trie_states[i], trie_bytes[i].data, trie_bytes[i].len);
+            }
+            free(split);
+        }
+        if (!ok) {
+            set_err(err, err_len, "out of memory");
+        }
+    }
+    for (int i = 0; i < CW_IMAGE_INDEX_COUNT; i++) {
+        free(index_bytes[i].data);
+    }
+    for (int i = 0; i < CW_IMAGE_TRIE_COUNT; i++) {
+        free(trie_bytes[i].data);
+    }
+    builder_free(&b);
+    if (ok && layout.body.len > UINT32_MAX) {
+        set_err(err, err_len, "image too large");
+        ok = false;
+    }
+    ok = ok && write_image(out_path, &layout, err, err_len);
+    free(layout.body.data);
+    return ok;
+}
+
+/* ---- reader ---- */
+
+static const ImageSection* find_section(const ImageHeader* header, uint32_t id) {
+    const ImageSection* table = (const ImageSection*)(header + 1);
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        if (table[i].id == id) {
+            return &table[i];
+        }
+    }
+    return NULL;
+}
+
+static const void* section_data(const CwImage* image, const ImageHeader* header, uint32_t id, size_t rec_size,
+                                uint32_t* count, bool* ok) {
+    const ImageSection* sec = find_section(header, id);
+    if (sec == NULL || sec->offset > image->size || sec->size > image->size - sec->offset ||
+        (sec->offset & 7u) != 0 || (rec_size > 0 && sec->size != (uint64_t)sec->count * rec_size)) {
+        *ok = false;
+        *count = 0;
+        return NULL;
+    }
+    *count = sec->count;
+    return image->base + sec->offset;
+}
+
+static bool map_file(const char* path, CwImage* out) {
+#ifdef _WIN32
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    long size = ok ? ftell(f) : -1;
+    ok = ok && size > 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        out->base = (unsigned char*)malloc((size_t)size);
+        ok = out->base != NULL && fread(out->base, 1, (size_t)size, f) == (size_t)size;
+    }
+    fclose(f);
+    if (!ok) {
+        free(out->base);
+        out->base = NULL;
+        return false;
+    }
+    out->size = (size_t)size;
+    out->mapped = false;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ImageHeader)) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    out->base = (unsigned char*)base;
+    out->size = (size_t)st.st_size;
+    out->mapped = true;
+    return true;
+#endif
+}
+
+void cw_image_close(CwImage* image) {
+    if (image == NULL || image->base == NULL) {
+        return;
+    }
+#ifndef _WIN32
+    if (image->mapped) {
+        munmap(image->base, image->size);
+    } else {
+        free(image->base);
+    }
+#else
+    free(image->base);
+#endif
+    memset(image, 0, sizeof(*image));
+}
+
+static bool sources_current(const CwImage* image, const ImageHeader* header, const char* data_root) {
+    uint32_t count = 0;
+    bool ok = true;
+    const ImageSource* recorded =
+        (const ImageSource*)section_data(image, header, SEC_SOURCES, sizeof(ImageSource), &count, &ok);
+    if (!ok || count != SOURCE_FILE_COUNT) {
+        return false;
+    }
+    for (size_t i = 0; i < SOURCE_FILE_COUNT; i++) {
+        ImageSource now;
+        source_stat(data_root, i, &now);
+        if (now.size != recorded[i].size || now.mtime != recorded[i].mtime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Only the shape is checked here; accessors bound every slot and range they read. */
+static bool trie_section(CwImage* out, const ImageHeader* header, int which) {
+    bool ok = true;
+    uint32_t n = 0;
+    const ImageSection* sec = find_section(header, kTrieSections[which]);
+    const unsigned char* data = (const unsigned char*)section_data(out, header, kTrieSections[which], 0, &n, &ok);
+    uint64_t arrays = (uint64_t)n * TRIE_ARRAYS * sizeof(int32_t);
+    if (!ok || n == 0 || sec->size < arrays || (sec->size - arrays) % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    CwImageTrie* trie = &out->trie[which];
+    const int32_t* cols = (const int32_t*)data;
+    trie->base = cols;
+    trie->check = cols + n;
+    trie->lo = cols + 2 * (size_t)n;
+    trie->exact_end = cols + 3 * (size_t)n;
+    trie->hi = cols + 4 * (size_t)n;
+    trie->state_count = n;
+    trie->ids = (const uint32_t*)(data + arrays);
+    trie->id_count = (uint32_t)((sec->size - arrays) / sizeof(uint32_t));
+    return trie->check[0] == TRIE_ROOT;
+}
+
+bool cw_image_open(const char* path, const char* data_root, CwImage* out) {
+    uint64_t start = now_ns();
+    memset(out, 0, sizeof(*out));
+    if (path == NULL || !map_file(path, out)) {
+        return false;
+    }
+    const ImageHeader* header = (const ImageHeader*)out->base;
+    size_t table_bytes = (size_t)header->section_count * sizeof(ImageSection);
+    bool ok = memcmp(header->magic, kImageMagic, sizeof(kImageMagic)) == 0 && header->version == CW_IMAGE_VERSION &&
+              header->header_size == sizeof(ImageHeader) && header->file_size == out->size &&
+              header->section_count <= MAX_SECTIONS && sizeof(ImageHeader) + table_bytes <= out->size;
+    if (ok) {
+        ImageHeader copy = *header;
+        copy.header_hash = 0;
+        uint64_t h = hash_bytes(1469598103934665603ull, (const unsigned char*)&copy, sizeof(copy));
+        h = hash_bytes(h, (const unsigned char*)(header + 1), table_bytes);
+        ok = h == header->header_hash;
+    }
+    if (ok && data_root != NULL && data_root[0] != '\0') {
+        ok = sources_current(out, header, data_root);
+    }
+    if (!ok) {
+        cw_image_close(out);
+        return false;
+    }
+    out->payload_hash = header->payload_hash;
+    out->strings = (const char*)section_data(out, header, SEC_STRINGS, 1, &out->strings_size, &ok);
+    out->singles = (const CwImageSingle*)section_data(out, header, SEC_SINGLES, sizeof(CwImageSingle),
+                                                      &out->single_count, &ok);
+    out->phrases = (const CwImagePhrase*)section_data(out, header, SEC_PHRASES, sizeof(CwImagePhrase),
+                                                      &out->phrase_count, &ok);
+    out->reverse = (const CwImageReverse*)section_data(out, header, SEC_REVERSE, sizeof(CwImageReverse),
+                                                       &out->reverse_count, &ok);
+    out->dict = (const CwImageDictRow*)section_data(out, header, SEC_DICT, sizeof(CwImageDictRow), &out->dict_count,
+                                                    &ok);
+    uint32_t bmp_count = 0;
+    uint32_t nonbmp_idx_count = 0;
+    out->dict_bmp = (const int32_t*)section_data(out, header, SEC_DICT_BMP, sizeof(int32_t), &bmp_count, &ok);
+    out->dict_nonbmp_cp = (const int32_t*)section_data(out, header, SEC_DICT_NONBMP_CP, sizeof(int32_t),
+                                                       &out->dict_nonbmp_count, &ok);
+    out->dict_nonbmp_idx = (const int32_t*)section_data(out, header, SEC_DICT_NONBMP_IDX, sizeof(int32_t),
+                                                        &nonbmp_idx_count, &ok);
+    out->gbk = (const CwImageLegacyPair*)section_data(out, header, SEC_GBK, sizeof(CwImageLegacyPair),
+                                                      &out->gbk_count, &ok);
+    out->gb2312 = (const CwImageLegacyPair*)section_data(out, header, SEC_GB2312, sizeof(CwImageLegacyPair),
+                                                         &out->gb2312_count, &ok);
+    ok = ok && out->strings_size > 0 && out->strings[out->strings_size - 1] == '\0' && bmp_count == 65536u &&
+         nonbmp_idx_count == out->dict_nonbmp_count;
+    for (int i = 0; ok && i < CW_IMAGE_INDEX_COUNT; i++) {
+        const ImageSection* sec = find_section(header, kIndexSections[i]);
+        uint32_t key_count = 0;
+        const unsigned char* data = (const unsigned char*)section_data(out, header, kIndexSections[i], 0, &key_count, &ok);
+        if (!ok || sec->size < (uint64_t)key_count * sizeof(CwImageIndexKey) ||
+            (sec->size - (uint64_t)key_count * sizeof(CwImageIndexKey)) % sizeof(uint32_t) != 0) {
+            ok = false;
+            break;
+        }
+        CwImageIndex* index = &out->index[i];
+        index->keys = (const CwImageIndexKey*)data;
+        index->key_count = key_count;
+        index->ids = (const uint32_t*)(data + (size_t)key_count * sizeof(CwImageIndexKey));
+        index->id_count = (uint32_t)((sec->size - (uint64_t)key_count * sizeof(CwImageIndexKey)) / sizeof(uint32_t));
+        for (uint32_t k = 0; k < key_count; k++) {
+            const CwImageIndexKey* key = &index->keys[k];
+            if (key->key >= out->strings_size || key->first > index->id_count ||
+                key->count > index->id_count - key->first) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    for (int i = 0; ok && i < CW_IMAGE_TRIE_COUNT; i++) {
+        ok = trie_section(out, header, i);
+    }
+    if (!ok) {
+        cw_image_close(out);
+        return false;
+    }
+    out->open_ns = now_ns() - start;
+    return true;
+}
+
+bool cw_image_verify(const CwImage* image) {
+    if (image == NULL || image->base == NULL) {
+        return false;
+    }
+    const ImageHeader* header = (const ImageHeader*)image->base;
+    size_t head = sizeof(ImageHeader) + (size_t)header->section_count * sizeof(ImageSection);
+    size_t payload_start = (head + 7u) & ~(size_t)7u;
+    if (payload_start > image->size) {
+        return false;
+    }
+    uint64_t h = hash_bytes(1469598103934665603ull, image->base + payload_start, image->size - payload_start);
+    return h == image->payload_hash;
+}
+
+int32_t cw_image_index_find(const CwImage* image, int which, const char* key) {
+    if (image == NULL || which < 0 || which >= CW_IMAGE_INDEX_COUNT || key == NULL) {
+        return -1;
+    }
+    const CwImageIndex* index = &image->index[which];
+    uint32_t lo = 0;
+    uint32_t hi = index->key_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = strcmp(key, image->strings + index->keys[mid].key);
+        if (c == 0) {
+            return (int32_t)mid;
+        }
+        if (c < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return -1;
+}
+
+static int32_t trie_step(const CwImageTrie* trie, int32_t s, int32_t sym) {
+    if (sym < 1 || sym > 26) {
+        return -1;
+    }
+    int64_t t = (int64_t)trie->base[s] + sym;
+    if (t <= 0 || t >= (int64_t)trie->state_count || trie->check[t] != s) {
+        return -1;
+    }
+    return (int32_t)t;
+}
+
+int32_t cw_image_trie_find(const CwImage* image, int which, const char* key) {
+    if (image == NULL || which < 0 || which >= CW_IMAGE_TRIE_COUNT || key == NULL) {
+        return -1;
+    }
+    const CwImageTrie* trie = &image->trie[which];
+    int32_t s = 0;
+    for (const char* p = key; *p != '\0' && s >= 0; p++) {
+        s = trie_step(trie, s, *p >= 'A' && *p <= 'Z' ? *p - 'A' + 1 : 0);
+    }
+    return s;
+}
+
+int32_t cw_image_trie_find_key(const CwImage* image, int which, uint64_t key, int32_t len) {
+    if (image == NULL || which < 0 || which >= CW_IMAGE_TRIE_COUNT || len < 0 || len > 12) {
+        return -1;
+    }
+    const CwImageTrie* trie = &image->trie[which];
+    int32_t s = 0;
+    for (int32_t i = 0; i < len && s >= 0; i++) {
+        s = trie_step(trie, s, (int32_t)((key >> (5 * i)) & 31u));
+    }
+    return s;
+}
+
+/* ---- handle API ---- */
+
+#define MAX_HANDLES 8
+
+typedef struct {
+    char root[1024];
+    CwImage image;
+    bool open;
+} ImageSlot;
+
+static ImageSlot g_slots[MAX_HANDLES];
+
+static const CwImage* slot_image(int32_t handle) {
+    if (handle <= 0 || handle > MAX_HANDLES || !g_slots[handle - 1].open) {
+        return NULL;
+    }
+    return &g_slots[handle - 1].image;
+}
+
+static bool env_truthy(const char* name) {
+    const char* v = getenv(name);
+    return v != NULL && v[0] != '\0' && strcmp(v, "0") != 0;
+}
+
+int32_t cangwu_image_open(const char* data_root) {
+    const char* root = (data_root != NULL && data_root[0] != '\0') ? data_root : "src/ime/data";
+    if (env_truthy("CW_IME_NO_IMAGE")) {
+        return 0;
+    }
+    int32_t free_slot = -1;
+    for (int32_t i = 0; i < MAX_HANDLES; i++) {
+        if (g_slots[i].open && strcmp(g_slots[i].root, root) == 0) {
+            return i + 1;
+        }
+        if (!g_slots[i].open && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    char path[4096];
+    if (free_slot < 0 || strlen(root) >= sizeof(g_slots[0].root) ||
+        !path_join(path, sizeof(path), root, CW_IMAGE_FILE_NAME)) {
+        return 0;
+    }
+    ImageSlot* slot = &g_slots[free_slot];
+    if (!cw_image_open(path, root, &slot->image)) {
+        return 0;
+    }
+    if (env_truthy("CW_IME_IMAGE_VERIFY") && !cw_image_verify(&slot->image)) {
+        fprintf(stderr, "[cangwu-image] payload hash mismatch: %s\n", path);
+        cw_image_close(&slot->image);
+        return 0;
+    }
+    snprintf(slot->root, sizeof(slot->root), "%s", root);
+    slot->open = true;
+    return free_slot + 1;
+}
+
+int32_t cangwu_image_count(int32_t handle, int32_t table) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL) {
+        return 0;
+    }
+    switch (table) {
+        case CW_IMAGE_SINGLES: return (int32_t)image->single_count;
+        case CW_IMAGE_PHRASES: return (int32_t)image->phrase_count;
+        case CW_IMAGE_REVERSE: return (int32_t)image->reverse_count;
+        case CW_IMAGE_DICT: return (int32_t)image->dict_count;
+        case CW_IMAGE_GBK: return (int32_t)image->gbk_count;
+        case CW_IMAGE_GB2312: return (int32_t)image->gb2312_count;
+        default: return 0;
+    }
+}
+
+const char* cangwu_image_str(int32_t handle, int32_t table, int32_t row, int32_t field) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || row < 0 || row >= cangwu_image_count(handle, table)) {
+        return "";
+    }
+    uint32_t off = 0;
+    if (table == CW_IMAGE_SINGLES) {
+        const CwImageSingle* rec = &image->singles[row];
+        off = field == CW_IMAGE_TEXT ? rec->text
+              : field == CW_IMAGE_CODE ? rec->code
+              : field == CW_IMAGE_CANONICAL ? rec->canonical
+              : field == CW_IMAGE_PINYIN ? rec->pinyin
+                                         : 0;
+    } else if (table == CW_IMAGE_PHRASES) {
+        const CwImagePhrase* rec = &image->phrases[row];
+        off = field == CW_IMAGE_TEXT ? rec->text : field == CW_IMAGE_CODE ? rec->code : 0;
+    } else if (table == CW_IMAGE_REVERSE) {
+        const CwImageReverse* rec = &image->reverse[row];
+        off = field == CW_IMAGE_TEXT ? rec->text
+              : field == CW_IMAGE_CODE ? rec->code
+              : field == CW_IMAGE_CANONICAL ? rec->canonical
+              : field == CW_IMAGE_PINYIN ? rec->pinyin
+              : field == CW_IMAGE_MODE ? rec->mode
+              : field == CW_IMAGE_KEY ? rec->key
+                                      : 0;
+    } else if (table == CW_IMAGE_DICT) {
+        off = field == CW_IMAGE_TEXT ? image->dict[row].text : 0;
+    }
+    return cw_image_str(image, off);
+}
+
+int32_t cangwu_image_text_cmp(int32_t handle, int32_t table_a, int32_t row_a, int32_t table_b, int32_t row_b) {
+    int c = strcmp(cangwu_image_str(handle, table_a, row_a, CW_IMAGE_TEXT),
+                   cangwu_image_str(handle, table_b, row_b, CW_IMAGE_TEXT));
+    return c < 0 ? -1 : c > 0 ? 1 : 0;
+}
+
+int32_t cangwu_image_str_eq(int32_t handle, int32_t table, int32_t row, int32_t field, const char* value) {
+    return value != NULL && strcmp(cangwu_image_str(handle, table, row, field), value) == 0;
+}
+
+int64_t cangwu_image_code_key(int32_t handle, int32_t table, int32_t row) {
+    uint64_t key = 0;
+    int32_t len = 0;
+    for (const char* p = cangwu_image_str(handle, table, row, CW_IMAGE_CODE); *p != '\0'; p++) {
+        if (*p < 'A' || *p > 'Z') {
+            continue;
+        }
+        if (len >= 12) {
+            return -1;
+        }
+        key |= (uint64_t)(*p - 'A' + 1) << (5 * len);
+        len++;
+    }
+    return (int64_t)(key | ((uint64_t)len << 60));
+}
+
+int64_t cangwu_image_int(int32_t handle, int32_t table, int32_t row, int32_t field) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || row < 0 || row >= cangwu_image_count(handle, table)) {
+        return 0;
+    }
+    switch (table) {
+        case CW_IMAGE_SINGLES:
+            return field == CW_IMAGE_FREQ     ? image->singles[row].freq
+                   : field == CW_IMAGE_STRUCT ? (int64_t)image->singles[row].struct_kind
+                                              : 0;
+        case CW_IMAGE_PHRASES:
+            return field == CW_IMAGE_FREQ ? image->phrases[row].freq : 0;
+        case CW_IMAGE_REVERSE:
+            return field == CW_IMAGE_FREQ     ? image->reverse[row].freq
+                   : field == CW_IMAGE_STRUCT ? (int64_t)image->reverse[row].struct_kind
+                                              : 0;
+        case CW_IMAGE_DICT:
+            return field == CW_IMAGE_CODEPOINT ? image->dict[row].cp
+                   : field == CW_IMAGE_FREQ    ? image->dict[row].freq
+                                               : 0;
+        case CW_IMAGE_GBK:
+            return field == CW_IMAGE_KEY ? image->gbk[row].key : field == CW_IMAGE_CODEPOINT ? image->gbk[row].cp : 0;
+        case CW_IMAGE_GB2312:
+            return field == CW_IMAGE_KEY         ? image->gb2312[row].key
+                   : field == CW_IMAGE_CODEPOINT ? image->gb2312[row].cp
+                                                 : 0;
+        default:
+            return 0;
+    }
+}
+
+int32_t cangwu_image_dict_row(int32_t handle, int32_t cp) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || cp < 0) {
+        return -1;
+    }
+    if (cp <= 0xFFFF) {
+        int32_t row = image->dict_bmp[cp] - 1;
+        return row < (int32_t)image->dict_count ? row : -1;
+    }
+    uint32_t lo = 0;
+    uint32_t hi = image->dict_nonbmp_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (image->dict_nonbmp_cp[mid] == cp) {
+            int32_t row = image->dict_nonbmp_idx[mid];
+            return row >= 0 && row < (int32_t)image->dict_count ? row : -1;
+        }
+        if (image->dict_nonbmp_cp[mid] < cp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+int32_t cangwu_image_legacy_cp(int32_t handle, int32_t table, int32_t key) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || (table != CW_IMAGE_GBK && table != CW_IMAGE_GB2312)) {
+        return -1;
+    }
+    const CwImageLegacyPair* pairs = table == CW_IMAGE_GBK ? image->gbk : image->gb2312;
+    uint32_t lo = 0;
+    uint32_t hi = table == CW_IMAGE_GBK ? image->gbk_count : image->gb2312_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (pairs[mid].key == key) {
+            return pairs[mid].cp;
+        }
+        if (pairs[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+int32_t cangwu_image_index_find(int32_t handle, int32_t which, const char* key) {
+    return cw_image_index_find(slot_image(handle), which, key);
+}
+
+int32_t cangwu_image_index_count(int32_t handle, int32_t which, int32_t slot) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || which < 0 || which >= CW_IMAGE_INDEX_COUNT || slot < 0 ||
+        (uint32_t)slot >= image->index[which].key_count) {
+        return 0;
+    }
+    return (int32_t)image->index[which].keys[slot].count;
+}
+
+int32_t cangwu_image_index_id(int32_t handle, int32_t which, int32_t slot, int32_t i) {
+    int32_t count = cangwu_image_index_count(handle, which, slot);
+    if (i < 0 || i >= count) {
+        return -1;
+    }
+    const CwImageIndex* index = &slot_image(handle)->index[which];
+    return (int32_t)index->ids[index->keys[slot].first + (uint32_t)i];
+}
+
+int32_t cangwu_image_trie_find(int32_t handle, int32_t which, const char* key) {
+    return cw_image_trie_find(slot_image(handle), which, key);
+}
+
+int32_t cangwu_image_trie_find_key(int32_t handle, int32_t which, int64_t key, int32_t len) {
+    return cw_image_trie_find_key(slot_image(handle), which, (uint64_t)key, len);
+}
+
+int32_t cangwu_image_trie_range(int32_t handle, int32_t which, int32_t state, int32_t field) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || which < 0 || which >= CW_IMAGE_TRIE_COUNT || state < 0 ||
+        (uint32_t)state >= image->trie[which].state_count) {
+        return 0;
+    }
+    const CwImageTrie* trie = &image->trie[which];
+    int32_t value = field == CW_IMAGE_TRIE_LO          ? trie->lo[state]
+                    : field == CW_IMAGE_TRIE_EXACT_END ? trie->exact_end[state]
+                    : field == CW_IMAGE_TRIE_HI        ? trie->hi[state]
+                                                       : 0;
+    /* Clamped so a damaged image can only yield short ranges. */
+    if (value < 0) {
+        return 0;
+    }
+    return (uint32_t)value > trie->id_count ? (int32_t)trie->id_count : value;
+}
+
+int32_t cangwu_image_trie_id(int32_t handle, int32_t which, int32_t i) {
+    const CwImage* image = slot_image(handle);
+    if (image == NULL || which < 0 || which >= CW_IMAGE_TRIE_COUNT || i < 0 ||
+        (uint32_t)i >= image->trie[which].id_count) {
+        return -1;
+    }
+    return (int32_t)image->trie[which].ids[i];
+}
+
+int64_t cangwu_clock_ns(void) {
+    return (int64_t)now_ns();
+}
+
+int64_t cangwu_image_open_ns(int32_t handle) {
+    const CwImage* image = slot_image(handle);
+    return image != NULL ? (int64_t)image->open_ns : -1;
+}
+
+int32_t cangwu_image_build(const char* data_root, const char* out_path) {
+    char err[512];
+    err[0] = '\0';
+    if (!cw_image_build(data_root, out_path, err, sizeof(err))) {
+        fprintf(stderr, "[cangwu-image] build failed: %s\n", err);
+        return 1;
+    }
+    return 0;
+}
+
+#ifdef CW_ASSET_IMAGE_MAIN
+/*
+ * Standalone builder for the shell build-assets path:
+ *   cangwu_asset_image --data-root <dir> [--out <path>] [--bench]
+ * --bench compares a cold TSV parse (the build's load step) with mapping the
+ * image and looking up one prefix.
+ */
+int main(int argc, char** argv) {
+    const char* data_root = NULL;
+    const char* out_path = NULL;
+    bool bench = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--data-root") == 0 && i + 1 < argc) {
+            data_root = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+        } else {
+            fprintf(stderr, "usage: %s --data-root <dir> [--out <path>] [--bench]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (data_root == NULL) {
+        fprintf(stderr, "usage: %s --data-root <dir> [--out <path>] [--bench]\n", argv[0]);
+        return 2;
+    }
+    char default_out[4096];
+    if (out_path == NULL) {
+        if (!path_join(default_out, sizeof(default_out), data_root, CW_IMAGE_FILE_NAME)) {
+            return 2;
+        }
+        out_path = default_out;
+    }
+    char err[512];
+    uint64_t t0 = now_ns();
+    if (!cw_image_build(data_root, out_path, err, sizeof(err))) {
+        fprintf(stderr, "[cangwu-image] build failed: %s\n", err);
+        return 1;
+    }
+    uint64_t build_ns = now_ns() - t0;
+    CwImage image;
+    if (!cw_image_open(out_path, data_root, &image) || !cw_image_verify(&image)) {
+        fprintf(stderr, "[cangwu-image] written image does not verify: %s\n", out_path);
+        return 1;
+    }
+    printf("[cangwu-image] ok out=%s bytes=%zu singles=%u phrases=%u reverse=%u dict=%u gbk=%u gb2312=%u\n",
+           out_path, image.size, image.single_count, image.phrase_count, image.reverse_count, image.dict_count,
+           image.gbk_count, image.gb2312_count);
+    cw_image_close(&image);
+    if (bench) {
+        const int rounds = 50;
+        uint64_t open_total = 0;
+        int32_t hits = 0;
+        for (int r = 0; r < rounds; r++) {
+            uint64_t start = now_ns();
+            if (!cw_image_open(out_path, data_root, &image)) {
+                return 1;
+            }
+            int32_t state = cw_image_trie_find(&image, CW_IMAGE_TRIE_SINGLES, "AM");
+            hits += state >= 0 ? image.trie[CW_IMAGE_TRIE_SINGLES].hi[state] - image.trie[CW_IMAGE_TRIE_SINGLES].lo[state] : 0;
+            open_total += now_ns() - start;
+            cw_image_close(&image);
+        }
+        printf("[cangwu-image] bench build_ms=%.3f open_us=%.1f prefix_hits=%d\n", (double)build_ns / 1e6,
+               (double)open_total / rounds / 1e3, hits / rounds);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,226 @@
+#ifndef CANGWU_ASSET_IMAGE_H
+#define CANGWU_ASSET_IMAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Precompiled IME asset image (cangwu_assets_v1.img).
+ *
+ * build-assets turns the TSV assets into one little-endian file: a 64-byte
+ * header, a section table and 8-byte aligned sections. Strings live once in a
+ * NUL-terminated pool and every record refers to them by offset, so a mapped
+ * image is queried in place without parsing or allocation.
+ */
+
+#define CW_IMAGE_FILE_NAME "cangwu_assets_v1.img"
+#define CW_IMAGE_VERSION 2u
+
+/* Record tables, for the handle API. */
+enum {
+    CW_IMAGE_SINGLES = 1,
+    CW_IMAGE_PHRASES = 2,
+    CW_IMAGE_REVERSE = 3,
+    CW_IMAGE_DICT = 4,
+    CW_IMAGE_GBK = 5,
+    CW_IMAGE_GB2312 = 6,
+};
+
+/* Record fields; which ones a table has follows its TSV columns. */
+enum {
+    CW_IMAGE_TEXT = 0,
+    CW_IMAGE_CODE = 1,
+    CW_IMAGE_CANONICAL = 2,
+    CW_IMAGE_PINYIN = 3,
+    CW_IMAGE_MODE = 4,
+    CW_IMAGE_KEY = 5,
+    CW_IMAGE_FREQ = 6,
+    CW_IMAGE_STRUCT = 7,
+    CW_IMAGE_CODEPOINT = 8,
+};
+
+/* Exact-key indexes; reverse lookups are keyed "mode:key". */
+enum {
+    CW_IMAGE_INDEX_REVERSE = 0,
+    CW_IMAGE_INDEX_COUNT = 1,
+};
+
+/* Code tries over the single and phrase tables. */
+enum {
+    CW_IMAGE_TRIE_SINGLES = 0,
+    CW_IMAGE_TRIE_PHRASES = 1,
+    CW_IMAGE_TRIE_COUNT = 2,
+};
+
+/* Per-state posting range fields, for cangwu_image_trie_range. */
+enum {
+    CW_IMAGE_TRIE_LO = 0,
+    CW_IMAGE_TRIE_EXACT_END = 1,
+    CW_IMAGE_TRIE_HI = 2,
+};
+
+typedef struct {
+    uint32_t text;
+    uint32_t code;
+    uint32_t canonical;
+    uint32_t pinyin;
+    int64_t freq;
+    uint32_t struct_kind;
+    uint32_t reserved;
+} CwImageSingle;
+
+typedef struct {
+    uint32_t text;
+    uint32_t code;
+    int64_t freq;
+} CwImagePhrase;
+
+typedef struct {
+    uint32_t mode;
+    uint32_t key;
+    uint32_t text;
+    uint32_t code;
+    uint32_t canonical;
+    uint32_t pinyin;
+    uint32_t struct_kind;
+    uint32_t reserved;
+    int64_t freq;
+} CwImageReverse;
+
+typedef struct {
+    int32_t cp;
+    uint32_t text;
+    int64_t freq;
+} CwImageDictRow;
+
+/* Same layout as LegacyMapEntry in cangwu_ime_cli_bin.c. */
+typedef struct {
+    int32_t key;
+    int32_t cp;
+} CwImageLegacyPair;
+
+typedef struct {
+    uint32_t key;
+    uint32_t first;
+    uint32_t count;
+    uint32_t reserved;
+} CwImageIndexKey;
+
+typedef struct {
+    const CwImageIndexKey* keys;
+    uint32_t key_count;
+    const uint32_t* ids;
+    uint32_t id_count;
+} CwImageIndex;
+
+/*
+ * Double-array trie over normalized codes, laid out like CwCodeTrie in
+ * ime/cangwu_code_trie.cheng: symbols 'A'..'Z' are 1..26 and the child of
+ * state s on c is t = base[s] + c when check[t] == s; state 0 is the root.
+ * Every state owns ids[lo[s]..hi[s]), the rows under its prefix in (code,
+ * row) order; those before exact_end[s] have exactly that code.
+ */
+typedef struct {
+    const int32_t* base;
+    const int32_t* check;
+    const int32_t* lo;
+    const int32_t* exact_end;
+    const int32_t* hi;
+    uint32_t state_count;
+    const uint32_t* ids;
+    uint32_t id_count;
+} CwImageTrie;
+
+typedef struct {
+    unsigned char* base;
+    size_t size;
+    bool mapped;
+    uint64_t payload_hash;
+    uint64_t open_ns;
+    const char* strings;
+    uint32_t strings_size;
+    const CwImageSingle* singles;
+    uint32_t single_count;
+    const CwImagePhrase* phrases;
+    uint32_t phrase_count;
+    const CwImageReverse* reverse;
+    uint32_t reverse_count;
+    const CwImageDictRow* dict;
+    uint32_t dict_count;
+    /* 65536 entries of row + 1, 0 when the BMP code point is not in the dict. */
+    const int32_t* dict_bmp;
+    /* Non-BMP code points sorted ascending, with their rows alongside. */
+    const int32_t* dict_nonbmp_cp;
+    const int32_t* dict_nonbmp_idx;
+    uint32_t dict_nonbmp_count;
+    const CwImageLegacyPair* gbk;
+    uint32_t gbk_count;
+    const CwImageLegacyPair* gb2312;
+    uint32_t gb2312_count;
+    CwImageIndex index[CW_IMAGE_INDEX_COUNT];
+    CwImageTrie trie[CW_IMAGE_TRIE_COUNT];
+} CwImage;
+
+/* Parses the TSV assets under data_root and writes the image to out_path. */
+bool cw_image_build(const char* data_root, const char* out_path, char* err, size_t err_len);
+
+/*
+ * Maps an image and checks its header, header hash and section bounds; that
+ * is O(1) in the image size. With data_root set, the image is also rejected
+ * when a source TSV there changed size or mtime since the build, so callers
+ * fall back to the TSVs instead of serving stale data.
+ */
+bool cw_image_open(const char* path, const char* data_root, CwImage* out);
+
+/* Hashes the whole payload against the header; build-assets runs this. */
+bool cw_image_verify(const CwImage* image);
+void cw_image_close(CwImage* image);
+
+static inline const char* cw_image_str(const CwImage* image, uint32_t offset) {
+    if (image == NULL || offset >= image->strings_size) {
+        return "";
+    }
+    return image->strings + offset;
+}
+
+/* Returns the key slot for an exact key, or -1. */
+int32_t cw_image_index_find(const CwImage* image, int which, const char* key);
+
+/* Walks a code trie; returns the state for key, or -1 when no code has it as a prefix. */
+int32_t cw_image_trie_find(const CwImage* image, int which, const char* key);
+
+/* Same walk for a packed code key: symbol i in bits 5*i..5*i+4, len <= 12. */
+int32_t cw_image_trie_find_key(const CwImage* image, int which, uint64_t key, int32_t len);
+
+/*
+ * Handle API for the Cheng IME modules, which are built without pointers in
+ * their ABI: images are kept open per data root for the life of the process
+ * and addressed by small integer handles. Strings point into the mapping.
+ */
+int32_t cangwu_image_open(const char* data_root);
+int32_t cangwu_image_count(int32_t handle, int32_t table);
+const char* cangwu_image_str(int32_t handle, int32_t table, int32_t row, int32_t field);
+int64_t cangwu_image_int(int32_t handle, int32_t table, int32_t row, int32_t field);
+/* Compare in place, so ranking and user-frequency lookups copy no strings. */
+int32_t cangwu_image_text_cmp(int32_t handle, int32_t table_a, int32_t row_a, int32_t table_b, int32_t row_b);
+int32_t cangwu_image_str_eq(int32_t handle, int32_t table, int32_t row, int32_t field, const char* value);
+/* Packed code key of a row (see cw_image_trie_find_key) with its length in bits 60..63; -1 past 12 symbols. */
+int64_t cangwu_image_code_key(int32_t handle, int32_t table, int32_t row);
+/* Dict row of a code point through DBMP or the sorted non-BMP table; -1 when absent. */
+int32_t cangwu_image_dict_row(int32_t handle, int32_t cp);
+/* Code point for a GBK/GB2312 key by binary search over the sorted pairs; -1 when unmapped. */
+int32_t cangwu_image_legacy_cp(int32_t handle, int32_t table, int32_t key);
+int32_t cangwu_image_index_find(int32_t handle, int32_t which, const char* key);
+int32_t cangwu_image_index_count(int32_t handle, int32_t which, int32_t slot);
+int32_t cangwu_image_index_id(int32_t handle, int32_t which, int32_t slot, int32_t i);
+int32_t cangwu_image_trie_find(int32_t handle, int32_t which, const char* key);
+int32_t cangwu_image_trie_find_key(int32_t handle, int32_t which, int64_t key, int32_t len);
+int32_t cangwu_image_trie_range(int32_t handle, int32_t which, int32_t state, int32_t field);
+int32_t cangwu_image_trie_id(int32_t handle, int32_t which, int32_t i);
+int64_t cangwu_image_open_ns(int32_t handle);
+/* Monotonic clock, for timing IME query steps. */
+int64_t cangwu_clock_ns(void);
+int32_t cangwu_image_build(const char* data_root, const char* out_path);
+
+#endif
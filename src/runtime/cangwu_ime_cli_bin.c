@@ -12,6 +12,8 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "cangwu_asset_image.h"
+
 #define UTFZH_DICT_EXPECTED_COUNT 9698
 #define UTFZH_REPLACEMENT_CP 0xFFFD
 #define DECODE_ERROR_STORE_LIMIT 4096
@@ -63,10 +65,12 @@ typedef struct {
     int32_t cp;
 } LegacyMapEntry;
 
+/* borrowed: items point into the mapped asset image and are not freed. */
 typedef struct {
     LegacyMapEntry* items;
     size_t len;
     size_t cap;
+    bool borrowed;
 } LegacyMap;
 
 typedef struct {
@@ -76,6 +80,7 @@ typedef struct {
     size_t nonbmp_len;
     size_t nonbmp_cap;
     int32_t count;
+    bool borrowed;
 } UtfZhDict;
 
 typedef struct {
@@ -84,6 +89,8 @@ typedef struct {
     LegacyMap gb2312;
     bool has_gbk;
     bool has_gb2312;
+    CwImage image;
+    bool has_image;
 } BuiltinAssets;
 
 typedef struct {
@@ -507,6 +514,26 @@ static bool load_dict_rows(const char* path, DictRow** out_rows, size_t* out_len
     return true;
 }
 
+static bool load_dict_rows_image(const CwImage* image, DictRow** out_rows, size_t* out_len) {
+    *out_rows = NULL;
+    *out_len = 0u;
+    if (image->dict_count == 0u) {
+        return false;
+    }
+    DictRow* rows = (DictRow*)malloc((size_t)image->dict_count * sizeof(DictRow));
+    if (rows == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < image->dict_count; i++) {
+        rows[i].cp = image->dict[i].cp;
+        rows[i].base_idx = (int32_t)i;
+        rows[i].base_freq = image->dict[i].freq > 0 ? image->dict[i].freq : 0;
+    }
+    *out_rows = rows;
+    *out_len = image->dict_count;
+    return true;
+}
+
 static int cmp_dict_rows_for_opt(const void* a, const void* b) {
     const DictRow* ra = (const DictRow*)a;
     const DictRow* rb = (const DictRow*)b;
@@ -550,14 +577,16 @@ static bool write_dict_rows(const char* out_path, const DictRow* rows, size_t ro
     return true;
 }
 
-static bool build_optimized_dict_file(const char* base_dict_path, const int32_t* cps, size_t cp_len,
-                                      const char* out_dict_path) {
+static bool build_optimized_dict_file(const char* base_dict_path, const CwImage* image, const int32_t* cps,
+                                      size_t cp_len, const char* out_dict_path) {
     if (base_dict_path == NULL || out_dict_path == NULL) {
         return false;
     }
     DictRow* rows = NULL;
     size_t row_len = 0u;
-    if (!load_dict_rows(base_dict_path, &rows, &row_len)) {
+    bool loaded = image != NULL ? load_dict_rows_image(image, &rows, &row_len)
+                                : load_dict_rows(base_dict_path, &rows, &row_len);
+    if (!loaded) {
         return false;
     }
     uint32_t* counts = (uint32_t*)calloc(0x110000u, sizeof(uint32_t));
@@ -675,10 +704,13 @@ static void legacy_map_init(LegacyMap* map) {
     map->items = NULL;
     map->len = 0;
     map->cap = 0;
+    map->borrowed = false;
 }
 
 static void legacy_map_free(LegacyMap* map) {
-    free(map->items);
+    if (!map->borrowed) {
+        free(map->items);
+    }
     legacy_map_init(map);
 }
 
@@ -781,12 +813,15 @@ static void utfzh_dict_init(UtfZhDict* out) {
     out->nonbmp_len = 0;
     out->nonbmp_cap = 0;
     out->count = 0;
+    out->borrowed = false;
 }
 
 static void utfzh_dict_free(UtfZhDict* out) {
-    free(out->bmp_index);
-    free(out->nonbmp_cp);
-    free(out->nonbmp_idx);
+    if (!out->borrowed) {
+        free(out->bmp_index);
+        free(out->nonbmp_cp);
+        free(out->nonbmp_idx);
+    }
     utfzh_dict_init(out);
 }
 
@@ -1317,6 +1352,8 @@ static void builtin_assets_init(BuiltinAssets* assets) {
     legacy_map_init(&assets->gb2312);
     assets->has_gbk = false;
     assets->has_gb2312 = false;
+    memset(&assets->image, 0, sizeof(assets->image));
+    assets->has_image = false;
 }
 
 static void builtin_assets_free(BuiltinAssets* assets) {
@@ -1325,9 +1362,47 @@ static void builtin_assets_free(BuiltinAssets* assets) {
     legacy_map_free(&assets->gb2312);
     assets->has_gbk = false;
     assets->has_gb2312 = false;
+    if (assets->has_image) {
+        cw_image_close(&assets->image);
+        assets->has_image = false;
+    }
+}
+
+_Static_assert(sizeof(LegacyMapEntry) == sizeof(CwImageLegacyPair), "legacy map entries must match the image");
+
+/* Points the dict and legacy maps into a mapped image; nothing is parsed or copied. */
+static bool load_image_assets(BuiltinAssets* assets, const char* data_root) {
+    if (str_truthy(getenv("CW_IME_NO_IMAGE"))) {
+        return false;
+    }
+    char image_path[PATH_MAX];
+    if (!join_path2(image_path, sizeof(image_path), data_root, CW_IMAGE_FILE_NAME) ||
+        !cw_image_open(image_path, data_root, &assets->image)) {
+        return false;
+    }
+    const CwImage* image = &assets->image;
+    assets->has_image = true;
+    assets->dict.bmp_index = (int32_t*)image->dict_bmp;
+    assets->dict.nonbmp_cp = (int32_t*)image->dict_nonbmp_cp;
+    assets->dict.nonbmp_idx = (int32_t*)image->dict_nonbmp_idx;
+    assets->dict.nonbmp_len = image->dict_nonbmp_count;
+    assets->dict.count = (int32_t)image->dict_count;
+    assets->dict.borrowed = true;
+    assets->gbk.items = (LegacyMapEntry*)image->gbk;
+    assets->gbk.len = image->gbk_count;
+    assets->gbk.borrowed = true;
+    assets->gb2312.items = (LegacyMapEntry*)image->gb2312;
+    assets->gb2312.len = image->gb2312_count;
+    assets->gb2312.borrowed = true;
+    assets->has_gbk = true;
+    assets->has_gb2312 = true;
+    return true;
 }
 
 static bool load_builtin_assets(BuiltinAssets* assets, const char* data_root, bool need_gbk, bool need_gb2312) {
+    if (load_image_assets(assets, data_root)) {
+        return true;
+    }
     char dict_path[PATH_MAX];
     if (!join_path2(dict_path, sizeof(dict_path), data_root, "utfzh_dict_v1.tsv")) {
         return false;
@@ -1430,7 +1505,8 @@ static int run_builtin_convert(const char* in_path, const char* out_path, Legacy
                 return 33;
             }
         }
-        if (!build_optimized_dict_file(base_dict_path, decoded.cps, decoded.cps_len, optimized_dict_path)) {
+        if (!build_optimized_dict_file(base_dict_path, assets.has_image ? &assets.image : NULL, decoded.cps,
+                                       decoded.cps_len, optimized_dict_path)) {
             free(input);
             decode_state_free(&decoded);
             builtin_assets_free(&assets);
@@ -1851,6 +1927,29 @@ static int run_build_assets(int argc, char** argv, const char* pkg_root) {
         fprintf(stderr, "[cangwu-ime-cli] legacy map is empty\n");
         return 1;
     }
+
+    char image_path[PATH_MAX];
+    char image_err[512];
+    if (!join_path2(image_path, sizeof(image_path), out_dir, CW_IMAGE_FILE_NAME)) {
+        return 1;
+    }
+    if (!cw_image_build(out_dir, image_path, image_err, sizeof(image_err))) {
+        fprintf(stderr, "[cangwu-ime-cli] asset image build failed: %s\n", image_err);
+        return 1;
+    }
+    CwImage image;
+    if (!cw_image_open(image_path, out_dir, &image) || !cw_image_verify(&image)) {
+        fprintf(stderr, "[cangwu-ime-cli] asset image does not verify: %s\n", image_path);
+        return 1;
+    }
+    bool image_ok = image.dict_count == UTFZH_DICT_EXPECTED_COUNT;
+    fprintf(stdout, "[cangwu-ime-cli] asset image %s bytes=%zu singles=%u reverse=%u dict=%u\n", image_path,
+            image.size, image.single_count, image.reverse_count, image.dict_count);
+    cw_image_close(&image);
+    if (!image_ok) {
+        fprintf(stderr, "[cangwu-ime-cli] asset image dict count mismatch\n");
+        return 1;
+    }
     return 0;
 }
 
@@ -5,10 +5,13 @@ usage() {
   cat <<'EOF'
 Usage:
   scripts/build_native_gui_hybrid.sh [--out:<path>] [--name:<prog>] [--hybrid-map:<path>] [--hybrid-default:<c|asm>]
+                                     [--headless]
 
 Notes:
   - Builds GUI desktop binary via Cheng hybrid C+ASM backend.
   - Uses cheng-lang/src/tooling/chengc.sh with module-level hybrid map.
+  - --headless (Linux): links platform/headless_app.c instead of the X11 host; the
+    binary renders into memory and is driven by GUI_HEADLESS_* env vars.
 EOF
 }
 
@@ -16,6 +19,7 @@ prog="cheng_gui_hybrid"
 out=""
 hybrid_map=""
 hybrid_default="asm"
+headless="0"
 while [ "${1:-}" != "" ]; do
   case "$1" in
     --help|-h)
@@ -34,6 +38,9 @@ while [ "${1:-}" != "" ]; do
     --hybrid-default:*)
       hybrid_default="${1#--hybrid-default:}"
       ;;
+    --headless)
+      headless="1"
+      ;;
     *)
       echo "[Error] unknown arg: $1" 1>&2
       usage
@@ -169,10 +176,14 @@ fi
 
 obj_stub="$modules_out/${prog}.mobile_stub.o"
 obj_skia="$modules_out/${prog}.skia_stub.o"
+obj_kern="$modules_out/${prog}.pixel_kernels.o"
+obj_snap="$modules_out/${prog}.snapshot_writer.o"
 
 echo "== GUI hybrid: compile platform stubs =="
 "$real_cc" -c "$GUI_ROOT/platform/cheng_mobile_host_stub.c" -o "$obj_stub"
 "$real_cc" -c "$GUI_ROOT/render/skia_stub.c" -o "$obj_skia"
+"$real_cc" -O2 -c "$GUI_ROOT/render/pixel_kernels.c" -o "$obj_kern"
+"$real_cc" -O3 -c "$GUI_ROOT/render/snapshot_writer.c" -o "$obj_snap"
 
 echo "== GUI hybrid: link platform =="
 case "$platform" in
@@ -185,19 +196,29 @@ case "$platform" in
     obj_text="$modules_out/${prog}.text_macos.o"
     clang -fobjc-arc -c "$GUI_ROOT/platform/macos_app.m" -o "$obj_plat"
     clang -std=c11 -c "$GUI_ROOT/render/text_macos.c" -o "$obj_text"
-    clang $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_plat" "$obj_text" \
+    clang $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_text" \
       -framework Cocoa -framework QuartzCore -framework CoreGraphics -framework CoreText -framework CoreFoundation \
       -o "$out"
     ;;
   linux)
-    obj_plat="$modules_out/${prog}.x11_app.o"
-    "$real_cc" -c "$GUI_ROOT/platform/x11_app.c" -o "$obj_plat"
-    "$real_cc" $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_plat" -lX11 -lXext -o "$out"
+    obj_text="$modules_out/${prog}.text_linux.o"
+    obj_host="$modules_out/${prog}.linux_host_native.o"
+    "$real_cc" -O2 -c "$GUI_ROOT/render/text_linux.c" -o "$obj_text"
+    "$real_cc" -O2 -c "$GUI_ROOT/platform/linux_host_native.c" -o "$obj_host"
+    if [ "$headless" = "1" ]; then
+      obj_plat="$modules_out/${prog}.headless_app.o"
+      "$real_cc" -O2 -c "$GUI_ROOT/platform/headless_app.c" -o "$obj_plat"
+      "$real_cc" $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_host" "$obj_text" -lm -lpthread -o "$out"
+    else
+      obj_plat="$modules_out/${prog}.x11_app.o"
+      "$real_cc" -c "$GUI_ROOT/platform/x11_app.c" -o "$obj_plat"
+      "$real_cc" $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_host" "$obj_text" -lX11 -lXext -lm -lpthread -o "$out"
+    fi
     ;;
   windows)
     obj_plat="$modules_out/${prog}.win32_app.o"
     "$real_cc" -c "$GUI_ROOT/platform/win32_app.c" -o "$obj_plat"
-    "$real_cc" $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_plat" -luser32 -lgdi32 -limm32 -o "$out"
+    "$real_cc" $obj_inputs "$modules_out/system_helpers.o" "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" -luser32 -lgdi32 -limm32 -o "$out"
     ;;
   *)
     echo "[Error] unsupported platform: $uname_s" 1>&2
@@ -14,17 +14,19 @@ TRANSCODE_ENTRY_CHENG="$SRC_ROOT/ime/utfzh_transcode_entry.cheng"
 RUNTIME_SYS_C="/Users/lbcheng/cheng-lang/src/runtime/native/system_helpers.c"
 RUNTIME_COMPAT_C="$SRC_ROOT/runtime/cheng_compat_shim.c"
 RUNTIME_PTR_SHIM_C="$SRC_ROOT/runtime/cheng_selflink_ptr_shim.c"
+RUNTIME_IMAGE_C="$SRC_ROOT/runtime/cangwu_asset_image.c"
 TRANSCODE_DEPS=(
   "$TRANSCODE_ENTRY_CHENG"
   "$SRC_ROOT/ime/utfzh_codec.cheng"
   "$SRC_ROOT/ime/cangwu_assets_loader.cheng"
+  "$SRC_ROOT/ime/cangwu_asset_image.cheng"
   "$SRC_ROOT/ime/cangwu_types.cheng"
   "$SRC_ROOT/ime/legacy_assets_loader.cheng"
   "$SRC_ROOT/ime/legacy_codec.cheng"
   "$SRC_ROOT/ime/legacy_types.cheng"
 )
 
-for f in "$OBJ_COMPAT" "$TRANSCODE_MAIN_CHENG" "$RUNTIME_SYS_C" "$RUNTIME_COMPAT_C" "$RUNTIME_PTR_SHIM_C" "${TRANSCODE_DEPS[@]}"; do
+for f in "$OBJ_COMPAT" "$TRANSCODE_MAIN_CHENG" "$RUNTIME_SYS_C" "$RUNTIME_COMPAT_C" "$RUNTIME_PTR_SHIM_C" "$RUNTIME_IMAGE_C" "${TRANSCODE_DEPS[@]}"; do
   if [ ! -f "$f" ]; then
     echo "[cangwu-ime-cli] missing source: $f" >&2
     exit 2
@@ -40,6 +42,7 @@ pure_main_obj="$OBJ_ROOT/utfzh_transcode_pure.main.o"
 pure_sys_obj="$OBJ_ROOT/utfzh_transcode_pure.system_helpers.runtime.o"
 pure_compat_obj="$OBJ_ROOT/utfzh_transcode_pure.compat_shim.runtime.o"
 pure_ptr_obj="$OBJ_ROOT/utfzh_transcode_pure.ptr_shim.runtime.o"
+pure_image_obj="$OBJ_ROOT/utfzh_transcode_pure.asset_image.runtime.o"
 
 convert_usage() {
   echo "用法: cangwu_ime_cli convert --in <input> --out <output> [--from auto|utf8|utf16le|utf16be|gbk|gb2312] [--report <path>] [--data-root <path>] [--optimize-dict] [--dict-out <path>]"
@@ -50,7 +53,7 @@ build_convert_pure() {
   if [ "$needs_rebuild" != "1" ] && [ ! -x "$pure_bin" ]; then
     needs_rebuild="1"
   fi
-  for f in "$OBJ_COMPAT" "$TRANSCODE_MAIN_CHENG" "$RUNTIME_SYS_C" "$RUNTIME_COMPAT_C" "$RUNTIME_PTR_SHIM_C" "${TRANSCODE_DEPS[@]}"; do
+  for f in "$OBJ_COMPAT" "$TRANSCODE_MAIN_CHENG" "$RUNTIME_SYS_C" "$RUNTIME_COMPAT_C" "$RUNTIME_PTR_SHIM_C" "$RUNTIME_IMAGE_C" "${TRANSCODE_DEPS[@]}"; do
     if [ "$needs_rebuild" != "1" ] && [ "$f" -nt "$pure_bin" ]; then
       needs_rebuild="1"
     fi
@@ -66,7 +69,8 @@ build_convert_pure() {
       -c "$RUNTIME_SYS_C" -o "$pure_sys_obj"
     clang -std=c11 -O2 -c "$RUNTIME_COMPAT_C" -o "$pure_compat_obj"
     clang -std=c11 -O2 -c "$RUNTIME_PTR_SHIM_C" -o "$pure_ptr_obj"
-    clang "$pure_main_obj" "$pure_sys_obj" "$pure_compat_obj" "$pure_ptr_obj" -o "$pure_bin"
+    clang -std=c11 -D_POSIX_C_SOURCE=200809L -O2 -c "$RUNTIME_IMAGE_C" -o "$pure_image_obj"
+    clang "$pure_main_obj" "$pure_sys_obj" "$pure_compat_obj" "$pure_ptr_obj" "$pure_image_obj" -o "$pure_bin"
     echo "[cangwu-ime-cli] build done: $pure_bin"
   fi
 
@@ -319,11 +323,21 @@ run_build_assets() {
     return 1
   fi
 
+  # Precompiled image next to the TSVs; loaders map it instead of parsing.
+  local image_tool="$BIN_ROOT/cangwu_asset_image"
+  clang -std=c11 -D_POSIX_C_SOURCE=200809L -O2 -DCW_ASSET_IMAGE_MAIN "$RUNTIME_IMAGE_C" -o "$image_tool"
+  local image_line
+  if ! image_line="$("$image_tool" --data-root "$out_dir")"; then
+    echo "[cangwu-ime-cli] asset image build failed" >&2
+    return 1
+  fi
+
   echo "[cangwu-ime-cli] build-assets ok"
   echo "  out=$out_dir"
   echo "  dict_lines=$dict_lines"
   echo "  gbk_lines=$gbk_lines"
   echo "  gb2312_lines=$gb2312_lines"
+  echo "  image=${image_line#\[cangwu-image\] ok }"
   return 0
 }
 
@@ -1,4 +1,6 @@
 #!/usr/bin/env python3
+"""Reference converter; render/snapshot_writer.c built with
+-DCHENG_GUI_SNAPSHOT_MAIN takes the same arguments and encodes natively."""
 import argparse
 import struct
 import sys
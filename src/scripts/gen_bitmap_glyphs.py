@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Compile the bitmap fonts in render/glyphs/ into packed bit-row tables.
+
+Writes render/bitmap_glyphs.cheng and, for the C rasterizer in
+render/skia_stub.c, the 5x7 table as render/bitmap_glyphs.h. With --check,
+exits 1 when a checked-in file is out of date instead of rewriting it.
+"""
+
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUT_PATH = os.path.join(ROOT, "render", "bitmap_glyphs.cheng")
+HEADER_PATH = os.path.join(ROOT, "render", "bitmap_glyphs.h")
+
+# (name, source file, columns, rows, bits per row, mask type)
+FONTS = [
+    ("5x7", "font_5x7.txt", 5, 7, 8, "uint64"),
+    ("3x5", "font_3x5.txt", 3, 5, 4, "uint32"),
+]
+
+
+def load_font(path, cols, rows):
+    glyphs = {}
+    fallback = None
+    with open(path, "r", encoding="utf-8") as handle:
+        for lineno, raw in enumerate(handle, 1):
+            line = raw.strip()
+            if not line or line.startswith("# "):
+                continue
+            parts = line.split()
+            if len(parts) != rows + 1:
+                raise SystemExit("%s:%d: expected %d rows" % (path, lineno, rows))
+            for row in parts[1:]:
+                if len(row) != cols or set(row) - set(".#"):
+                    raise SystemExit("%s:%d: bad row %r" % (path, lineno, row))
+            if parts[0] == "fallback":
+                fallback = parts[1:]
+            else:
+                code = int(parts[0], 16)
+                if code < 0 or code > 127:
+                    raise SystemExit("%s:%d: code point outside ASCII" % (path, lineno))
+                glyphs[code] = parts[1:]
+    if fallback is None:
+        raise SystemExit("%s: missing fallback glyph" % path)
+    for code in range(ord("a"), ord("z") + 1):
+        upper = code - 32
+        if code not in glyphs and upper in glyphs:
+            glyphs[code] = glyphs[upper]
+    return glyphs, fallback
+
+
+def pack(rows, bits_per_row):
+    mask = 0
+    for r, row in enumerate(rows):
+        for c, cell in enumerate(row):
+            if cell == "#":
+                mask |= 1 << (r * bits_per_row + c)
+    return mask
+
+
+def render():
+    out = []
+    out.append("# Generated by scripts/gen_bitmap_glyphs.py from render/glyphs/; do not edit.")
+    out.append("#")
+    out.append("# Each glyph is one mask: row r occupies bits [r * bitsPerRow, (r + 1) * bitsPerRow),")
+    out.append("# column c of that row is bit c. Lowercase letters share their uppercase mask.")
+    out.append("")
+    out.append("const")
+    for name, _, cols, rows, bits, _ in FONTS:
+        out.append("    glyph%sCols = int32(%d)" % (name, cols))
+        out.append("    glyph%sRows = int32(%d)" % (name, rows))
+        out.append("    glyph%sBitsPerRow = int32(%d)" % (name, bits))
+    tables = []
+    for name, source, cols, rows, bits, mask_type in FONTS:
+        glyphs, fallback = load_font(os.path.join(ROOT, "render", "glyphs", source), cols, rows)
+        tables.append((name, mask_type, glyphs, fallback, bits))
+        fmt = "0x%%0%dX" % (16 if mask_type == "uint64" else 8)
+        out.append("    glyph%sFallback = %s(%s)" % (name, mask_type, fmt % pack(fallback, bits)))
+    out.append("")
+    for name, mask_type, _, _, _ in tables:
+        out.append("var glyphTable%s: %s[]" % (name, mask_type))
+    out.append("")
+    for name, mask_type, glyphs, fallback, bits in tables:
+        width = 16 if mask_type == "uint64" else 8
+        fmt = "0x%%0%dX" % width
+        out.append("fn initGlyphTable%s() =" % name)
+        out.append("    setLen(glyphTable%s, 128)" % name)
+        out.append("    for code in 0..<128:")
+        out.append("        glyphTable%s[code] = glyph%sFallback" % (name, name))
+        for code in sorted(glyphs):
+            out.append("    glyphTable%s[%d] = %s(%s)" % (name, code, mask_type, fmt % pack(glyphs[code], bits)))
+        out.append("")
+        out.append("fn glyphMask%s(code: int32): %s =" % (name, mask_type))
+        out.append("    if len(glyphTable%s) == 0:" % name)
+        out.append("        initGlyphTable%s()" % name)
+        out.append("    if code < int32(0) || code >= int32(128):")
+        out.append("        return glyph%sFallback" % name)
+        out.append("    return glyphTable%s[int(code)]" % name)
+        out.append("")
+    out.append("fn glyphRow5x7(mask: uint64, row: int32): uint32 =")
+    out.append("    return uint32((mask >> uint64(row * glyph5x7BitsPerRow)) & uint64(0xFF))")
+    out.append("")
+    out.append("fn glyphRow3x5(mask: uint32, row: int32): uint32 =")
+    out.append("    return (mask >> uint32(row * glyph3x5BitsPerRow)) & uint32(0xF)")
+    return "\n".join(out) + "\n"
+
+
+def render_header():
+    name, source, cols, rows, bits, _ = FONTS[0]
+    glyphs, fallback = load_font(os.path.join(ROOT, "render", "glyphs", source), cols, rows)
+    fallback_mask = pack(fallback, bits)
+    out = []
+    out.append("/* Generated by scripts/gen_bitmap_glyphs.py from render/glyphs/; do not edit.")
+    out.append(" * Same layout as render/bitmap_glyphs.cheng: row r of a glyph is bits")
+    out.append(" * [r * 8, r * 8 + 8) of its mask, column c is bit c. */")
+    out.append("#ifndef CHENG_GUI_BITMAP_GLYPHS_H")
+    out.append("#define CHENG_GUI_BITMAP_GLYPHS_H")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append("enum { ChengGlyph%sCols = %d, ChengGlyph%sRows = %d, ChengGlyph%sBitsPerRow = %d };" % (name, cols, name, rows, name, bits))
+    out.append("")
+    out.append("static const uint64_t chengGlyph%s[128] = {" % name)
+    for code in range(128):
+        mask = pack(glyphs[code], bits) if code in glyphs else fallback_mask
+        out.append("  0x%016XULL,%s" % (mask, "" if code < 32 or code == 127 else " /* %s */" % repr(chr(code))))
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    outputs = [(OUT_PATH, render()), (HEADER_PATH, render_header())]
+    if "--check" in argv:
+        stale = False
+        for path, text in outputs:
+            try:
+                with open(path, "r", encoding="utf-8") as handle:
+                    current = handle.read()
+            except OSError:
+                current = ""
+            if current != text:
+                sys.stderr.write("[gen-bitmap-glyphs] %s is stale; rerun scripts/gen_bitmap_glyphs.py\n" % path)
+                stale = True
+        return 1 if stale else 0
+    for path, text in outputs:
+        with open(path, "w", encoding="utf-8") as handle:
+            handle.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
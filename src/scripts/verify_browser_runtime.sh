@@ -116,6 +116,8 @@ obj_sys="$ROOT/chengcache/browser_core_smoke.system_helpers.runtime.o"
 obj_compat="$ROOT/chengcache/browser_core_smoke.compat_shim.runtime.o"
 obj_stub="$ROOT/chengcache/browser_core_smoke.mobile_stub.runtime.o"
 obj_skia="$ROOT/chengcache/browser_core_smoke.skia_stub.runtime.o"
+obj_kern="$ROOT/chengcache/browser_core_smoke.pixel_kernels.runtime.o"
+obj_snap="$ROOT/chengcache/browser_core_smoke.snapshot_writer.runtime.o"
 obj_plat="$ROOT/chengcache/browser_core_smoke.macos_app.runtime.o"
 obj_text="$ROOT/chengcache/browser_core_smoke.text_macos.runtime.o"
 compat_shim_src="$ROOT/runtime/cheng_compat_shim.c"
@@ -134,9 +136,11 @@ if [ "$reuse_runtime_bin" != "1" ] || [ ! -x "$out" ]; then
   fi
   clang -c "$ROOT/platform/cheng_mobile_host_stub.c" -o "$obj_stub"
   clang -c "$ROOT/render/skia_stub.c" -o "$obj_skia"
+  clang -O2 -c "$ROOT/render/pixel_kernels.c" -o "$obj_kern"
+  clang -O3 -c "$ROOT/render/snapshot_writer.c" -o "$obj_snap"
   clang -fobjc-arc -c "$ROOT/platform/macos_app.m" -o "$obj_plat"
   clang -std=c11 -c "$ROOT/render/text_macos.c" -o "$obj_text"
-  clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" "$obj_text" \
+  clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_text" \
     -framework Cocoa -framework QuartzCore -framework CoreGraphics -framework CoreText -framework CoreFoundation \
     -o "$out"
 fi
@@ -177,6 +177,8 @@ EOF
   local modules=(
     "$SRC_ROOT/ime/cangwu_types.cheng"
     "$SRC_ROOT/ime/cangwu_rules.cheng"
+    "$SRC_ROOT/ime/cangwu_asset_image.cheng"
+    "$SRC_ROOT/ime/cangwu_code_trie.cheng"
     "$SRC_ROOT/ime/cangwu_assets_loader.cheng"
     "$SRC_ROOT/ime/legacy_types.cheng"
     "$SRC_ROOT/ime/legacy_assets_loader.cheng"
@@ -221,6 +223,8 @@ compile_test_sources=(
   "$TEST_ROOT/cangwu_engine_test.cheng"
   "$TEST_ROOT/cangwu_phrase_test.cheng"
   "$TEST_ROOT/cangwu_reverse_test.cheng"
+  "$TEST_ROOT/cangwu_asset_image_test.cheng"
+  "$TEST_ROOT/cangwu_code_trie_test.cheng"
   "$TEST_ROOT/cangwu_panel_smoke_test.cheng"
   "$TEST_ROOT/legacy_codec_test.cheng"
   "$TEST_ROOT/utfzh_transcode_test.cheng"
@@ -278,10 +282,26 @@ check_no_pointer_module() {
   fi
 }
 
+# The query session is updated in place on every keystroke; copying the
+# engine, its session or one of its levels out and back is a deep copy the
+# alloc counters cannot see.
+engine_copy_pattern="(var|let) +[A-Za-z_]+ *= *((state\\.)?engine(\\.session)?|[A-Za-z_.]*levels\\[[^]]*\\]) *$"
+
+check_no_engine_copy() {
+  local file="$1"
+  if rg -n "$engine_copy_pattern" "$file" >/dev/null 2>&1; then
+    echo "[verify-cangwu-ime] engine/session copy on the keystroke path: $file" >&2
+    rg -n "$engine_copy_pattern" "$file" >&2 || true
+    exit 2
+  fi
+}
+
 echo "[verify-cangwu-ime] step2 strict compile gate"
 check_no_pointer_module "$SRC_ROOT/ime/cangwu_engine.cheng"
 check_no_pointer_module "$SRC_ROOT/ime/panel_render.cheng"
 check_no_pointer_module "$SRC_ROOT/ime/panel_runtime.cheng"
+check_no_engine_copy "$SRC_ROOT/ime/cangwu_engine.cheng"
+check_no_engine_copy "$SRC_ROOT/ime/panel_state.cheng"
 
 echo "[verify-cangwu-ime] step2 compile tests"
 compile_obj "$SRC_ROOT/cangwu_ime_main.cheng" "$OBJ_ROOT/cangwu_ime_main.o"
@@ -311,6 +331,7 @@ echo "[verify-cangwu-ime] step3 run tests"
 obj_sys="$OBJ_ROOT/cangwu_ime.system_helpers.runtime.o"
 obj_compat="$OBJ_ROOT/cangwu_ime.compat_shim.runtime.o"
 obj_panel_bridge="$OBJ_ROOT/cangwu_ime.panel_bridge.runtime.o"
+obj_asset_image="$OBJ_ROOT/cangwu_ime.asset_image.runtime.o"
 compat_shim_src="$SRC_ROOT/runtime/cheng_compat_shim.c"
 panel_bridge_src="$SRC_ROOT/runtime/cangwu_panel_bridge.c"
 clang -I"$ROOT/runtime/include" -I"$ROOT/src/runtime/native" \
@@ -327,11 +348,12 @@ if [ -f "$panel_bridge_src" ]; then
 else
   obj_panel_bridge=""
 fi
+clang -std=c11 -D_POSIX_C_SOURCE=200809L -O2 -c "$SRC_ROOT/runtime/cangwu_asset_image.c" -o "$obj_asset_image"
 
 run_test() {
   local obj="$1"
   local bin="$2"
-  clang "$obj" "$obj_sys" ${obj_compat:+"$obj_compat"} ${obj_panel_bridge:+"$obj_panel_bridge"} -o "$bin"
+  clang "$obj" "$obj_sys" ${obj_compat:+"$obj_compat"} ${obj_panel_bridge:+"$obj_panel_bridge"} "$obj_asset_image" -o "$bin"
   echo "[verify-cangwu-ime] run $(basename "$bin")"
   local timeout_s="${CW_IME_TEST_TIMEOUT:-60}"
   set +e
@@ -91,12 +91,39 @@ if [ -z "$target" ]; then
   exit 2
 fi
 
-main_src="$ROOT/chromium_perf_runtime_smoke_main.cheng"
+main_src="$ROOT/chromium_perf_smoke_main.cheng"
 if [ ! -f "$main_src" ]; then
   echo "[verify-chromium-perf] missing source: $main_src" >&2
   exit 1
 fi
 
+fixture_dir="${CHROMIUM_PERF_FIXTURE_DIR:-$ROOT/tests/chromium_perf}"
+fixtures=""
+for f in "$fixture_dir"/*.html; do
+  [ -f "$f" ] || continue
+  fixtures="${fixtures:+$fixtures,}$f"
+done
+if [ -z "$fixtures" ]; then
+  echo "[verify-chromium-perf] no fixtures under $fixture_dir" >&2
+  exit 1
+fi
+
+host="$(uname -s)"
+case "$host" in
+  Darwin)
+    host_tag="macos"
+    default_defines="macos,macosx"
+    ;;
+  Linux)
+    host_tag="linux"
+    default_defines="linux"
+    ;;
+  *)
+    echo "[verify-chromium-perf] runtime execution required on blocking gate host; got host=$host" >&2
+    exit 1
+    ;;
+esac
+
 out_dir="$ROOT/build/chromium_perf"
 mkdir -p "$out_dir"
 obj="$ROOT/chengcache/chromium_perf_smoke.runtime.o"
@@ -106,7 +133,7 @@ if [ "$reuse_obj" != "1" ] || [ ! -s "$obj" ]; then
   rm -f "$obj"
   if ! (
     cd "$ROOT"
-    DEFINES="${DEFINES:-macos,macosx}" sh "$CHENGC" "$main_src" --emit-obj --obj-out:"$obj" --target:"$target"
+    DEFINES="${DEFINES:-$default_defines}" sh "$CHENGC" "$main_src" --emit-obj --obj-out:"$obj" --target:"$target"
   ) >"$compile_log" 2>&1; then
     echo "[verify-chromium-perf] compile failed" >&2
     sed -n '1,120p' "$compile_log" >&2
@@ -120,62 +147,143 @@ if [ ! -s "$obj" ]; then
   exit 1
 fi
 
-host="$(uname -s)"
 runtime_exec="${CHROMIUM_RUNTIME_EXEC:-1}"
+if [ "$runtime_exec" != "1" ]; then
+  echo "[verify-chromium-perf] strict mode requires CHROMIUM_RUNTIME_EXEC=1" >&2
+  exit 1
+fi
 if [ "$host" = "Darwin" ]; then
-  if [ "$runtime_exec" != "1" ]; then
-    echo "[verify-chromium-perf] strict mode requires CHROMIUM_RUNTIME_EXEC=1 on Darwin" >&2
-    exit 1
-  fi
   cc="${CC:-clang}"
-  obj_sys="$ROOT/chengcache/chromium_perf_smoke.system_helpers.runtime.o"
-  obj_compat="$ROOT/chengcache/chromium_perf_smoke.compat_shim.runtime.o"
-  compat_shim_src="$ROOT/runtime/cheng_compat_shim.c"
-  bin="$out_dir/chromium_perf_smoke_macos"
-  run_log="$out_dir/chromium_perf_smoke_macos.run.log"
-  reuse_bin="${CHROMIUM_PERF_REUSE_BIN:-0}"
-
-  if [ "$reuse_bin" != "1" ] || [ ! -x "$bin" ]; then
-    "$cc" -I"$ROOT/runtime/include" -I"$ROOT/src/runtime/native" \
-      -Dalloc=cheng_runtime_alloc -DcopyMem=cheng_runtime_copyMem -DsetMem=cheng_runtime_setMem \
-      -c "$ROOT/src/runtime/native/system_helpers.c" -o "$obj_sys"
-    if [ -f "$compat_shim_src" ]; then
-      "$cc" -c "$compat_shim_src" -o "$obj_compat"
-      "$cc" "$obj" "$obj_sys" "$obj_compat" -o "$bin"
-    else
-      "$cc" "$obj" "$obj_sys" -o "$bin"
-    fi
-  fi
+else
+  cc="${CC:-cc}"
+fi
+obj_sys="$ROOT/chengcache/chromium_perf_smoke.system_helpers.runtime.o"
+obj_compat="$ROOT/chengcache/chromium_perf_smoke.compat_shim.runtime.o"
+compat_shim_src="$ROOT/runtime/cheng_compat_shim.c"
+bin="$out_dir/chromium_perf_smoke_${host_tag}"
+run_log="$out_dir/chromium_perf_smoke_${host_tag}.run.log"
+report_json="$out_dir/chromium_perf_report.json"
+compare_json="$out_dir/chromium_perf_compare.json"
+baseline_json="${CHROMIUM_PERF_BASELINE:-$ROOT/tests/chromium_perf/chromium_perf_baseline.json}"
+reuse_bin="${CHROMIUM_PERF_REUSE_BIN:-0}"
 
-  {
-    echo "runtime_exec=1"
-    echo "host=$host"
-    echo "binary=$bin"
-    echo "start_epoch=$(date +%s)"
-  } >"$run_log"
-  set +e
-  "$bin" >>"$run_log" 2>&1
-  run_rc=$?
-  set -e
-  {
-    echo "run_rc=$run_rc"
-    echo "end_epoch=$(date +%s)"
-  } >>"$run_log"
-  if [ "$run_rc" -ne 0 ]; then
-    echo "[verify-chromium-perf] runtime failed rc=$run_rc" >&2
-    sed -n '1,120p' "$run_log" >&2
-    exit 1
-  fi
-  if [ ! -s "$run_log" ]; then
-    echo "[verify-chromium-perf] runtime log missing: $run_log" >&2
-    exit 1
-  fi
-  if rg -n "runtime skipped|compile-only" "$run_log" >/dev/null 2>&1; then
-    echo "[verify-chromium-perf] invalid runtime marker in log: $run_log" >&2
-    exit 1
+if [ "$reuse_bin" != "1" ] || [ ! -x "$bin" ]; then
+  "$cc" -I"$ROOT/runtime/include" -I"$ROOT/src/runtime/native" \
+    -Dalloc=cheng_runtime_alloc -DcopyMem=cheng_runtime_copyMem -DsetMem=cheng_runtime_setMem \
+    -c "$ROOT/src/runtime/native/system_helpers.c" -o "$obj_sys"
+  if [ -f "$compat_shim_src" ]; then
+    "$cc" -c "$compat_shim_src" -o "$obj_compat"
+    "$cc" "$obj" "$obj_sys" "$obj_compat" -o "$bin"
+  else
+    "$cc" "$obj" "$obj_sys" -o "$bin"
   fi
-  echo "[verify-chromium-perf] ok: $bin"
-else
-  echo "[verify-chromium-perf] runtime execution required on blocking gate host; got host=$host" >&2
+fi
+
+rm -f "$report_json"
+{
+  echo "runtime_exec=1"
+  echo "host=$host"
+  echo "binary=$bin"
+  echo "fixtures=$fixtures"
+  echo "start_epoch=$(date +%s)"
+} >"$run_log"
+set +e
+CHROMIUM_PERF_FIXTURES="$fixtures" CHROMIUM_PERF_REPORT="$report_json" "$bin" >>"$run_log" 2>&1
+run_rc=$?
+set -e
+{
+  echo "run_rc=$run_rc"
+  echo "end_epoch=$(date +%s)"
+} >>"$run_log"
+if [ "$run_rc" -ne 0 ]; then
+  echo "[verify-chromium-perf] runtime failed rc=$run_rc (44-48: absolute budget exceeded)" >&2
+  sed -n '1,120p' "$run_log" >&2
+  exit 1
+fi
+if [ ! -s "$report_json" ]; then
+  echo "[verify-chromium-perf] report missing: $report_json" >&2
+  exit 1
+fi
+if rg -n "runtime skipped|compile-only" "$run_log" >/dev/null 2>&1; then
+  echo "[verify-chromium-perf] invalid runtime marker in log: $run_log" >&2
   exit 1
 fi
+
+if ! command -v python3 >/dev/null 2>&1; then
+  echo "[verify-chromium-perf] missing dependency: python3" >&2
+  exit 2
+fi
+
+# The baseline is committed next to the fixtures; a missing one fails the
+# gate. CHROMIUM_PERF_UPDATE_BASELINE=1 overwrites it with this run's report.
+#
+# Noise-aware baseline comparison: a metric regresses only when its median
+# exceeds the baseline median by the relative tolerance plus k times the
+# larger of the two MADs plus an absolute floor, so run-to-run jitter on a
+# quiet metric does not fail the gate while a real shift does.
+python3 - "$report_json" "$baseline_json" "$compare_json" "${CHROMIUM_PERF_UPDATE_BASELINE:-0}" <<'PY'
+import json
+import os
+import shutil
+import sys
+
+report_path, baseline_path, compare_path, update = sys.argv[1:5]
+rel_tol = float(os.environ.get("CHROMIUM_PERF_REL_TOL", "0.10"))
+mad_k = float(os.environ.get("CHROMIUM_PERF_MAD_K", "3.0"))
+abs_floor_ms = float(os.environ.get("CHROMIUM_PERF_ABS_FLOOR_MS", "0.05"))
+abs_floor_pct = float(os.environ.get("CHROMIUM_PERF_ABS_FLOOR_PCT", "0.5"))
+
+report = json.load(open(report_path, "r", encoding="utf-8"))
+if report.get("schema") != "chromium-perf/v1":
+    raise SystemExit("[verify-chromium-perf] unexpected report schema")
+if not report.get("budgets_ok", False):
+    raise SystemExit("[verify-chromium-perf] report marks budgets as failed")
+
+if update == "1":
+    shutil.copyfile(report_path, baseline_path)
+    print(f"[verify-chromium-perf] baseline recorded: {baseline_path}")
+    raise SystemExit(0)
+if not os.path.exists(baseline_path):
+    raise SystemExit(f"[verify-chromium-perf] missing baseline: {baseline_path} (record one with CHROMIUM_PERF_UPDATE_BASELINE=1)")
+
+baseline = json.load(open(baseline_path, "r", encoding="utf-8"))
+if baseline.get("schema") != "chromium-perf/v1":
+    raise SystemExit(f"[verify-chromium-perf] unexpected baseline schema: {baseline_path}")
+rows = []
+regressions = []
+for key, cur in sorted(report["metrics"].items()):
+    base = baseline.get("metrics", {}).get(key)
+    if base is None:
+        rows.append({"metric": key, "status": "new", "current": cur["median"]})
+        continue
+    floor = abs_floor_pct if key.endswith("_percent") else abs_floor_ms
+    limit = base["median"] * (1.0 + rel_tol) + mad_k * max(base["mad"], cur["mad"]) + floor
+    status = "regressed" if cur["median"] > limit else "ok"
+    rows.append({
+        "metric": key,
+        "status": status,
+        "baseline": base["median"],
+        "current": cur["median"],
+        "limit": limit,
+    })
+    if status == "regressed":
+        regressions.append(key)
+
+with open(compare_path, "w", encoding="utf-8") as fh:
+    json.dump({
+        "baseline": baseline_path,
+        "rel_tol": rel_tol,
+        "mad_k": mad_k,
+        "regressions": regressions,
+        "metrics": rows,
+    }, fh, indent=2)
+    fh.write("\n")
+
+for row in rows:
+    if "limit" in row:
+        print(f"[verify-chromium-perf] {row['metric']}: {row['current']:.4f} (baseline {row['baseline']:.4f}, limit {row['limit']:.4f}) {row['status']}")
+if regressions:
+    raise SystemExit("[verify-chromium-perf] regressions: " + ", ".join(regressions))
+PY
+
+echo "[verify-chromium-perf] ok: $bin report=$report_json"
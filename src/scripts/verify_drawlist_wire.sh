@@ -0,0 +1,162 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT="$(CDPATH= cd -- "$(dirname -- "$0")/.." && pwd)"
+export GUI_ROOT="$ROOT"
+unset BACKEND_WHOLE_PROGRAM
+ROOT="${ROOT:-}"
+if [ -z "$ROOT" ]; then
+  if [ -d "$HOME/.cheng/toolchain/cheng-lang" ]; then
+    ROOT="$HOME/.cheng/toolchain/cheng-lang"
+  elif [ -d "$HOME/cheng-lang" ]; then
+    ROOT="$HOME/cheng-lang"
+  elif [ -d "/Users/lbcheng/cheng-lang" ]; then
+    ROOT="/Users/lbcheng/cheng-lang"
+  fi
+fi
+if [ -z "$ROOT" ]; then
+  echo "[verify-drawlist-wire] missing ROOT" >&2
+  exit 2
+fi
+
+CHENGC="${CHENGC:-$ROOT/src/tooling/chengc.sh}"
+if [ ! -x "$CHENGC" ]; then
+  echo "[verify-drawlist-wire] missing chengc: $CHENGC" >&2
+  exit 2
+fi
+
+pkg_roots="${PKG_ROOTS:-}"
+default_pkg_root="$HOME/.cheng-packages"
+if [ -d "$default_pkg_root" ]; then
+  if [ -z "$pkg_roots" ]; then
+    pkg_roots="$default_pkg_root"
+  else
+    case ",$pkg_roots," in
+      *,"$default_pkg_root",*) ;;
+      *) pkg_roots="$pkg_roots,$default_pkg_root" ;;
+    esac
+  fi
+fi
+if [ -z "$pkg_roots" ]; then
+  pkg_roots="$ROOT"
+else
+  case ",$pkg_roots," in
+    *,"$ROOT",*) ;;
+    *) pkg_roots="$pkg_roots,$ROOT" ;;
+  esac
+fi
+export PKG_ROOTS="$pkg_roots"
+
+if [ -z "${BACKEND_DRIVER:-}" ]; then
+  selected_driver=""
+  if [ -x "$ROOT/cheng_stable" ]; then
+    selected_driver="$ROOT/cheng_stable"
+  elif [ -x "$ROOT/cheng" ]; then
+    selected_driver="$ROOT/cheng"
+  fi
+  if [ -z "$selected_driver" ] && [ -d "$ROOT/dist/releases" ]; then
+    while IFS= read -r candidate; do
+      if [ -x "$candidate/cheng" ]; then
+        selected_driver="$candidate/cheng"
+        break
+      fi
+    done < <(ls -1dt "$ROOT"/dist/releases/* 2>/dev/null || true)
+  fi
+  for cand in "$ROOT"/driver_*; do
+    if [ -n "$selected_driver" ]; then
+      break
+    fi
+    if [ -f "$cand" ] && [ -x "$cand" ]; then
+      selected_driver="$cand"
+      break
+    fi
+  done
+  if [ -z "$selected_driver" ] && [ -x "$ROOT/artifacts/backend_selfhost_self_obj/cheng.stage2" ]; then
+    selected_driver="$ROOT/artifacts/backend_selfhost_self_obj/cheng.stage2"
+  fi
+  if [ -z "$selected_driver" ]; then
+    echo "[verify-drawlist-wire] missing backend driver under ROOT=$ROOT" >&2
+    exit 2
+  fi
+  export BACKEND_DRIVER="$selected_driver"
+fi
+
+export BACKEND_DRIVER_DIRECT="${BACKEND_DRIVER_DIRECT:-0}"
+target="${KIT_TARGET:-}"
+if [ -z "$target" ]; then
+  target="$(sh "$ROOT/src/tooling/detect_host_target.sh")"
+fi
+if [ -z "$target" ]; then
+  echo "[verify-drawlist-wire] failed to detect host target" >&2
+  exit 2
+fi
+
+main_src="$ROOT/drawlist_wire_smoke_main.cheng"
+if [ ! -f "$main_src" ]; then
+  echo "[verify-drawlist-wire] missing source: $main_src" >&2
+  exit 1
+fi
+golden="${DRAWLIST_WIRE_GOLDEN:-$ROOT/tests/drawlist_wire/golden.txt}"
+
+host="$(uname -s)"
+case "$host" in
+  Darwin)
+    host_tag="macos"
+    default_defines="macos,macosx"
+    cc="${CC:-clang}"
+    ;;
+  Linux)
+    host_tag="linux"
+    default_defines="linux"
+    cc="${CC:-cc}"
+    ;;
+  *)
+    echo "[verify-drawlist-wire] unsupported host=$host" >&2
+    exit 1
+    ;;
+esac
+
+out_dir="$ROOT/build/drawlist_wire"
+mkdir -p "$out_dir"
+obj="$ROOT/chengcache/drawlist_wire_smoke.runtime.o"
+compile_log="$out_dir/drawlist_wire_smoke.compile.log"
+rm -f "$obj"
+if ! (
+  cd "$ROOT"
+  DEFINES="${DEFINES:-$default_defines}" sh "$CHENGC" "$main_src" --emit-obj --obj-out:"$obj" --target:"$target"
+) >"$compile_log" 2>&1 || [ ! -s "$obj" ]; then
+  echo "[verify-drawlist-wire] compile failed" >&2
+  sed -n '1,120p' "$compile_log" >&2
+  exit 1
+fi
+
+obj_sys="$ROOT/chengcache/drawlist_wire_smoke.system_helpers.runtime.o"
+obj_compat="$ROOT/chengcache/drawlist_wire_smoke.compat_shim.runtime.o"
+compat_shim_src="$ROOT/runtime/cheng_compat_shim.c"
+bin="$out_dir/drawlist_wire_smoke_${host_tag}"
+run_log="$out_dir/drawlist_wire_smoke_${host_tag}.run.log"
+"$cc" -I"$ROOT/runtime/include" -I"$ROOT/src/runtime/native" \
+  -Dalloc=cheng_runtime_alloc -DcopyMem=cheng_runtime_copyMem -DsetMem=cheng_runtime_setMem \
+  -c "$ROOT/src/runtime/native/system_helpers.c" -o "$obj_sys"
+if [ -f "$compat_shim_src" ]; then
+  "$cc" -c "$compat_shim_src" -o "$obj_compat"
+  "$cc" "$obj" "$obj_sys" "$obj_compat" -o "$bin"
+else
+  "$cc" "$obj" "$obj_sys" -o "$bin"
+fi
+
+set +e
+DRAWLIST_WIRE_GOLDEN="$golden" "$bin" >"$run_log" 2>&1
+run_rc=$?
+set -e
+if [ "$run_rc" -ne 0 ]; then
+  echo "[verify-drawlist-wire] runtime failed rc=$run_rc (44: encode over budget, 45: decode over budget)" >&2
+  sed -n '1,60p' "$run_log" >&2
+  exit 1
+fi
+if ! grep -q "\[drawlist-wire\] golden corpus ok" "$run_log"; then
+  echo "[verify-drawlist-wire] golden check did not run: $run_log" >&2
+  exit 1
+fi
+grep "\[drawlist-wire\]" "$run_log"
+echo "[verify-drawlist-wire] ok"
@@ -247,6 +247,8 @@ obj_sys="$OBJ_ROOT/examples_games.system_helpers.runtime.o"
 obj_compat="$OBJ_ROOT/examples_games.compat_shim.runtime.o"
 obj_stub="$OBJ_ROOT/examples_games.mobile_stub.runtime.o"
 obj_skia="$OBJ_ROOT/examples_games.skia_stub.runtime.o"
+obj_kern="$OBJ_ROOT/examples_games.pixel_kernels.runtime.o"
+obj_snap="$OBJ_ROOT/examples_games.snapshot_writer.runtime.o"
 obj_plat="$OBJ_ROOT/examples_games.macos_app.runtime.o"
 obj_text="$OBJ_ROOT/examples_games.text_macos.runtime.o"
 obj_link_shim="$OBJ_ROOT/examples_games.link_shim.runtime.o"
@@ -263,6 +265,8 @@ else
 fi
 clang -c "$SRC_ROOT/platform/cheng_mobile_host_stub.c" -o "$obj_stub"
 clang -c "$SRC_ROOT/render/skia_stub.c" -o "$obj_skia"
+clang -O2 -c "$SRC_ROOT/render/pixel_kernels.c" -o "$obj_kern"
+clang -O3 -c "$SRC_ROOT/render/snapshot_writer.c" -o "$obj_snap"
 clang -fobjc-arc -c "$SRC_ROOT/platform/macos_app.m" -o "$obj_plat"
 clang -std=c11 -c "$SRC_ROOT/render/text_macos.c" -o "$obj_text"
 clang -std=c11 -c "$SRC_ROOT/runtime/examples_games_link_shim.c" -o "$obj_link_shim"
@@ -270,7 +274,7 @@ clang -std=c11 -c "$SRC_ROOT/runtime/examples_games_link_shim.c" -o "$obj_link_s
 link_desktop() {
   local main_obj="$1"
   local output_bin="$2"
-  clang "$main_obj" "$obj_sys" "$obj_link_shim" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" "$obj_text" \
+  clang "$main_obj" "$obj_sys" "$obj_link_shim" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_text" \
     -framework Cocoa -framework QuartzCore -framework CoreGraphics -framework CoreText -framework CoreFoundation \
     -o "$output_bin"
 }
@@ -112,6 +112,8 @@ obj_sys="$ROOT/chengcache/gui_kit_smoke.system_helpers.runtime.o"
 obj_compat="$ROOT/chengcache/gui_kit_smoke.compat_shim.runtime.o"
 obj_stub="$ROOT/chengcache/gui_kit_smoke.mobile_stub.runtime.o"
 obj_skia="$ROOT/chengcache/gui_kit_smoke.skia_stub.runtime.o"
+obj_kern="$ROOT/chengcache/gui_kit_smoke.pixel_kernels.runtime.o"
+obj_snap="$ROOT/chengcache/gui_kit_smoke.snapshot_writer.runtime.o"
 obj_plat="$ROOT/chengcache/gui_kit_smoke.macos_app.runtime.o"
 obj_text="$ROOT/chengcache/gui_kit_smoke.text_macos.runtime.o"
 compat_shim_src="$ROOT/runtime/cheng_compat_shim.c"
@@ -129,9 +131,11 @@ else
 fi
 clang -c "$ROOT/platform/cheng_mobile_host_stub.c" -o "$obj_stub"
 clang -c "$ROOT/render/skia_stub.c" -o "$obj_skia"
+clang -O2 -c "$ROOT/render/pixel_kernels.c" -o "$obj_kern"
+clang -O3 -c "$ROOT/render/snapshot_writer.c" -o "$obj_snap"
 clang -fobjc-arc -c "$ROOT/platform/macos_app.m" -o "$obj_plat"
 clang -std=c11 -c "$ROOT/render/text_macos.c" -o "$obj_text"
-clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" "$obj_text" \
+clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_text" \
   -framework Cocoa -framework QuartzCore -framework CoreGraphics -framework CoreText -framework CoreFoundation \
   -o "$out"
 
@@ -145,4 +149,11 @@ if [ "$run_rc" -ne 0 ]; then
   exit 1
 fi
 
+if ! grep -q "^\[gui-kit\] frame=.* draw=[1-9][0-9]*->[0-9]* " "$run_log"; then
+  echo "[verify-gui-kit-runtime] missing draw-list frame stats (log: $run_log)" >&2
+  sed -n '1,120p' "$run_log" >&2
+  exit 1
+fi
+grep "^\[gui-kit\]" "$run_log"
+
 echo "[verify-gui-kit-runtime] ok: $out"
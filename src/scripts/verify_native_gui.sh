@@ -7,11 +7,26 @@ Usage:
   scripts/verify_native_gui.sh [--desktop-out:<path>] [--android-out:<path>] [--ios-out:<path>]
                                [--name:<prog>]
                                [--desktop-target:<triple>] [--android-target:<triple>] [--ios-target:<triple>]
-                               [--jobs:<N>] [--mm:<orc|off>] [--orc|--off]
+                               [--jobs:<N>] [--mm:<orc|off>] [--orc|--off] [--xvfb] [--headless]
 
 Notes:
   - Builds native desktop GUI (gui_smoke_main.cheng) via backend obj pipeline + native platform linking.
   - Verifies mobile backend obj outputs (gui_smoke_mobile.cheng) for Android/iOS targets.
+  - --xvfb (Linux): runs the desktop smoke under xvfb-run and checks both the MIT-SHM
+    and the XPutImage present paths.
+  - --headless (Linux): also links the desktop smoke against platform/headless_app.c and
+    runs a scripted, display-free frame loop, checking the timing summary. It then runs
+    render_backend_smoke_main.cheng on the same host: the skia stub and the CPU raster
+    must produce identical canvases, with and without text.
+  - Cross-checks the SIMD pixel kernels (render/pixel_kernels.c) against the scalar
+    path and the tiled raster against a serial replay, then prints MPix/s per kernel and
+    the tiled frame speedup; GUI_KERNELS=scalar|sse2|avx2 caps the level at runtime.
+  - Runs the skia stub self-test (render/skia_stub.c): rects, blending, text, the copy
+    into a bound target, replay and the pixel hash.
+  - With python3 available, checks that render/bitmap_glyphs.{cheng,h} match the fonts in
+    render/glyphs/ (scripts/gen_bitmap_glyphs.py --check), and round-trips a frame through
+    the snapshot PNG encoder (render/snapshot_writer.c), decoding it with zlib to compare
+    the pixels.
 EOF
 }
 
@@ -24,6 +39,8 @@ android_target=""
 ios_target=""
 jobs=""
 mm=""
+xvfb="0"
+headless="0"
 
 while [ "${1:-}" != "" ]; do
   case "$1" in
@@ -64,6 +81,12 @@ while [ "${1:-}" != "" ]; do
     --mm:*)
       mm="${1#--mm:}"
       ;;
+    --xvfb)
+      xvfb="1"
+      ;;
+    --headless)
+      headless="1"
+      ;;
     --compiler:*)
       echo "[Error] --compiler is removed; backend driver is now the only pipeline" 1>&2
       exit 2
@@ -316,6 +339,8 @@ obj_sys="$ROOT/chengcache/${prog}.system_helpers.o"
 obj_compat="$ROOT/chengcache/${prog}.compat_shim.o"
 obj_stub="$ROOT/chengcache/${prog}.mobile_stub.o"
 obj_skia="$ROOT/chengcache/${prog}.skia_stub.o"
+obj_kern="$ROOT/chengcache/${prog}.pixel_kernels.o"
+obj_snap="$ROOT/chengcache/${prog}.snapshot_writer.o"
 compat_shim_src="$GUI_ROOT/runtime/cheng_compat_shim.c"
 cflags=""
 case "$platform" in
@@ -335,9 +360,101 @@ else
   obj_compat=""
 fi
 
+if command -v python3 >/dev/null 2>&1; then
+  echo "== GUI desktop: bitmap glyph tables =="
+  if ! python3 "$GUI_ROOT/scripts/gen_bitmap_glyphs.py" --check; then
+    echo "[Error] render/bitmap_glyphs.{cheng,h} are stale; rerun scripts/gen_bitmap_glyphs.py" 1>&2
+    exit 1
+  fi
+fi
+
 echo "== GUI desktop: compile platform stubs =="
 "$cc" -c "$GUI_ROOT/platform/cheng_mobile_host_stub.c" -o "$obj_stub"
 "$cc" -c "$GUI_ROOT/render/skia_stub.c" -o "$obj_skia"
+"$cc" -O2 -c "$GUI_ROOT/render/pixel_kernels.c" -o "$obj_kern"
+"$cc" -O3 -c "$GUI_ROOT/render/snapshot_writer.c" -o "$obj_snap"
+
+echo "== GUI desktop: pixel kernels cross-check =="
+kern_bench="$ROOT/chengcache/${prog}.pixel_kernels_bench"
+"$cc" -O2 -DCHENG_GUI_KERNELS_BENCH "$GUI_ROOT/render/pixel_kernels.c" -lm -lpthread -o "$kern_bench"
+if ! GUI_KERNELS_BENCH_MS="${GUI_KERNELS_BENCH_MS:-50}" "$kern_bench"; then
+  echo "[Error] pixel kernels disagree with the scalar reference" 1>&2
+  exit 1
+fi
+
+echo "== GUI desktop: skia stub self-test =="
+skia_test="$ROOT/chengcache/${prog}.skia_stub_test"
+"$cc" -O2 -DCHENG_GUI_SKIA_STUB_TEST "$GUI_ROOT/render/skia_stub.c" "$GUI_ROOT/render/pixel_kernels.c" -lm -lpthread -o "$skia_test"
+if ! "$skia_test"; then
+  echo "[Error] skia stub self-test failed" 1>&2
+  exit 1
+fi
+
+if command -v python3 >/dev/null 2>&1; then
+  echo "== GUI desktop: snapshot encoder round trip =="
+  snap_tool="$ROOT/chengcache/${prog}.snapshot_writer"
+  snap_in="$ROOT/chengcache/${prog}.snapshot_check.rgba.out"
+  snap_png="$ROOT/chengcache/${prog}.snapshot_check.png"
+  "$cc" -O3 -DCHENG_GUI_SNAPSHOT_MAIN "$GUI_ROOT/render/snapshot_writer.c" -lpthread -o "$snap_tool"
+  # Flat bands with noisy, translucent rows in between, so every filter, long
+  # matches and literals all get exercised.
+  python3 - "$snap_in" <<'PY'
+import random, sys
+rng = random.Random(7)
+out = bytearray()
+for y in range(96):
+    for x in range(160):
+        if y % 11 < 3:
+            out += bytes([rng.randrange(256), rng.randrange(256), rng.randrange(256), 255 - x % 5])
+        else:
+            out += bytes([30 + (x >> 4) * 9, 34 + y, 40, 255])
+open(sys.argv[1], "wb").write(out)
+PY
+  "$snap_tool" --in "$snap_in" --out "$snap_png" --width 160 --height 96 --bench
+  if ! python3 - "$snap_in" "$snap_png" <<'PY'
+import struct, sys, zlib
+raw = open(sys.argv[1], "rb").read()
+data = open(sys.argv[2], "rb").read()
+pos, idat, ihdr = 8, b"", None
+while pos < len(data):
+    size, tag = struct.unpack(">I4s", data[pos:pos + 8])
+    body = data[pos + 8:pos + 8 + size]
+    if zlib.crc32(tag + body) & 0xFFFFFFFF != struct.unpack(">I", data[pos + 8 + size:pos + 12 + size])[0]:
+        sys.exit("bad crc in " + tag.decode())
+    if tag == b"IHDR":
+        ihdr = struct.unpack(">IIBBBBB", body)
+    elif tag == b"IDAT":
+        idat += body
+    pos += 12 + size
+width, height, bpp = ihdr[0], ihdr[1], 3 if ihdr[3] == 2 else 4
+rows, stride, prev, out = zlib.decompress(idat), width * bpp, bytearray(width * bpp), bytearray()
+for y in range(height):
+    kind, row = rows[y * (stride + 1)], bytearray(rows[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+    for i in range(stride):
+        a = row[i - bpp] if i >= bpp else 0
+        b = prev[i]
+        c = prev[i - bpp] if i >= bpp else 0
+        if kind == 1:
+            row[i] = (row[i] + a) & 255
+        elif kind == 2:
+            row[i] = (row[i] + b) & 255
+        elif kind == 3:
+            row[i] = (row[i] + (a + b) // 2) & 255
+        elif kind == 4:
+            p = a + b - c
+            pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+            row[i] = (row[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 255
+    out += row
+    prev = row
+expect = raw if bpp == 4 else b"".join(raw[i:i + 3] for i in range(0, len(raw), 4))
+sys.exit(0 if bytes(out) == expect else "pixels differ")
+PY
+  then
+    echo "[Error] snapshot PNG does not decode to the source frame" 1>&2
+    exit 1
+  fi
+  echo "ok: snapshot encoder"
+fi
 
 echo "== GUI desktop: link native platform =="
 case "$platform" in
@@ -350,19 +467,23 @@ case "$platform" in
     obj_text="$ROOT/chengcache/${prog}.text_macos.o"
     clang -fobjc-arc -c "$GUI_ROOT/platform/macos_app.m" -o "$obj_plat"
     clang -std=c11 -c "$GUI_ROOT/render/text_macos.c" -o "$obj_text"
-    clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" "$obj_text" \
+    clang "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_text" \
       -framework Cocoa -framework QuartzCore -framework CoreGraphics -framework CoreText -framework CoreFoundation \
       -o "$desktop_out"
     ;;
   linux)
     obj_plat="$ROOT/chengcache/${prog}.x11_app.o"
+    obj_host="$ROOT/chengcache/${prog}.linux_host_native.o"
+    obj_text="$ROOT/chengcache/${prog}.text_linux.o"
     "$cc" -c "$GUI_ROOT/platform/x11_app.c" -o "$obj_plat"
-    "$cc" "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" -lX11 -lXext -o "$desktop_out"
+    "$cc" -O2 -c "$GUI_ROOT/platform/linux_host_native.c" -o "$obj_host"
+    "$cc" -O2 -c "$GUI_ROOT/render/text_linux.c" -o "$obj_text"
+    "$cc" "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" "$obj_host" "$obj_text" -lX11 -lXext -lm -lpthread -o "$desktop_out"
     ;;
   windows)
     obj_plat="$ROOT/chengcache/${prog}.win32_app.o"
     "$cc" -c "$GUI_ROOT/platform/win32_app.c" -o "$obj_plat"
-    "$cc" "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_plat" -luser32 -lgdi32 -limm32 -o "$desktop_out"
+    "$cc" "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$obj_plat" -luser32 -lgdi32 -limm32 -o "$desktop_out"
     ;;
   *)
     echo "[Error] unsupported platform: $uname_s" 1>&2
@@ -372,6 +493,94 @@ esac
 
 echo "ok: desktop binary -> $desktop_out"
 
+run_xvfb_present() {
+  shm="$1"
+  expect="$2"
+  log="$desktop_out.present_shm$shm.log"
+  if ! GUI_DEBUG=1 GUI_X11_SHM="$shm" xvfb-run -a -s "-screen 0 1280x800x24" "$desktop_out" >"$log" 2>&1; then
+    echo "[Error] xvfb smoke failed (GUI_X11_SHM=$shm): $log" 1>&2
+    sed -n '1,40p' "$log" 1>&2
+    exit 1
+  fi
+  if ! grep -q "\[gui-x11\] present mode=$expect " "$log"; then
+    echo "[Error] expected present mode=$expect (GUI_X11_SHM=$shm): $log" 1>&2
+    sed -n '1,40p' "$log" 1>&2
+    exit 1
+  fi
+  if ! grep -q "\[gui-x11\] present .* roundTrips=0 " "$log"; then
+    echo "[Error] steady-state frame issued synchronous X round-trips (GUI_X11_SHM=$shm): $log" 1>&2
+    grep "\[gui-x11\] present" "$log" 1>&2
+    exit 1
+  fi
+  grep "\[gui-x11\] present" "$log"
+}
+
+if [ "$xvfb" = "1" ] && [ "$platform" = "linux" ]; then
+  if ! command -v xvfb-run >/dev/null 2>&1; then
+    echo "[Error] --xvfb requires xvfb-run" 1>&2
+    exit 2
+  fi
+  echo "== GUI desktop: Xvfb present paths =="
+  run_xvfb_present 1 mit-shm
+  run_xvfb_present 0 xputimage
+  echo "ok: xvfb present paths"
+fi
+
+if [ "$headless" = "1" ] && [ "$platform" = "linux" ]; then
+  echo "== GUI desktop: headless frame loop =="
+  headless_out="$desktop_out.headless"
+  headless_plat="$ROOT/chengcache/${prog}.headless_app.o"
+  "$cc" -O2 -c "$GUI_ROOT/platform/headless_app.c" -o "$headless_plat"
+  "$cc" "$obj_main" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$headless_plat" "$obj_host" "$obj_text" -lm -lpthread -o "$headless_out"
+  headless_script="$desktop_out.headless_events.txt"
+  cat >"$headless_script" <<'EOF'
+2 move 200 120
+4 down 200 120 1
+5 up 200 120 1
+8 scroll 0 -3
+10 resize 1024 700
+12 key 0xff54
+EOF
+  headless_log="$desktop_out.headless.log"
+  headless_frames="$desktop_out.headless_frames"
+  rm -rf "$headless_frames"
+  mkdir -p "$headless_frames"
+  if ! GUI_HEADLESS_EVENTS="$headless_script" GUI_HEADLESS_FRAMES=60 \
+      GUI_HEADLESS_TIMINGS="$desktop_out.headless_timings.csv" \
+      GUI_HEADLESS_DUMP_DIR="$headless_frames" GUI_HEADLESS_DUMP_FORMAT=png "$headless_out" >"$headless_log" 2>&1; then
+    echo "[Error] headless smoke failed: $headless_log" 1>&2
+    sed -n '1,40p' "$headless_log" 1>&2
+    exit 1
+  fi
+  if ! grep -q "\[gui-headless\] frames=[1-9][0-9]* events=7 " "$headless_log"; then
+    echo "[Error] headless run did not render frames or replay the script: $headless_log" 1>&2
+    sed -n '1,40p' "$headless_log" 1>&2
+    exit 1
+  fi
+  if ! grep -q "\[gui-headless\] dumps submitted=[1-9][0-9]* written=[1-9][0-9]* .* failed=0 " "$headless_log"; then
+    echo "[Error] headless frame dumps were not written: $headless_log" 1>&2
+    sed -n '1,40p' "$headless_log" 1>&2
+    exit 1
+  fi
+  grep "\[gui-headless\]" "$headless_log"
+  echo "ok: headless frame loop -> $desktop_out.headless_timings.csv"
+fi
+
+if [ "$headless" = "1" ] && [ "$platform" = "linux" ]; then
+  echo "== GUI render backend: skia stub vs CPU raster =="
+  backend_obj="$ROOT/chengcache/${prog}.render_backend.o"
+  backend_out="$desktop_out.render_backend"
+  compile_to_obj "$GUI_ROOT/render_backend_smoke_main.cheng" "$backend_obj" "$desktop_target" "$desktop_defines"
+  "$cc" "$backend_obj" "$obj_sys" ${obj_compat:+"$obj_compat"} "$obj_stub" "$obj_skia" "$obj_kern" "$obj_snap" "$headless_plat" "$obj_host" "$obj_text" -lm -lpthread -o "$backend_out"
+  backend_log="$desktop_out.render_backend.log"
+  if ! "$backend_out" >"$backend_log" 2>&1 || ! grep -q "\[render-backend\] ok" "$backend_log"; then
+    echo "[Error] render backend smoke failed: $backend_log" 1>&2
+    sed -n '1,40p' "$backend_log" 1>&2
+    exit 1
+  fi
+  echo "ok: render backend"
+fi
+
 android_obj="$android_out/${prog}_android.o"
 ios_obj="$ios_out/${prog}_ios.o"
 